@@ -24,42 +24,174 @@
  * DEALINGS IN THE SOFTWARE.
  */
 
+#include <new>
 #include "D6T_44L_06.h"
+#include "D6T_Crc8.h"
 
-#define D6T_ADDR (0x0A << 1)  // for I2C 7bit address
-#define D6T_CMD 0x4C  // for D6T_44L_06-44L-06/06H, D6T_44L_06-8L-09/09H, for D6T_44L_06-1A-01/02
+static constexpr D6T_Crc8Table crc8_table{};
 
-#define N_ROW 4
-#define N_PIXEL (4 * 4)
+// D6T implementation (the model dependent sizes are given by D6T<Traits>)
+#if DEVICE_I2C
+D6T_Base::D6T_Base(PinName sda, PinName scl, int hz, uint8_t cmd, int pixel, const uint8_t* p_init, uint8_t* p_rx_buf)
+{
+    mI2c_ = new (mI2cBuf) ThermoMbedI2c(sda, scl);
+    init(D6T_ADDR, cmd, pixel, p_init, p_rx_buf);
+    if (hz > D6T_I2C_FREQUENCY_MAX) {
+        hz = D6T_I2C_FREQUENCY_MAX;
+    }
+    mI2c_->frequency(hz);
+}
+#endif
+
+D6T_Base::D6T_Base(ThermoHalI2c& i2c, int addr, uint8_t cmd, int pixel, const uint8_t* p_init, uint8_t* p_rx_buf) :
+     mI2c_(&i2c)
+{
+    init(addr, cmd, pixel, p_init, p_rx_buf);
+}
 
-#define N_READ ((N_PIXEL + 1) * 2 + 1)
+D6T_Base::~D6T_Base()
+{
+    if (mI2c_ == (ThermoHalI2c *)mI2cBuf) {
+        mI2c_->~ThermoHalI2c();
+    }
+}
 
-// D6T_44L_06 implementation
-D6T_44L_06::D6T_44L_06(PinName sda, PinName scl) :
-     mI2c_(sda, scl)
+void D6T_Base::init(int addr, uint8_t cmd, int pixel, const uint8_t* p_init, uint8_t* p_rx_buf)
 {
-    mAddr = D6T_ADDR;
-    mI2c_.frequency(100000);
+    mAddr = addr;
+    mCmd = cmd;
+    mPixel = pixel;
+    mReadLen = D6T_FRAME_LENGTH(pixel);
+    mRxBuf = p_rx_buf;
+    mInit = p_init;
+    mPecSeed = pec_seed(mAddr);
+    mState = STATE_IDLE;
+    mAsyncPtat = NULL;
+    mAsyncBuf = NULL;
+    mReads = 0;
+    mI2cErrors = 0;
+    mPecErrors = 0;
 }
 
-bool D6T_44L_06::setup(void)
+bool D6T_Base::setup(void)
 {
+    uint8_t buf[D6T_INIT_WRITE_MAX + 1];
+    const uint8_t* p_write;
+    uint8_t crc;
+    int len;
+    int i;
+    int ret;
+
+    // register writes of the model, each closed by its PEC over the write address and the bytes
+    for (p_write = mInit; (p_write != NULL) && (p_write[0] != 0); p_write += len + 1) {
+        len = p_write[0];
+        crc = calc_crc(mAddr);
+        for (i = 0; i < len; i++) {
+            buf[i] = p_write[1 + i];
+            crc = calc_crc(buf[i] ^ crc);
+        }
+        buf[len] = crc;
+
+        mI2c_->lock();
+        ret = mI2c_->write(mAddr, buf, len + 1);
+        mI2c_->unlock();
+        if (ret != 0) {
+            mI2cErrors++;
+            return false;
+        }
+    }
     return true;
 }
 
-bool D6T_44L_06::read(int16_t* ptat, int16_t* buf)
+bool D6T_Base::read(int16_t* ptat, int16_t* buf)
 {
+    uint8_t state = STATE_IDLE;
     int ret;
-    uint8_t wk_buf[N_READ];
-    int i;
-    int j;
+    bool result;
 
-    ret = read_reg(D6T_CMD, wk_buf, N_READ);
+    // the reading buffer is shared with read_async
+    if (!core_util_atomic_cas_u8(&mState, &state, STATE_READ)) {
+        return false;
+    }
+    ret = read_reg(mCmd, mRxBuf, mReadLen);
     if (ret != 0) {
+        mI2cErrors++;
+        core_util_atomic_store_u8(&mState, STATE_IDLE);
+        return false;
+    }
+
+    result = decode(mRxBuf, ptat, buf);
+    core_util_atomic_store_u8(&mState, STATE_IDLE);
+    return result;
+}
+
+bool D6T_Base::read_async(int16_t* ptat, int16_t* buf, Callback<void(bool)> callback)
+{
+    uint8_t state = STATE_IDLE;
+
+    if (!core_util_atomic_cas_u8(&mState, &state, STATE_ASYNC)) {
+        return false;
+    }
+    mAsyncPtat = ptat;
+    mAsyncBuf = buf;
+    mAsyncCallback = callback;
+
+    if (mI2c_->transfer(mAddr, &mCmd, 1, mRxBuf, mReadLen, Callback<void(int)>(this, &D6T_Base::transfer_done)) != 0) {
+        mI2cErrors++;
+        core_util_atomic_store_u8(&mState, STATE_IDLE);
         return false;
     }
+    return true;
+}
+
+void D6T_Base::abort_async(void)
+{
+    uint8_t state = STATE_ASYNC;
+
+    if (core_util_atomic_cas_u8(&mState, &state, STATE_ABORT)) {
+        // transfer_done leaves the buffers alone from now on,
+        // and the bus does not call it after abort_transfer
+        mI2c_->abort_transfer();
+        core_util_atomic_store_u8(&mState, STATE_IDLE);
+        return;
+    }
+
+    // the completion path already owns the buffers, let it finish
+    while (core_util_atomic_load_u8(&mState) == STATE_DONE) {
+        ThisThread::yield();
+    }
+}
+
+void D6T_Base::transfer_done(int result)
+{
+    Callback<void(bool)> callback = mAsyncCallback;
+    uint8_t state = STATE_ASYNC;
+    bool decoded = false;
+
+    // lost against abort_async: the caller's buffers are no longer ours
+    if (!core_util_atomic_cas_u8(&mState, &state, STATE_DONE)) {
+        return;
+    }
 
-    if (D6T_checkPEC(wk_buf, N_READ - 1)) {
+    // PEC check and decoding run here, the requesting thread only gets the result
+    if (result == THERMO_HAL_I2C_OK) {
+        decoded = decode(mRxBuf, mAsyncPtat, mAsyncBuf);
+    } else {
+        mI2cErrors++;
+    }
+    core_util_atomic_store_u8(&mState, STATE_IDLE);
+    if (callback) {
+        callback(decoded);
+    }
+}
+
+bool D6T_Base::decode(uint8_t* wk_buf, int16_t* ptat, int16_t* buf)
+{
+    int i;
+    int j;
+
+    if (D6T_checkPEC(wk_buf, mReadLen - 1)) {
+        mPecErrors++;
         return false;
     }
 
@@ -70,41 +202,54 @@ bool D6T_44L_06::read(int16_t* ptat, int16_t* buf)
 
     // loop temperature pixels of each thrmopiles measurements
     if (buf != NULL) {
-        for (i = 0, j = 2; i < N_PIXEL; i++, j += 2) {
+        for (i = 0, j = 2; i < mPixel; i++, j += 2) {
             buf[i] = conv8us_s16_le(wk_buf, j);
         }
     }
 
+    mReads++;
     return true;
 }
 
-uint8_t D6T_44L_06::calc_crc(uint8_t data)
+D6T_Stats D6T_Base::stats(void) const
 {
-    int index;
-    uint8_t temp;
-    for (index = 0; index < 8; index++) {
-        temp = data;
-        data <<= 1;
-        if (temp & 0x80) {data ^= 0x07;}
-    }
-    return data;
+    D6T_Stats stats;
+
+    stats.reads = mReads;
+    stats.i2c_errors = mI2cErrors;
+    stats.pec_errors = mPecErrors;
+    return stats;
+}
+
+uint8_t D6T_Base::calc_crc(uint8_t data)
+{
+    return crc8_table.crc[data];
+}
+
+uint8_t D6T_Base::pec_seed(int addr)
+{
+    uint8_t crc;
+
+    // CRC of the fixed prefix: write address, command, read address
+    crc = calc_crc(addr);
+    crc = calc_crc(mCmd ^ crc);
+    crc = calc_crc((addr | 1) ^ crc);
+    return crc;
 }
 
-bool D6T_44L_06::D6T_checkPEC(uint8_t buf[], int n)
+bool D6T_Base::D6T_checkPEC(uint8_t buf[], int n)
 {
     uint8_t crc;
     int i;
 
-    crc = calc_crc(mAddr);
-    crc = calc_crc(D6T_CMD ^ crc);
-    crc = calc_crc((mAddr | 1) ^ crc);
+    crc = mPecSeed;
     for (i = 0; i < n; i++) {
         crc = calc_crc(buf[i] ^ crc);
     }
     return crc != buf[n];
 }
 
-int16_t D6T_44L_06::conv8us_s16_le(uint8_t* buf, int n)
+int16_t D6T_Base::conv8us_s16_le(uint8_t* buf, int n)
 {
     int ret;
     ret = buf[n];
@@ -113,16 +258,16 @@ int16_t D6T_44L_06::conv8us_s16_le(uint8_t* buf, int n)
 }
 
 
-int D6T_44L_06::read_reg(uint8_t reg, uint8_t* pbuf, uint8_t len)
+int D6T_Base::read_reg(uint8_t reg, uint8_t* pbuf, int len)
 {
     int ret;
 
-    mI2c_.lock();
-    ret = mI2c_.write(mAddr, (char *)&reg, 1, true);
+    mI2c_->lock();
+    ret = mI2c_->write(mAddr, &reg, 1, true);
     if (ret == 0) {
-        ret = mI2c_.read(mAddr, (char *)pbuf, len);
+        ret = mI2c_->read(mAddr, pbuf, len);
     }
-    mI2c_.unlock();
+    mI2c_->unlock();
 
     return ret;
 }
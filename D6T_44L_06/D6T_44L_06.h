@@ -28,8 +28,139 @@
 #define D6T_44L_06_H
 
 #include "mbed.h"
+#include "D6T_Traits.h"
+#include "ThermoHalI2c.h"
+#if DEVICE_I2C
+#include "ThermoMbedI2c.h"
+#endif
+
+/* I2C bus frequency: standard mode by default, fast mode at most */
+#define D6T_I2C_FREQUENCY       (100000)
+#define D6T_I2C_FREQUENCY_MAX   (400000)
+
+#define D6T_ADDR (0x0A << 1)  // for I2C 7bit address
+
+/** Reading counters of a sensor */
+struct D6T_Stats {
+    uint32_t reads;         // readings which passed the PEC check
+    uint32_t i2c_errors;    // readings which failed on the I2C bus
+    uint32_t pec_errors;    // readings rejected by the PEC check
+};
+
+/** Common part of the D6T sensors
+ *
+ *  The model dependent sizes come from the traits of D6T (see D6T_Traits.h),
+ *  this class only holds the I2C access, PEC check and decoding.
+ */
+class D6T_Base
+{
+public:
+    ~D6T_Base();
+
+    /** Initialize a sensor device
+     *
+     *  Writes the init sequence of the model (D6T_Traits.h), if it has one.
+     *  Should be called once per lifetime of the object.
+     *  Please wait about 100ms before calling the read function.
+     *  @return true on success, false if a write failed on the I2C bus
+     */
+    bool setup(void);
+
+    /** Read the current data from sensor
+     *
+     *  @param ptat PTAT destination (may be NULL)
+     *  @param buf  pixel data destination [rows][cols] (may be NULL)
+     *  @return true on success, false on failure
+     */
+    bool read(int16_t* ptat, int16_t* buf);
+
+    /** Start reading the current data from sensor without waiting
+     *
+     *  The transfer runs in the background (ThermoHalI2c::transfer). When it finishes,
+     *  the PEC is checked and ptat/buf are filled in the completion path, then
+     *  callback is called with the result. The callback runs in interrupt
+     *  context, so it should only signal a thread (e.g. EventFlags::set).
+     *  ptat and buf must stay valid until the callback.
+     *  Without DEVICE_I2C_ASYNCH the read is done before returning (see ThermoMbedI2c).
+     *
+     *  @param ptat     PTAT destination (may be NULL)
+     *  @param buf      pixel data destination [rows][cols] (may be NULL)
+     *  @param callback completion callback, true on success, false on failure
+     *  @return true if started, false if a read is already in progress or the bus is busy
+     */
+    bool read_async(int16_t* ptat, int16_t* buf, Callback<void(bool)> callback);
+
+    /** Abort a read started by read_async
+     *
+     *  On return ptat and buf of read_async are no longer written. The
+     *  callback is not called unless the transfer had already completed.
+     */
+    void abort_async(void);
+
+    /** Number of pixels of a reading */
+    int pixel(void) const { return mPixel; }
+
+    /** Bus time of a reading at the current bus frequency [us] */
+    uint32_t read_time_us(void) const { return D6T_READ_TIME_US(mReadLen, mI2c_->frequency()); }
+
+    /** Reading counters since the start (read and read_async) */
+    D6T_Stats stats(void) const;
+
+protected:
+#if DEVICE_I2C
+    D6T_Base(PinName sda, PinName scl, int hz, uint8_t cmd, int pixel, const uint8_t* p_init, uint8_t* p_rx_buf);
+#endif
+    D6T_Base(ThermoHalI2c& i2c, int addr, uint8_t cmd, int pixel, const uint8_t* p_init, uint8_t* p_rx_buf);
 
-/** xxxxxxxxxxxxxx [D6T_44L_06] class
+private:
+    ThermoHalI2c* mI2c_;
+#if DEVICE_I2C
+    alignas(ThermoMbedI2c) uint8_t mI2cBuf[sizeof(ThermoMbedI2c)];  // own bus of the sda/scl constructor
+#else
+    uint8_t mI2cBuf[1];
+#endif
+    int mAddr;
+    uint8_t mPecSeed;   // CRC of the address/command prefix of mAddr
+
+    // model dependent sizes
+    uint8_t mCmd;
+    int mPixel;
+    int mReadLen;
+    uint8_t* mRxBuf;    // [mReadLen] held by D6T
+    const uint8_t* mInit;   // register writes of setup, NULL: none
+
+    // reading state, changed by compare-and-swap (read, read_async, abort_async, transfer_done)
+    enum {
+        STATE_IDLE,
+        STATE_READ,     // read in progress
+        STATE_ASYNC,    // read_async transfer on the bus
+        STATE_DONE,     // transfer_done decoding into the caller's buffers
+        STATE_ABORT     // abort_async stopping the transfer
+    };
+    volatile uint8_t mState;
+    int16_t* mAsyncPtat;
+    int16_t* mAsyncBuf;
+    Callback<void(bool)> mAsyncCallback;
+
+    // counters, updated by the reading thread or the completion path
+    volatile uint32_t mReads;
+    volatile uint32_t mI2cErrors;
+    volatile uint32_t mPecErrors;
+
+    void init(int addr, uint8_t cmd, int pixel, const uint8_t* p_init, uint8_t* p_rx_buf);
+    bool decode(uint8_t* wk_buf, int16_t* ptat, int16_t* buf);
+    void transfer_done(int result);
+
+    uint8_t calc_crc(uint8_t data);
+    uint8_t pec_seed(int addr);
+    bool D6T_checkPEC(uint8_t buf[], int n);
+    int16_t conv8us_s16_le(uint8_t* buf, int n);
+    int read_reg(uint8_t reg, uint8_t* pbuf, int len);
+};
+
+/** D6T sensor of one model [D6T_44L_06 and the other D6T models]
+ *
+ *  The reading buffer is sized by the traits at compile time, no heap is used.
  *
  * @note Synchronization level: Thread safe
  *
@@ -39,55 +170,66 @@
  * #include "mbed.h"
  * #include "D6T_44L_06.h"
  *
- * D6T_44L_06 d6taaaa(I2C_SDA, I2C_SCL);
+ * D6T_44L_06 d6t(I2C_SDA, I2C_SCL);
  *
  * int main() {
- *     uint16_t illm;
- * 
- *     opt3001.setup();
+ *     int16_t ptat;
+ *     int16_t pixel[D6T_44L_06::PIXEL];
+ *
+ *     d6t.setup();
  *     ThisThread::sleep_for(110);
- * 
+ *
  *     while(1) {
- *         opt3001.read(&illm);
- *         printf("llluminance : %5.2f [lx]\r\n", illm / 100.0);
+ *         if (d6t.read(&ptat, pixel)) {
+ *             printf("PTAT %5.1f, pixel 0 %5.1f [degC]\r\n", ptat / 10.0, pixel[0] / 10.0);
+ *         }
  *         ThisThread::sleep_for(200);
  *     }
  * }
  * @endcode
  */
-class D6T_44L_06
+template <typename Traits>
+class D6T : public D6T_Base
 {
 public:
+    static constexpr int ROWS  = Traits::ROWS;
+    static constexpr int COLS  = Traits::COLS;
+    static constexpr int PIXEL = Traits::PIXEL;
+
     /** Create a sensor instance
      *  
      *  @param sda I2C data line pin
      *  @param scl I2C clock line pin
+     *  @param hz  I2C bus frequency (up to D6T_I2C_FREQUENCY_MAX)
      */
-    D6T_44L_06(PinName sda, PinName scl);
+#if DEVICE_I2C
+    D6T(PinName sda, PinName scl, int hz = D6T_I2C_FREQUENCY) :
+        D6T_Base(sda, scl, hz, Traits::CMD, Traits::PIXEL, Traits::init(), mRxBuf)
+    {
+    }
+#endif
 
-    /** Initialize a sensor device
+    /** Create a sensor instance on a shared I2C bus
      *
-     *  Should be called once per lifetime of the object.
-     *  Please wait about 100ms before calling the read function.
-     *  @return true on success, false on failure
-     */
-    bool setup(void);
-
-    /** Read the current data from sensor
+     *  The bus frequency is left to the owner of the I2C instance.
+     *  The sensors of one bus are read one after another (see ThermoAcquisition),
+     *  sensors with the same address need an I2C mux (see ThermoI2cMux).
      *
-     *  @return true on success, false on failure
+     *  @param i2c  I2C bus (must outlive the sensor)
+     *  @param addr 8bit I2C address
      */
-    bool read(int16_t* ptat, int16_t* buf);
+    D6T(ThermoHalI2c& i2c, int addr = D6T_ADDR) :
+        D6T_Base(i2c, addr, Traits::CMD, Traits::PIXEL, Traits::init(), mRxBuf)
+    {
+    }
 
 private:
-    I2C mI2c_;
-    int mAddr;
-
-
-    uint8_t calc_crc(uint8_t data);
-    bool D6T_checkPEC(uint8_t buf[], int n);
-    int16_t conv8us_s16_le(uint8_t* buf, int n);
-    int read_reg(uint8_t reg, uint8_t* pbuf, uint8_t len);
+    uint8_t mRxBuf[Traits::N_READ];
 };
 
+typedef D6T<D6T_1A_01_Traits>   D6T_1A_01;
+typedef D6T<D6T_8L_09_Traits>   D6T_8L_09;
+typedef D6T<D6T_44L_06_Traits>  D6T_44L_06;
+typedef D6T<D6T_32L_01A_Traits> D6T_32L_01A;
+
 #endif
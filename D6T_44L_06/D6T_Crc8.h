@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019, 2018 - present OMRON Corporation
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef D6T_CRC8_H
+#define D6T_CRC8_H
+
+#include <stdint.h>
+
+/* SMBus PEC: CRC-8, polynomial x^8 + x^2 + x + 1, initial value 0 */
+#define D6T_CRC8_POLY   (0x07)
+
+/** CRC-8 of one byte by the 8-iteration bit loop (the former calc_crc)
+ *
+ *  Reference of D6T_Crc8Table for the host tests and benchmark.
+ */
+static inline uint8_t D6T_crc8_bitwise(uint8_t data)
+{
+    int index;
+    uint8_t temp;
+
+    for (index = 0; index < 8; index++) {
+        temp = data;
+        data <<= 1;
+        if (temp & 0x80) {
+            data ^= D6T_CRC8_POLY;
+        }
+    }
+    return data;
+}
+
+/** CRC-8 lookup table, built at compile time
+ *
+ *  crc[n] is the value of the 8-iteration bit loop for the byte n,
+ *  so one byte of the PEC takes a single lookup.
+ */
+struct D6T_Crc8Table {
+    uint8_t crc[256];
+
+    constexpr D6T_Crc8Table() : crc()
+    {
+        for (int n = 0; n < 256; n++) {
+            uint8_t data = (uint8_t)n;
+            for (int bit = 0; bit < 8; bit++) {
+                data = (uint8_t)((data & 0x80) ? ((data << 1) ^ D6T_CRC8_POLY) : (data << 1));
+            }
+            crc[n] = data;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019, 2018 - present OMRON Corporation
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#ifndef D6T_TRAITS_H
+#define D6T_TRAITS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Frame length of a reading: PTAT and pixels (2 bytes each) and PEC */
+#define D6T_FRAME_LENGTH(pixel)     ((((pixel) + 1) * 2) + 1)
+
+/* Bus time of a reading [us]: write address, command, read address and n_read bytes, 9 clocks each */
+#define D6T_READ_TIME_US(n_read, hz) \
+    ((uint32_t)((((uint64_t)(n_read) + 3) * 9 * 1000000) / (uint64_t)(hz)))
+
+/* Longest register write of an init sequence: register and data, without the PEC */
+#define D6T_INIT_WRITE_MAX          (3)
+
+/* Each model gives init(): the register writes before the first reading as
+   length, register, data..., closed by a 0 length (NULL: none). The PEC
+   byte of each write is added by D6T_Base::setup(). */
+
+/** D6T-1A-01/02 (1x1) */
+struct D6T_1A_01_Traits {
+    static constexpr int     ROWS   = 1;
+    static constexpr int     COLS   = 1;
+    static constexpr int     PIXEL  = ROWS * COLS;
+    static constexpr uint8_t CMD    = 0x4C;
+    static constexpr int     N_READ = D6T_FRAME_LENGTH(PIXEL);
+
+    static const uint8_t* init(void) { return NULL; }
+};
+
+/** D6T-8L-09/09H (1x8) */
+struct D6T_8L_09_Traits {
+    static constexpr int     ROWS   = 1;
+    static constexpr int     COLS   = 8;
+    static constexpr int     PIXEL  = ROWS * COLS;
+    static constexpr uint8_t CMD    = 0x4C;
+    static constexpr int     N_READ = D6T_FRAME_LENGTH(PIXEL);
+
+    /* the setting sequence of OMRON's D6T-8L-09 sample */
+    static const uint8_t* init(void)
+    {
+        static const uint8_t sequence[] = {
+            3, 0x02, 0x00, 0x01,
+            3, 0x05, 0x90, 0x3A,
+            3, 0x03, 0x00, 0x03,
+            3, 0x03, 0x00, 0x07,
+            3, 0x02, 0x00, 0x00,
+            0
+        };
+        return sequence;
+    }
+};
+
+/** D6T-44L-06/06H (4x4) */
+struct D6T_44L_06_Traits {
+    static constexpr int     ROWS   = 4;
+    static constexpr int     COLS   = 4;
+    static constexpr int     PIXEL  = ROWS * COLS;
+    static constexpr uint8_t CMD    = 0x4C;
+    static constexpr int     N_READ = D6T_FRAME_LENGTH(PIXEL);
+
+    static const uint8_t* init(void) { return NULL; }
+};
+
+/** D6T-32L-01A (32x32) */
+struct D6T_32L_01A_Traits {
+    static constexpr int     ROWS   = 32;
+    static constexpr int     COLS   = 32;
+    static constexpr int     PIXEL  = ROWS * COLS;
+    static constexpr uint8_t CMD    = 0x4D;
+    static constexpr int     N_READ = D6T_FRAME_LENGTH(PIXEL);
+
+    /* register 0x01 of OMRON's D6T-32L-01A sample: IIR filter off (upper nibble), averaging 0x04 (lower nibble) */
+    static const uint8_t* init(void)
+    {
+        static const uint8_t sequence[] = {
+            2, 0x01, 0x04,
+            0
+        };
+        return sequence;
+    }
+};
+
+#endif
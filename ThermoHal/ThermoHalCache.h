@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_HAL_CACHE_H
+#define THERMO_HAL_CACHE_H
+
+#include <stdint.h>
+
+/** Data cache maintenance of buffers shared with bus masters (VDC, DRP)
+ *
+ *  Implemented by ThermoMbedCache (dcache_clean) on the board and by
+ *  SimCache in the host simulator.
+ */
+class ThermoHalCache
+{
+public:
+    virtual ~ThermoHalCache() {}
+
+    /** Write back an area to memory */
+    virtual void clean(void* p_buf, uint32_t size) = 0;
+
+    /** Drop the cached lines of an area written by a bus master before reading it */
+    virtual void invalidate(void* p_buf, uint32_t size) = 0;
+};
+
+#endif
@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_HAL_DISPLAY_H
+#define THERMO_HAL_DISPLAY_H
+
+#include <stdint.h>
+
+/** Layer alpha of an ARGB4444 alpha nibble (0x0 - 0xF to 0x00 - 0xFF) */
+static inline uint8_t thermo_layer_alpha(uint8_t alpha)
+{
+    return (uint8_t)(alpha * 0x11);
+}
+
+/** Display layer showing the thermograph
+ *
+ *  Implemented by ThermoMbedDisplay (DisplayBase::Graphics_Read_Change) on
+ *  the board and by SimDisplay in the host simulator.
+ */
+class ThermoHalDisplay
+{
+public:
+    virtual ~ThermoHalDisplay() {}
+
+    /** Show a buffer from the next frame on (the buffer must be cleaned from the data cache) */
+    virtual void swap(const void* p_buf) = 0;
+
+    /** Multiply the alpha of every pixel of the layer
+     *
+     *  Fades cost a register write instead of rendering the buffer again.
+     *
+     *  @param alpha 0x00 (transparent) - 0xFF (pixel alpha as drawn)
+     *  @return false if the layer has no global alpha, the pixel alpha has to be drawn then
+     */
+    virtual bool set_layer_alpha(uint8_t alpha) = 0;
+
+    /** True if the layer scales a smaller buffer up to its whole area */
+    virtual bool has_scaler(void) const = 0;
+
+    /** Show a buffer of grid size scaled up to the whole layer (has_scaler() only)
+     *
+     *  @param p_buf  ARGB4444 buffer, cleaned from the data cache
+     *  @param width  buffer width [pixel]
+     *  @param height buffer height [pixel]
+     *  @param stride bytes per buffer row
+     */
+    virtual void swap_scaled(const void* p_buf, int width, int height, int stride) = 0;
+};
+
+#endif
@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_HAL_DRP_H
+#define THERMO_HAL_DRP_H
+
+#include <stdint.h>
+
+/** Dynamically Reconfigurable Processor
+ *
+ *  Implemented by ThermoMbedDrp (R_DK2_*) on the board and by SimDrp in the
+ *  host simulator. Tile and pattern values are the ones of R_DK2_Load.
+ */
+class ThermoHalDrp
+{
+public:
+    virtual ~ThermoHalDrp() {}
+
+    /** Initialize the DRP driver
+     *
+     *  @return true on success, false on failure
+     */
+    virtual bool initialize(void) = 0;
+
+    /** Load and activate a DRP library
+     *
+     *  @param p_config  configuration data of the library
+     *  @param top_tiles top tile of each instance (R_DK2_TILE_n)
+     *  @param pattern   tile pattern (R_DK2_TILE_PATTERN_n)
+     *  @param p_id      library ID of each tile [R_DK2_TILE_NUM] (output)
+     *  @return true on success, false on failure
+     */
+    virtual bool load(const uint8_t* p_config, uint8_t top_tiles, uint32_t pattern, uint8_t* p_id) = 0;
+
+    /** Unload a library and free its tiles
+     *
+     *  @param id library ID, 0 unloads every library
+     *  @return true on success, false on failure
+     */
+    virtual bool unload(uint8_t id) = 0;
+
+    /** Run a loaded library and wait for the completion of all its tiles
+     *
+     *  @param id      library ID
+     *  @param p_param parameter structure of the library
+     *  @param size    size of the parameter structure
+     *  @return true on success, false on failure
+     */
+    virtual bool run(uint8_t id, void* p_param, uint32_t size) = 0;
+};
+
+#endif
@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_HAL_I2C_H
+#define THERMO_HAL_I2C_H
+
+#include "mbed.h"
+
+/* Result of ThermoHalI2c::transfer */
+#define THERMO_HAL_I2C_OK       (0)
+#define THERMO_HAL_I2C_ERROR    (-1)
+
+/** I2C bus used by the sensor drivers
+ *
+ *  Implemented by ThermoMbedI2c on the board and by SimI2cBus in the host
+ *  simulator. Addresses are 8bit (7bit address << 1) as with mbed I2C.
+ */
+class ThermoHalI2c
+{
+public:
+    virtual ~ThermoHalI2c() {}
+
+    /** Set the bus frequency [Hz] */
+    virtual void frequency(int hz) = 0;
+
+    /** Bus frequency [Hz] */
+    virtual int frequency(void) const = 0;
+
+    /** Acquire/release exclusive access to the bus */
+    virtual void lock(void) = 0;
+    virtual void unlock(void) = 0;
+
+    /** Write to a device
+     *
+     *  @param repeated true to keep the bus for a repeated start
+     *  @return 0 on success (ack), nonzero on failure
+     */
+    virtual int write(int addr, const uint8_t* p_data, int len, bool repeated = false) = 0;
+
+    /** Read from a device
+     *
+     *  @return 0 on success (ack), nonzero on failure
+     */
+    virtual int read(int addr, uint8_t* p_data, int len) = 0;
+
+    /** Write then read with a repeated start, without waiting
+     *
+     *  callback gets THERMO_HAL_I2C_OK or THERMO_HAL_I2C_ERROR, possibly from
+     *  interrupt context. The buffers must stay valid until then.
+     *  @return 0 if started, nonzero if the bus is busy
+     */
+    virtual int transfer(int addr, const uint8_t* p_tx, int tx_len, uint8_t* p_rx, int rx_len,
+                         Callback<void(int)> callback) = 0;
+
+    /** Abort the transfer in progress (the callback is not called) */
+    virtual void abort_transfer(void) = 0;
+};
+
+#endif
@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_HAL_SERIAL_H
+#define THERMO_HAL_SERIAL_H
+
+#include <stdint.h>
+
+/** Byte output of the telemetry stream
+ *
+ *  Implemented by ThermoMbedSerial on the board and by SimSerial in the host
+ *  simulator. Only the telemetry writer thread calls it, so it may wait.
+ */
+class ThermoHalSerial
+{
+public:
+    virtual ~ThermoHalSerial() {}
+
+    /** Write bytes, waiting while the port is busy
+     *
+     *  @return bytes written (1 - size), 0 or negative on failure
+     */
+    virtual int write(const void* p_data, uint32_t size) = 0;
+};
+
+#endif
@@ -0,0 +1,127 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_MBED_DISPLAY_H
+#define THERMO_MBED_DISPLAY_H
+
+#include "mbed.h"
+#include "DisplayBase.h"
+#include "ThermoHalDisplay.h"
+#if defined(TARGET_RZ_A2XX)
+#include "r_vdc.h"
+#endif
+
+/** ThermoHalDisplay of a VDC graphics layer
+ *
+ *  The layer alpha is the rectangle alpha blending of the VDC
+ *  (R_VDC_AlphaBlendingRect, the pixel alpha is multiplied by it).
+ *  The graphics layers of the RZ/A2M VDC read their buffer 1:1 (the scaler
+ *  is on the video input side), so the layer has no scaler and the
+ *  thermograph is drawn at display size.
+ */
+class ThermoMbedDisplay : public ThermoHalDisplay
+{
+public:
+    /** Create a display instance
+     *
+     *  @param display display driver (must outlive the instance)
+     *  @param layer   graphics layer of the thermograph
+     *  @param width   layer width [pixel]
+     *  @param height  layer height [pixel]
+     */
+    ThermoMbedDisplay(DisplayBase& display, DisplayBase::graphics_layer_t layer, uint16_t width, uint16_t height) :
+        mDisplay(display), mLayer(layer), mWidth(width), mHeight(height)
+    {
+    }
+
+    virtual void swap(const void* p_buf)
+    {
+        mDisplay.Graphics_Read_Change(mLayer, (void *)p_buf);
+    }
+
+    virtual bool set_layer_alpha(uint8_t alpha)
+    {
+#if defined(TARGET_RZ_A2XX)
+        vdc_layer_id_t            layer_id;
+        vdc_pd_disp_rect_t        area;
+        vdc_alpha_rect_t          alpha_rect;
+        vdc_alpha_blending_rect_t param;
+
+        switch (mLayer) {
+            case DisplayBase::GRAPHICS_LAYER_0:
+                layer_id = VDC_LAYER_ID_0_RD;
+                break;
+            case DisplayBase::GRAPHICS_LAYER_2:
+                layer_id = VDC_LAYER_ID_2_RD;
+                break;
+            case DisplayBase::GRAPHICS_LAYER_3:
+                layer_id = VDC_LAYER_ID_3_RD;
+                break;
+            default:
+                return false;
+        }
+
+        // whole layer, constant alpha (no fade ramp of the VDC), multiplied with the pixel alpha
+        area.vs = 0;
+        area.vw = mHeight;
+        area.hs = 0;
+        area.hw = mWidth;
+        alpha_rect.gr_arc_coef = 0;
+        alpha_rect.gr_arc_rate = 0;
+        alpha_rect.gr_arc_def  = alpha;
+        alpha_rect.gr_arc_mul  = VDC_ON;
+        param.gr_arc      = &area;
+        param.alpha_rect  = &alpha_rect;
+        param.scl_und_sel = NULL;
+
+        return (VDC_OK == R_VDC_AlphaBlendingRect(VDC_CHANNEL_0, layer_id, true, &param));
+#else
+        (void)alpha;
+        return false;
+#endif
+    }
+
+    virtual bool has_scaler(void) const
+    {
+        return false;
+    }
+
+    virtual void swap_scaled(const void* p_buf, int width, int height, int stride)
+    {
+        // not used, has_scaler() is false
+        (void)p_buf;
+        (void)width;
+        (void)height;
+        (void)stride;
+    }
+
+private:
+    DisplayBase& mDisplay;
+    DisplayBase::graphics_layer_t mLayer;
+    uint16_t mWidth;
+    uint16_t mHeight;
+};
+
+#endif
@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ThermoMbedDrp.h"
+
+ThermoMbedDrp* ThermoMbedDrp::sInstance = NULL;
+
+ThermoMbedDrp::ThermoMbedDrp()
+{
+    memset(mId, 0, sizeof(mId));
+    sInstance = this;
+}
+
+bool ThermoMbedDrp::initialize(void)
+{
+    return R_DK2_Initialize() == R_DK2_SUCCESS;
+}
+
+bool ThermoMbedDrp::load(const uint8_t* p_config, uint8_t top_tiles, uint32_t pattern, uint8_t* p_id)
+{
+    if (R_DK2_Load((void *)p_config, top_tiles, pattern, NULL, &ThermoMbedDrp::finish, mId) != R_DK2_SUCCESS) {
+        return false;
+    }
+    if (R_DK2_Activate(0, 0) != R_DK2_SUCCESS) {
+        return false;
+    }
+    if (p_id != NULL) {
+        memcpy(p_id, mId, sizeof(mId));
+    }
+    return true;
+}
+
+bool ThermoMbedDrp::unload(uint8_t id)
+{
+    uint8_t state[R_DK2_TILE_NUM];
+    uint32_t tile_no;
+
+    if (R_DK2_Unload(id, state) != R_DK2_SUCCESS) {
+        return false;
+    }
+    for (tile_no = 0; tile_no < R_DK2_TILE_NUM; tile_no++) {
+        if ((id == 0) || (mId[tile_no] == id)) {
+            mId[tile_no] = 0;
+        }
+    }
+    return true;
+}
+
+bool ThermoMbedDrp::run(uint8_t id, void* p_param, uint32_t size)
+{
+    uint32_t tiles = 0;
+    uint32_t tile_no;
+
+    for (tile_no = 0; tile_no < R_DK2_TILE_NUM; tile_no++) {
+        if (mId[tile_no] == id) {
+            tiles |= (1 << tile_no);
+        }
+    }
+    if (tiles == 0) {
+        return false;
+    }
+
+    mFlags.clear(tiles);
+    if (R_DK2_Start(id, p_param, size) != R_DK2_SUCCESS) {
+        return false;
+    }
+    mFlags.wait_all(tiles);
+    return true;
+}
+
+void ThermoMbedDrp::finish(uint8_t id)
+{
+    uint32_t tile_no;
+    uint32_t set_flgs = 0;
+
+    // Change the operation state of the DRP library notified by the argument to finish
+    for (tile_no = 0; tile_no < R_DK2_TILE_NUM; tile_no++) {
+        if (sInstance->mId[tile_no] == id) {
+            set_flgs |= (1 << tile_no);
+        }
+    }
+    sInstance->mFlags.set(set_flgs);
+}
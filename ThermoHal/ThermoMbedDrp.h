@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_MBED_DRP_H
+#define THERMO_MBED_DRP_H
+
+#include "mbed.h"
+#include "r_dk2_if.h"
+#include "ThermoHalDrp.h"
+
+/** ThermoHalDrp of the DRP driver (R_DK2_*)
+ *
+ *  The driver has one finish callback without a context, so only one
+ *  instance may exist.
+ */
+class ThermoMbedDrp : public ThermoHalDrp
+{
+public:
+    ThermoMbedDrp();
+
+    virtual bool initialize(void);
+    virtual bool load(const uint8_t* p_config, uint8_t top_tiles, uint32_t pattern, uint8_t* p_id);
+    virtual bool unload(uint8_t id);
+    virtual bool run(uint8_t id, void* p_param, uint32_t size);
+
+private:
+    uint8_t mId[R_DK2_TILE_NUM];    // library ID of each tile
+    EventFlags mFlags;              // bit n: tile n finished
+
+    static ThermoMbedDrp* sInstance;
+    static void finish(uint8_t id);
+};
+
+#endif
@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ThermoMbedI2c.h"
+
+ThermoMbedI2c::ThermoMbedI2c(PinName sda, PinName scl) :
+    mI2c(sda, scl), mHz(100000)   // I2C default
+{
+}
+
+void ThermoMbedI2c::frequency(int hz)
+{
+    mI2c.frequency(hz);
+    mHz = hz;
+}
+
+void ThermoMbedI2c::lock(void)
+{
+    mI2c.lock();
+}
+
+void ThermoMbedI2c::unlock(void)
+{
+    mI2c.unlock();
+}
+
+int ThermoMbedI2c::write(int addr, const uint8_t* p_data, int len, bool repeated)
+{
+    return mI2c.write(addr, (const char *)p_data, len, repeated);
+}
+
+int ThermoMbedI2c::read(int addr, uint8_t* p_data, int len)
+{
+    return mI2c.read(addr, (char *)p_data, len);
+}
+
+int ThermoMbedI2c::transfer(int addr, const uint8_t* p_tx, int tx_len, uint8_t* p_rx, int rx_len,
+                            Callback<void(int)> callback)
+{
+    mCallback = callback;
+#if DEVICE_I2C_ASYNCH
+    return mI2c.transfer(addr, (const char *)p_tx, tx_len, (char *)p_rx, rx_len,
+                         event_callback_t(this, &ThermoMbedI2c::transfer_done), I2C_EVENT_ALL, false);
+#else
+    int ret;
+
+    mI2c.lock();
+    ret = mI2c.write(addr, (const char *)p_tx, tx_len, true);
+    if (ret == 0) {
+        ret = mI2c.read(addr, (char *)p_rx, rx_len);
+    }
+    mI2c.unlock();
+    transfer_done((ret == 0) ? I2C_EVENT_TRANSFER_COMPLETE : I2C_EVENT_ERROR);
+    return 0;
+#endif
+}
+
+void ThermoMbedI2c::abort_transfer(void)
+{
+#if DEVICE_I2C_ASYNCH
+    mI2c.abort_transfer();
+#endif
+}
+
+void ThermoMbedI2c::transfer_done(int event)
+{
+    if (mCallback) {
+        mCallback(((event & I2C_EVENT_ALL) == I2C_EVENT_TRANSFER_COMPLETE) ? THERMO_HAL_I2C_OK : THERMO_HAL_I2C_ERROR);
+    }
+}
@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_MBED_I2C_H
+#define THERMO_MBED_I2C_H
+
+#include "mbed.h"
+#include "ThermoHalI2c.h"
+
+/** ThermoHalI2c of an mbed I2C bus
+ *
+ *  transfer() uses I2C::transfer when the target has DEVICE_I2C_ASYNCH,
+ *  otherwise it is done before returning and calls the callback directly.
+ */
+class ThermoMbedI2c : public ThermoHalI2c
+{
+public:
+    /** Create a bus instance
+     *
+     *  @param sda I2C data line pin
+     *  @param scl I2C clock line pin
+     */
+    ThermoMbedI2c(PinName sda, PinName scl);
+
+    virtual void frequency(int hz);
+    virtual int frequency(void) const { return mHz; }
+    virtual void lock(void);
+    virtual void unlock(void);
+    virtual int write(int addr, const uint8_t* p_data, int len, bool repeated = false);
+    virtual int read(int addr, uint8_t* p_data, int len);
+    virtual int transfer(int addr, const uint8_t* p_tx, int tx_len, uint8_t* p_rx, int rx_len,
+                         Callback<void(int)> callback);
+    virtual void abort_transfer(void);
+
+private:
+    I2C mI2c;
+    int mHz;
+    Callback<void(int)> mCallback;
+
+    void transfer_done(int event);
+};
+
+#endif
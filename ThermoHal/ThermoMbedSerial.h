@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_MBED_SERIAL_H
+#define THERMO_MBED_SERIAL_H
+
+#include "mbed.h"
+#include "ThermoHalSerial.h"
+
+/** ThermoHalSerial of a file handle of the retarget layer (the console by default)
+ *
+ *  The bytes go to the FileHandle directly, past the newline conversion of
+ *  printf ("platform.stdio-convert-newlines"), so binary data stays intact.
+ *  The handle is looked up at the first write, after the console is set up.
+ */
+class ThermoMbedSerial : public ThermoHalSerial
+{
+public:
+    ThermoMbedSerial(int fd = STDOUT_FILENO) : mFd(fd), mFile(NULL) {}
+
+    virtual int write(const void* p_data, uint32_t size)
+    {
+        if (mFile == NULL) {
+            mFile = mbed_file_handle(mFd);
+            if (mFile == NULL) {
+                return -1;
+            }
+        }
+        return (int)mFile->write(p_data, size);
+    }
+
+private:
+    int mFd;
+    FileHandle* mFile;
+};
+
+#endif
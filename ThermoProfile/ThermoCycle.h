@@ -0,0 +1,83 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_CYCLE_H
+#define THERMO_CYCLE_H
+
+#include <stdint.h>
+
+#if defined(__ARM_ARCH_7A__)
+#include "mbed.h"
+
+/** Start the cycle counter (PMCCNTR of the Cortex-A9 PMU)
+ *
+ *  Must be called from a privileged thread (RTX default) before the first read.
+ */
+static inline void thermo_cycle_init(void)
+{
+    uint32_t pmcr;
+
+    __asm volatile ("mrc p15, 0, %0, c9, c12, 0" : "=r" (pmcr));
+    pmcr |= (1u << 0) | (1u << 2);      // E: enable, C: reset the cycle counter
+    pmcr &= ~(1u << 3);                 // D: count every cycle
+    __asm volatile ("mcr p15, 0, %0, c9, c12, 0" : : "r" (pmcr));
+    __asm volatile ("mcr p15, 0, %0, c9, c12, 1" : : "r" (1u << 31));  // PMCNTENSET: cycle counter
+}
+
+/** Current cycle count, wraps around every 2^32 cycles (8s at 528MHz) */
+static inline uint32_t thermo_cycle_read(void)
+{
+    uint32_t cycles;
+
+    __asm volatile ("mrc p15, 0, %0, c9, c13, 0" : "=r" (cycles));
+    return cycles;
+}
+
+/** Cycles per second */
+static inline uint32_t thermo_cycle_hz(void)
+{
+    return SystemCoreClock;
+}
+#else
+#include <chrono>
+
+/* Host build: a nanosecond clock stands in for the cycle counter */
+static inline void thermo_cycle_init(void)
+{
+}
+
+static inline uint32_t thermo_cycle_read(void)
+{
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static inline uint32_t thermo_cycle_hz(void)
+{
+    return 1000000000u;
+}
+#endif
+
+#endif
@@ -0,0 +1,163 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "ThermoProfiler.h"
+
+ThermoProfiler::ThermoProfiler()
+{
+    int i;
+
+    for (i = 0; i < THERMO_PROFILE_MAX_STAGE; i++) {
+        mStage[i].name = NULL;
+    }
+    mCyclesPerUs = 0;
+    reset();
+}
+
+bool ThermoProfiler::set_stage(int stage, const char* name)
+{
+    if ((stage < 0) || (stage >= THERMO_PROFILE_MAX_STAGE)) {
+        return false;
+    }
+    mStage[stage].name = name;
+    return true;
+}
+
+void ThermoProfiler::record(int stage, uint32_t cycles)
+{
+    Stage* p_stage;
+    uint32_t us;
+    int bucket;
+
+    if ((stage < 0) || (stage >= THERMO_PROFILE_MAX_STAGE)) {
+        return;
+    }
+    // the clock may be set up after the constructor (SystemCoreClock)
+    if (mCyclesPerUs == 0) {
+        mCyclesPerUs = thermo_cycle_hz() / 1000000u;
+        if (mCyclesPerUs == 0) {
+            mCyclesPerUs = 1;
+        }
+    }
+
+    p_stage = &mStage[stage];
+    us = cycles / mCyclesPerUs;
+    bucket = (us == 0) ? 0 : (32 - __builtin_clz(us));
+    if (bucket >= THERMO_PROFILE_BUCKETS) {
+        bucket = THERMO_PROFILE_BUCKETS - 1;
+    }
+
+    p_stage->ring[p_stage->count % THERMO_PROFILE_RING] = us;
+    p_stage->hist[bucket]++;
+    if (us < p_stage->min_us) {
+        p_stage->min_us = us;
+    }
+    if (us > p_stage->max_us) {
+        p_stage->max_us = us;
+    }
+    p_stage->count++;
+}
+
+void ThermoProfiler::reset(void)
+{
+    int i;
+
+    for (i = 0; i < THERMO_PROFILE_MAX_STAGE; i++) {
+        Stage& stage = mStage[i];
+
+        stage.count  = 0;
+        stage.min_us = UINT32_MAX;
+        stage.max_us = 0;
+        memset(stage.ring, 0, sizeof(stage.ring));
+        memset(stage.hist, 0, sizeof(stage.hist));
+    }
+}
+
+bool ThermoProfiler::stats(int stage, ThermoStageStats& stats) const
+{
+    const Stage* p_stage;
+    uint32_t recent;
+    uint32_t sum = 0;
+    uint32_t i;
+
+    if ((stage < 0) || (stage >= THERMO_PROFILE_MAX_STAGE) || (mStage[stage].name == NULL)) {
+        return false;
+    }
+    p_stage = &mStage[stage];
+
+    recent = (p_stage->count < THERMO_PROFILE_RING) ? p_stage->count : THERMO_PROFILE_RING;
+    stats.name = p_stage->name;
+    stats.count = p_stage->count;
+    stats.last_us = (p_stage->count == 0) ? 0 : p_stage->ring[(p_stage->count - 1) % THERMO_PROFILE_RING];
+    stats.min_us = (p_stage->count == 0) ? 0 : p_stage->min_us;
+    stats.max_us = p_stage->max_us;
+    stats.recent_max_us = 0;
+    for (i = 0; i < recent; i++) {
+        sum += p_stage->ring[i];
+        if (p_stage->ring[i] > stats.recent_max_us) {
+            stats.recent_max_us = p_stage->ring[i];
+        }
+    }
+    stats.recent_mean_us = (recent == 0) ? 0 : (sum / recent);
+    stats.p50_us = percentile(*p_stage, 500);
+    stats.p99_us = percentile(*p_stage, 990);
+    return true;
+}
+
+void ThermoProfiler::print(void) const
+{
+    ThermoStageStats stats;
+    int i;
+
+    printf("stage       count    last    mean     max    p50<    p99< [us]\r\n");
+    for (i = 0; i < THERMO_PROFILE_MAX_STAGE; i++) {
+        if (this->stats(i, stats) == false) {
+            continue;
+        }
+        printf("%-8s %8lu %7lu %7lu %7lu %7lu %7lu\r\n", stats.name, (unsigned long)stats.count,
+               (unsigned long)stats.last_us, (unsigned long)stats.recent_mean_us, (unsigned long)stats.recent_max_us,
+               (unsigned long)stats.p50_us, (unsigned long)stats.p99_us);
+    }
+}
+
+uint32_t ThermoProfiler::percentile(const Stage& stage, uint32_t permille)
+{
+    uint32_t target = (uint32_t)(((uint64_t)stage.count * permille + 999) / 1000);
+    uint32_t total = 0;
+    int bucket;
+
+    if (stage.count == 0) {
+        return 0;
+    }
+    for (bucket = 0; bucket < (THERMO_PROFILE_BUCKETS - 1); bucket++) {
+        total += stage.hist[bucket];
+        if (total >= target) {
+            return 1u << bucket;
+        }
+    }
+    return stage.max_us;
+}
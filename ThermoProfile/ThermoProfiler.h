@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_PROFILER_H
+#define THERMO_PROFILER_H
+
+#include <stdint.h>
+#include "ThermoCycle.h"
+
+/* Number of stages of one profiler */
+#ifndef THERMO_PROFILE_MAX_STAGE
+#define THERMO_PROFILE_MAX_STAGE    (8)
+#endif
+
+/* Recent samples kept per stage */
+#define THERMO_PROFILE_RING         (32)
+
+/* Histogram buckets: bucket n counts times below 2^n us, the last one the rest */
+#define THERMO_PROFILE_BUCKETS      (20)
+
+/** Counters of one stage [us] */
+struct ThermoStageStats {
+    const char* name;
+    uint32_t count;         // samples since reset
+    uint32_t last_us;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint32_t recent_mean_us;    // over the last THERMO_PROFILE_RING samples
+    uint32_t recent_max_us;
+    uint32_t p50_us;        // upper edge of the histogram bucket
+    uint32_t p99_us;
+};
+
+/** Per-stage timing of the hot paths
+ *
+ *  A stage is timed with the cycle counter (ThermoScopedTimer or record()),
+ *  the time goes to a ring of recent samples and a log2 histogram.
+ *  Recording is a few loads and stores without locks, so it can stay on in
+ *  production builds. Each stage should be recorded by one thread only;
+ *  readers from other threads may see a sample half counted, which is
+ *  fine for monitoring.
+ *
+ * Example:
+ * @code
+ *
+ * ThermoProfiler profiler;
+ *
+ * int main() {
+ *     thermo_cycle_init();
+ *     profiler.set_stage(0, "render");
+ *     while (1) {
+ *         {
+ *             ThermoScopedTimer timer(profiler, 0);
+ *             ...
+ *         }
+ *         profiler.print();
+ *     }
+ * }
+ * @endcode
+ */
+class ThermoProfiler
+{
+public:
+    ThermoProfiler();
+
+    /** Name a stage
+     *
+     *  @param stage stage number (less than THERMO_PROFILE_MAX_STAGE)
+     *  @param name  name shown by print (must stay valid)
+     *  @return true on success, false if the stage number is out of range
+     */
+    bool set_stage(int stage, const char* name);
+
+    /** Add a sample
+     *
+     *  @param stage  stage number
+     *  @param cycles elapsed cycles (thermo_cycle_read() difference)
+     */
+    void record(int stage, uint32_t cycles);
+
+    /** Clear the samples of every stage */
+    void reset(void);
+
+    /** Counters of a stage
+     *
+     *  @return true on success, false if the stage is not named
+     */
+    bool stats(int stage, ThermoStageStats& stats) const;
+
+    /** Print one line per named stage to the console */
+    void print(void) const;
+
+private:
+    struct Stage {
+        const char* name;
+        uint32_t count;
+        uint32_t min_us;
+        uint32_t max_us;
+        uint32_t ring[THERMO_PROFILE_RING];
+        uint32_t hist[THERMO_PROFILE_BUCKETS];
+    };
+
+    Stage mStage[THERMO_PROFILE_MAX_STAGE];
+    uint32_t mCyclesPerUs;
+
+    static uint32_t percentile(const Stage& stage, uint32_t permille);
+};
+
+/** Times a scope and records it to a profiler stage */
+class ThermoScopedTimer
+{
+public:
+    ThermoScopedTimer(ThermoProfiler& profiler, int stage) :
+        mProfiler(profiler), mStage(stage), mStart(thermo_cycle_read())
+    {
+    }
+
+    ~ThermoScopedTimer()
+    {
+        mProfiler.record(mStage, thermo_cycle_read() - mStart);
+    }
+
+private:
+    ThermoProfiler& mProfiler;
+    int mStage;
+    uint32_t mStart;
+};
+
+#endif
@@ -0,0 +1,276 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <string.h>
+#include "ThermoLog.h"
+#include "ThermoCrc16.h"
+
+#define LOG_MAGIC           "D6TL"
+#define LOG_CRC_OFFSET      (30)
+#define LOG_RECORD          THERMO_LOG_RECORD_SIZE(THERMO_FRAME_PIXEL)
+
+static_assert(LOG_RECORD <= (THERMO_LOG_CHUNK_SIZE - THERMO_LOG_HEADER), "a frame does not fit a log chunk");
+
+static constexpr ThermoCrc16Table crc16_table{};
+
+static inline void put_u16(uint8_t* p_data, uint16_t value)
+{
+    p_data[0] = (uint8_t)value;
+    p_data[1] = (uint8_t)(value >> 8);
+}
+
+static inline void put_u32(uint8_t* p_data, uint32_t value)
+{
+    put_u16(p_data, (uint16_t)value);
+    put_u16(&p_data[2], (uint16_t)(value >> 16));
+}
+
+static inline uint16_t get_u16(const uint8_t* p_data)
+{
+    return (uint16_t)(p_data[0] | (p_data[1] << 8));
+}
+
+static inline uint32_t get_u32(const uint8_t* p_data)
+{
+    return get_u16(p_data) | ((uint32_t)get_u16(&p_data[2]) << 16);
+}
+
+uint16_t thermo_log_crc(const uint8_t* p_chunk)
+{
+    uint16_t crc = crc16_table.update(THERMO_CRC16_INIT, p_chunk, LOG_CRC_OFFSET);
+
+    return crc16_table.update(crc, &p_chunk[THERMO_LOG_HEADER], (uint32_t)get_u16(&p_chunk[12]) * get_u16(&p_chunk[14]));
+}
+
+ThermoLogWriter::ThermoLogWriter(uint8_t* p_chunk) :
+    mChunk(p_chunk), mFile(NULL), mIndex(0), mRecords(0)
+{
+    memset(&mStats, 0, sizeof(mStats));
+}
+
+bool ThermoLogWriter::open(const char* path)
+{
+    long size;
+
+    close();
+    mFile = fopen(path, "ab");
+    if (mFile == NULL) {
+        return false;
+    }
+    // every chunk is one write call to the file system
+    setvbuf(mFile, NULL, _IONBF, 0);
+    fseek(mFile, 0, SEEK_END);
+    size = ftell(mFile);
+    if (size < 0) {
+        size = 0;
+    }
+    if ((size % THERMO_LOG_CHUNK_SIZE) != 0) {
+        uint32_t pad = THERMO_LOG_CHUNK_SIZE - (size % THERMO_LOG_CHUNK_SIZE);
+
+        memset(mChunk, 0, pad);
+        fwrite(mChunk, 1, pad, mFile);
+        size += pad;
+    }
+    mIndex = (uint32_t)(size / THERMO_LOG_CHUNK_SIZE);
+    mRecords = 0;
+    return true;
+}
+
+bool ThermoLogWriter::append(const ThermoFrame& frame)
+{
+    uint8_t* p_record;
+    int i;
+
+    if (mFile == NULL) {
+        return false;
+    }
+    if (mRecords == 0) {
+        put_u32(&mChunk[16], frame.timestamp_ms);
+    }
+    p_record = &mChunk[THERMO_LOG_HEADER + (LOG_RECORD * mRecords)];
+    put_u32(&p_record[0], frame.timestamp_ms);
+    put_u32(&p_record[4], frame.sequence);
+    put_u16(&p_record[8], frame.sensor_id);
+    put_u16(&p_record[10], (uint16_t)frame.ptat);
+    for (i = 0; i < THERMO_FRAME_PIXEL; i++) {
+        put_u16(&p_record[12 + (i * 2)], (uint16_t)frame.pixel[i]);
+    }
+    put_u32(&mChunk[20], frame.timestamp_ms);
+    mRecords++;
+    mStats.frames++;
+
+    if ((THERMO_LOG_HEADER + (LOG_RECORD * (mRecords + 1))) > THERMO_LOG_CHUNK_SIZE) {
+        return write_chunk();
+    }
+    return true;
+}
+
+bool ThermoLogWriter::flush(void)
+{
+    if ((mFile == NULL) || (mRecords == 0)) {
+        return true;
+    }
+    return write_chunk();
+}
+
+void ThermoLogWriter::close(void)
+{
+    if (mFile == NULL) {
+        return;
+    }
+    flush();
+    fclose(mFile);
+    mFile = NULL;
+}
+
+bool ThermoLogWriter::write_chunk(void)
+{
+    uint32_t used = THERMO_LOG_HEADER + (LOG_RECORD * mRecords);
+    bool result;
+
+    memcpy(&mChunk[0], LOG_MAGIC, 4);
+    mChunk[4] = THERMO_LOG_VERSION;
+    mChunk[5] = THERMO_LOG_FRAME;
+    mChunk[6] = THERMO_FRAME_COLS;
+    mChunk[7] = THERMO_FRAME_ROWS;
+    put_u32(&mChunk[8], mIndex);
+    put_u16(&mChunk[12], (uint16_t)mRecords);
+    put_u16(&mChunk[14], LOG_RECORD);
+    memset(&mChunk[24], 0, LOG_CRC_OFFSET - 24);
+    memset(&mChunk[used], 0, THERMO_LOG_CHUNK_SIZE - used);
+    put_u16(&mChunk[LOG_CRC_OFFSET], thermo_log_crc(mChunk));
+
+    result = (fwrite(mChunk, 1, THERMO_LOG_CHUNK_SIZE, mFile) == THERMO_LOG_CHUNK_SIZE);
+    if (result) {
+        mStats.chunks++;
+    } else {
+        mStats.errors++;
+    }
+    mIndex++;
+    mRecords = 0;
+    return result;
+}
+
+ThermoLogReader::ThermoLogReader(uint8_t* p_chunk) :
+    mChunk(p_chunk), mFile(NULL), mRecord(0), mRecords(0), mRecordSize(0), mBadChunks(0)
+{
+    memset(mChunk, 0, THERMO_LOG_HEADER);
+}
+
+bool ThermoLogReader::open(const char* path)
+{
+    close();
+    mFile = fopen(path, "rb");
+    mBadChunks = 0;
+    rewind();
+    return mFile != NULL;
+}
+
+void ThermoLogReader::close(void)
+{
+    if (mFile != NULL) {
+        fclose(mFile);
+        mFile = NULL;
+    }
+}
+
+void ThermoLogReader::rewind(void)
+{
+    if (mFile != NULL) {
+        fseek(mFile, 0, SEEK_SET);
+    }
+    mRecord = 0;
+    mRecords = 0;
+}
+
+bool ThermoLogReader::is_log(const char* path)
+{
+    FILE* p_file = fopen(path, "rb");
+    char magic[4];
+    bool result;
+
+    if (p_file == NULL) {
+        return false;
+    }
+    result = (fread(magic, 1, sizeof(magic), p_file) == sizeof(magic)) && (memcmp(magic, LOG_MAGIC, 4) == 0);
+    fclose(p_file);
+    return result;
+}
+
+bool ThermoLogReader::read_chunk(void)
+{
+    while ((mFile != NULL) && (fread(mChunk, 1, THERMO_LOG_CHUNK_SIZE, mFile) == THERMO_LOG_CHUNK_SIZE)) {
+        int records = get_u16(&mChunk[12]);
+        int size = get_u16(&mChunk[14]);
+
+        if ((memcmp(mChunk, LOG_MAGIC, 4) != 0) || (mChunk[4] != THERMO_LOG_VERSION) || (mChunk[5] != THERMO_LOG_FRAME)
+         || (size != THERMO_LOG_RECORD_SIZE(mChunk[6] * mChunk[7]))
+         || ((THERMO_LOG_HEADER + (records * size)) > THERMO_LOG_CHUNK_SIZE)
+         || (thermo_log_crc(mChunk) != get_u16(&mChunk[LOG_CRC_OFFSET]))) {
+            // padding of a torn chunk or a damaged one
+            if (memcmp(mChunk, LOG_MAGIC, 4) == 0) {
+                mBadChunks++;
+            }
+            continue;
+        }
+        mRecord = 0;
+        mRecords = records;
+        mRecordSize = size;
+        return true;
+    }
+    mRecords = 0;
+    return false;
+}
+
+const uint8_t* ThermoLogReader::next_record(void)
+{
+    while (mRecord >= mRecords) {
+        if (!read_chunk()) {
+            return NULL;
+        }
+    }
+    return &mChunk[THERMO_LOG_HEADER + (mRecordSize * mRecord++)];
+}
+
+bool ThermoLogReader::next(ThermoFrame& frame)
+{
+    const uint8_t* p_record;
+    int i;
+
+    while ((p_record = next_record()) != NULL) {
+        if ((cols() != THERMO_FRAME_COLS) || (rows() != THERMO_FRAME_ROWS)) {
+            continue;
+        }
+        frame.timestamp_ms = get_u32(&p_record[0]);
+        frame.sequence = get_u32(&p_record[4]);
+        frame.sensor_id = get_u16(&p_record[8]);
+        frame.ptat = (int16_t)get_u16(&p_record[10]);
+        for (i = 0; i < THERMO_FRAME_PIXEL; i++) {
+            frame.pixel[i] = (int16_t)get_u16(&p_record[12 + (i * 2)]);
+        }
+        return true;
+    }
+    return false;
+}
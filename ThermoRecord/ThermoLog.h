@@ -0,0 +1,202 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_LOG_H
+#define THERMO_LOG_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "ThermoFrame.h"
+
+/* Frame log: a file of fixed-size chunks, each written once and never
+ * rewritten, all fields little endian:
+ *
+ *   0  magic      "D6TL"
+ *   4  version    THERMO_LOG_VERSION
+ *   5  type       THERMO_LOG_FRAME
+ *   6  cols, rows
+ *   8  chunk      uint32 number of the chunk in the file
+ *  12  records    uint16 records in the chunk
+ *  14  size       uint16 bytes of a record
+ *  16  first_ms   uint32 timestamp of the first record
+ *  20  last_ms    uint32 timestamp of the last record
+ *  24  reserved   6 bytes of 0
+ *  30  crc        CRC-16/CCITT-FALSE of the header before it and the records
+ *  32  records    timestamp_ms uint32, sequence uint32, sensor_id uint16,
+ *                 ptat int16, pixel[rows * cols] int16; 0 up to the chunk end
+ *
+ * A chunk is a multiple of the 512-byte blocks of SD cards and USB drives,
+ * so every write is one aligned block run. The pixels are the sensor answer
+ * without the PEC (a D6T answer is the same int16 values, little endian).
+ */
+#define THERMO_LOG_CHUNK_SIZE   (4096)
+#define THERMO_LOG_HEADER       (32)
+#define THERMO_LOG_VERSION      (1)
+#define THERMO_LOG_FRAME        (1)
+
+/* Bytes of a record of a sensor of pixels */
+#define THERMO_LOG_RECORD_SIZE(pixels)  (12 + ((pixels) * 2))
+
+/** Counters of a ThermoLogWriter */
+struct ThermoLogStats {
+    uint32_t frames;        // frames appended
+    uint32_t chunks;        // chunks written
+    uint32_t errors;        // chunks which could not be written
+};
+
+/** Append-only writer of a frame log
+ *
+ *  Frames are collected in one chunk buffer; a full chunk goes to the file
+ *  in a single unbuffered write. flush() writes a partly filled chunk (the
+ *  rest is padding) and the next frame starts a new chunk, so data on the
+ *  storage is never rewritten.
+ *
+ * Example:
+ * @code
+ *
+ * static uint8_t chunk[THERMO_LOG_CHUNK_SIZE];
+ * ThermoLogWriter log(chunk);
+ *
+ * if (log.open("/storage/d6t.log")) {
+ *     log.append(frame);
+ *     ...
+ *     log.close();
+ * }
+ * @endcode
+ */
+class ThermoLogWriter
+{
+public:
+    /** Create a writer
+     *
+     *  @param p_chunk chunk buffer [THERMO_LOG_CHUNK_SIZE] (must outlive the writer)
+     */
+    ThermoLogWriter(uint8_t* p_chunk);
+
+    ~ThermoLogWriter() { close(); }
+
+    /** Open a log to append to (created if missing)
+     *
+     *  A torn chunk at the end of the file is padded, so the new chunks stay aligned.
+     *  @return true on success, false on failure
+     */
+    bool open(const char* path);
+
+    /** Append a frame, writes the chunk when it is full
+     *
+     *  @return true on success, false if a chunk could not be written
+     */
+    bool append(const ThermoFrame& frame);
+
+    /** Write the partly filled chunk
+     *
+     *  @return true on success, false on failure
+     */
+    bool flush(void);
+
+    /** Flush and close the file */
+    void close(void);
+
+    bool is_open(void) const { return mFile != NULL; }
+    ThermoLogStats stats(void) const { return mStats; }
+
+private:
+    uint8_t* mChunk;
+    FILE* mFile;
+    uint32_t mIndex;        // number of the chunk being filled
+    int mRecords;
+    ThermoLogStats mStats;
+
+    bool write_chunk(void);
+};
+
+/** Reader of a frame log
+ *
+ *  Chunks with a wrong magic or CRC are skipped. next_record() returns the
+ *  records of any sensor size (e.g. for conversion tools), next() the frames
+ *  of the sensor model of the build.
+ */
+class ThermoLogReader
+{
+public:
+    /** Create a reader
+     *
+     *  @param p_chunk chunk buffer [THERMO_LOG_CHUNK_SIZE] (must outlive the reader)
+     */
+    ThermoLogReader(uint8_t* p_chunk);
+
+    ~ThermoLogReader() { close(); }
+
+    /** Open a log
+     *
+     *  @return true on success, false on failure
+     */
+    bool open(const char* path);
+
+    void close(void);
+
+    /** Start again at the first chunk */
+    void rewind(void);
+
+    /** Next record of any sensor size
+     *
+     *  @return record (valid until the next call), NULL at the end of the log
+     */
+    const uint8_t* next_record(void);
+
+    /** Next frame of the sensor model of the build, other sizes are skipped
+     *
+     *  @return true on success, false at the end of the log
+     */
+    bool next(ThermoFrame& frame);
+
+    /** Grid of the record returned last */
+    int cols(void) const { return mChunk[6]; }
+    int rows(void) const { return mChunk[7]; }
+
+    /** Chunks skipped for a wrong magic or CRC */
+    uint32_t bad_chunks(void) const { return mBadChunks; }
+
+    /** Check for a log file without opening it as one */
+    static bool is_log(const char* path);
+
+private:
+    uint8_t* mChunk;
+    FILE* mFile;
+    int mRecord;            // next record of the chunk
+    int mRecords;           // records of the chunk, 0: no chunk
+    int mRecordSize;
+    uint32_t mBadChunks;
+
+    bool read_chunk(void);
+};
+
+/** CRC of a chunk, the CRC field itself excluded
+ *
+ *  @param p_chunk chunk with its records field set
+ */
+uint16_t thermo_log_crc(const uint8_t* p_chunk);
+
+#endif
@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ThermoRecorder.h"
+
+#define FLG_START       (0x00000001)
+#define FLG_STOP        (0x00000002)
+#define FLG_OPENED      (0x00000004)
+#define FLG_FAILED      (0x00000008)
+#define FLG_CLOSED      (0x00000010)
+
+ThermoRecorder::ThermoRecorder(const ThermoSensorManager& sensors, uint16_t id, ThermoLogWriter& log, uint32_t poll_ms,
+                               osPriority priority) :
+    mSensors(sensors), mId(id), mLog(log), mPollMs(poll_ms), mPath(NULL), mCursor(0), mLastSeq(0), mLost(0),
+    mThread(priority, 4096)     // FAT file system and SD/USB driver calls
+{
+}
+
+void ThermoRecorder::start(void)
+{
+    mThread.start(callback(this, &ThermoRecorder::task));
+}
+
+bool ThermoRecorder::record(const char* path)
+{
+    mPath = path;
+    mFlags.set(FLG_START);
+    return (mFlags.wait_any(FLG_OPENED | FLG_FAILED) & FLG_OPENED) != 0;
+}
+
+void ThermoRecorder::stop(void)
+{
+    mFlags.set(FLG_STOP);
+    mFlags.wait_any(FLG_CLOSED);
+}
+
+ThermoRecorderStats ThermoRecorder::stats(void) const
+{
+    ThermoLogStats log = mLog.stats();
+    ThermoRecorderStats stats;
+
+    stats.frames = log.frames;
+    stats.lost   = mLost;
+    stats.chunks = log.chunks;
+    stats.errors = log.errors;
+    return stats;
+}
+
+void ThermoRecorder::task(void)
+{
+    uint32_t flags;
+
+    while (true) {
+        flags = mFlags.wait_any(FLG_START | FLG_STOP, mLog.is_open() ? mPollMs : osWaitForever);
+        if ((flags & osFlagsError) == 0) {
+            if ((flags & FLG_STOP) != 0) {
+                mLog.close();
+                mFlags.set(FLG_CLOSED);
+            }
+            if ((flags & FLG_START) != 0) {
+                // frames from now on only
+                while (mSensors.read_raw(mId, mCursor, mFrame)) {
+                    mLastSeq = mFrame.sequence;
+                }
+                mFlags.set(mLog.open(mPath) ? FLG_OPENED : FLG_FAILED);
+            }
+        }
+
+        while (mLog.is_open() && mSensors.read_raw(mId, mCursor, mFrame)) {
+            if ((mLastSeq != 0) && (mFrame.sequence > (mLastSeq + 1))) {
+                mLost += mFrame.sequence - (mLastSeq + 1);
+            }
+            mLastSeq = mFrame.sequence;
+            mLog.append(mFrame);
+        }
+    }
+}
@@ -0,0 +1,112 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_RECORDER_H
+#define THERMO_RECORDER_H
+
+#include "mbed.h"
+#include "ThermoLog.h"
+#include "ThermoSensorManager.h"
+
+/** Counters of a ThermoRecorder */
+struct ThermoRecorderStats {
+    uint32_t frames;        // frames appended to the log
+    uint32_t lost;          // frames overwritten in the ring before being recorded
+    uint32_t chunks;        // chunks written
+    uint32_t errors;        // chunks which could not be written
+};
+
+/** Recorder of the frames of one sensor
+ *
+ *  A thread of low priority follows the frame ring of the sensor with its
+ *  own cursor and appends every reading, as it was before the filter
+ *  (ThermoSensorManager::read_raw), to a ThermoLogWriter, so the storage
+ *  never stalls the acquisition or the render loop. Frames the storage was
+ *  too slow for are counted as lost (the ring keeps a few periods).
+ *
+ *  The log is opened and closed by the recorder thread; stop() waits until
+ *  the last chunk is on the storage, so the medium may be removed after it.
+ *
+ * Example:
+ * @code
+ *
+ * static uint8_t chunk[THERMO_LOG_CHUNK_SIZE];
+ * ThermoLogWriter log(chunk);
+ * ThermoRecorder recorder(sensors, 0, log, 100);
+ *
+ * recorder.start();
+ * recorder.record("/storage/d6t.log");
+ * ...
+ * recorder.stop();
+ * @endcode
+ */
+class ThermoRecorder
+{
+public:
+    /** Create a recorder
+     *
+     *  @param sensors  frame source
+     *  @param id       sensor ID to record
+     *  @param log      log writer, only used by the recorder thread
+     *  @param poll_ms  interval of checking for new frames [ms]
+     *  @param priority priority of the recorder thread
+     */
+    ThermoRecorder(const ThermoSensorManager& sensors, uint16_t id, ThermoLogWriter& log, uint32_t poll_ms,
+                   osPriority priority = osPriorityBelowNormal);
+
+    /** Start the recorder thread (idle until record) */
+    void start(void);
+
+    /** Start recording to a log, appended if it exists
+     *
+     *  @param path log file (must stay valid while recording)
+     *  @return true on success, false if the log could not be opened
+     */
+    bool record(const char* path);
+
+    /** Stop recording, waits until the log is flushed and closed */
+    void stop(void);
+
+    bool recording(void) const { return mLog.is_open(); }
+
+    ThermoRecorderStats stats(void) const;
+
+private:
+    const ThermoSensorManager& mSensors;
+    uint16_t mId;
+    ThermoLogWriter& mLog;
+    uint32_t mPollMs;
+    const char* mPath;
+    uint32_t mCursor;
+    uint32_t mLastSeq;
+    uint32_t mLost;
+    ThermoFrame mFrame;
+    Thread mThread;
+    EventFlags mFlags;
+
+    void task(void);
+};
+
+#endif
@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_REPLAY_DEVICE_H
+#define THERMO_REPLAY_DEVICE_H
+
+#include <string.h>
+#include "mbed.h"
+#include "ThermoLog.h"
+#include "ThermoSensorDevice.h"
+
+/* Longest recorded interval waited for [ms], a longer one (a pause of the recording) restarts the clock */
+#define THERMO_REPLAY_MAX_GAP_MS    (1000)
+
+/* Stack of an acquisition thread with a replay device [byte], as ThermoRecorder for the FAT file system and SD/USB driver calls */
+#define THERMO_REPLAY_STACK         (4096)
+
+/** Frame log as a ThermoSensorDevice
+ *
+ *  Each read_async returns the next recorded frame and calls the callback
+ *  at once, so the rest of the pipeline runs on the recorded data. Paced,
+ *  a frame is returned at its recorded time (timestamp_ms) relative to
+ *  the first one, so the acquisition period should be shorter than the
+ *  recorded interval; otherwise the frames follow at the acquisition
+ *  period, as fast as the pipeline goes with a short one. The log starts
+ *  again at its end.
+ *
+ *  setup() opens the log and read_async() reads it, both on the
+ *  acquisition thread: build that ThermoAcquisition with a stack of at
+ *  least THERMO_REPLAY_STACK.
+ *
+ * Example:
+ * @code
+ *
+ * static uint8_t chunk[THERMO_LOG_CHUNK_SIZE];
+ * ThermoLogReader log(chunk);
+ * ThermoReplayDevice replay(log, "/storage/d6t.log");
+ * ThermoAcquisition bus(100, osPriorityAboveNormal, THERMO_REPLAY_STACK);
+ *
+ * bus.add(replay, 0);
+ * @endcode
+ */
+class ThermoReplayDevice : public ThermoSensorDevice
+{
+public:
+    /** Create a device
+     *
+     *  @param log   log reader, only used by the acquisition thread
+     *  @param path  log file (must outlive the device)
+     *  @param loop  true: start again at the end of the log, false: fail at the end
+     *  @param paced true: at the recorded timestamps, false: at the acquisition period
+     */
+    ThermoReplayDevice(ThermoLogReader& log, const char* path, bool loop = true, bool paced = true) :
+        mLog(log), mPath(path), mLoop(loop), mPaced(paced), mStarted(false), mLastStamp(0), mDueMs(0)
+    {
+    }
+
+    virtual bool setup(void)
+    {
+        mStarted = false;
+        return mLog.open(mPath);
+    }
+
+    virtual bool read_async(int16_t* ptat, int16_t* buf, Callback<void(bool)> callback)
+    {
+        if (!mLog.next(mFrame)) {
+            if (!mLoop) {
+                return false;
+            }
+            mLog.rewind();
+            if (!mLog.next(mFrame)) {
+                return false;
+            }
+        }
+        if (mPaced) {
+            pace();
+        }
+        *ptat = mFrame.ptat;
+        memcpy(buf, mFrame.pixel, sizeof(mFrame.pixel));
+        callback(true);
+        return true;
+    }
+
+    virtual void abort_async(void)
+    {
+    }
+
+private:
+    ThermoLogReader& mLog;
+    const char* mPath;
+    bool mLoop;
+    bool mPaced;
+    ThermoFrame mFrame;
+    bool mStarted;
+    uint32_t mLastStamp;    // timestamp of the frame returned last
+    uint64_t mDueMs;        // time it was due
+
+    void pace(void)
+    {
+        uint64_t now = Kernel::get_ms_count();
+        uint32_t interval = mFrame.timestamp_ms - mLastStamp;
+
+        // the first frame, the log rewound (negative interval) or a pause restart the clock
+        if (!mStarted || (interval > THERMO_REPLAY_MAX_GAP_MS)) {
+            mDueMs = now;
+        } else {
+            mDueMs += interval;
+            if (mDueMs > now) {
+                ThisThread::sleep_until(mDueMs);
+            } else {
+                mDueMs = now;   // behind: no burst to catch up
+            }
+        }
+        mStarted = true;
+        mLastStamp = mFrame.timestamp_ms;
+    }
+};
+
+#endif
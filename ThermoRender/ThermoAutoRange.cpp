@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ThermoAutoRange.h"
+#include "ThermoPalette.h"
+
+ThermoAutoRange::ThermoAutoRange(int strength, int min_span, int step) :
+    mCount(0), mLowEma(0), mHighEma(0), mMin(0), mMax(0)
+{
+    mStrength = (strength < 0) ? 0 : ((strength > 8) ? 8 : strength);
+    mStep     = (step < 1) ? 1 : step;
+    mMinSpan  = (min_span < mStep) ? mStep : ((min_span > THERMO_PALETTE_RAW_MAX) ? THERMO_PALETTE_RAW_MAX : min_span);
+    reset_stats();
+}
+
+/* largest multiple of the step at or below data */
+int ThermoAutoRange::step_below(int data) const
+{
+    int rest = data % mStep;
+
+    return (rest < 0) ? (data - rest - mStep) : (data - rest);
+}
+
+/* smallest multiple of the step at or above data */
+int ThermoAutoRange::step_above(int data) const
+{
+    int below = step_below(data);
+
+    return (below == data) ? data : (below + mStep);
+}
+
+bool ThermoAutoRange::update(const ThermoFrameStats& stats)
+{
+    int low = stats.low;
+    int high = stats.high;
+    int min = mMin;
+    int max = mMax;
+
+    if ((high - low) < mMinSpan) {
+        low  = ((low + high) / 2) - (mMinSpan / 2);
+        high = low + mMinSpan;
+    }
+
+    if (mCount == 0) {
+        mLowEma  = (int32_t)low << THERMO_AUTO_RANGE_FRAC;
+        mHighEma = (int32_t)high << THERMO_AUTO_RANGE_FRAC;
+    } else {
+        mLowEma  += (((int32_t)low << THERMO_AUTO_RANGE_FRAC) - mLowEma) >> mStrength;
+        mHighEma += (((int32_t)high << THERMO_AUTO_RANGE_FRAC) - mHighEma) >> mStrength;
+    }
+    low  = (int)(mLowEma >> THERMO_AUTO_RANGE_FRAC);
+    high = (int)((mHighEma + (1 << THERMO_AUTO_RANGE_FRAC) - 1) >> THERMO_AUTO_RANGE_FRAC);
+
+    // out at once, in with a margin of two steps so noise does not toggle an edge
+    if ((mCount == 0) || (low < min) || (low >= (min + (2 * mStep)))) {
+        min = step_below(low);
+    }
+    if ((mCount == 0) || (high > max) || (high <= (max - (2 * mStep)))) {
+        max = step_above(high);
+    }
+    if ((max - min) > THERMO_PALETTE_RAW_MAX) {
+        min = max - step_below(THERMO_PALETTE_RAW_MAX);
+    }
+    mCount++;
+
+    mStats.frames++;
+    if ((min == mMin) && (max == mMax)) {
+        return false;
+    }
+    mMin = min;
+    mMax = max;
+    mStats.changes++;
+    return true;
+}
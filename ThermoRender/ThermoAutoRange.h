@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_AUTO_RANGE_H
+#define THERMO_AUTO_RANGE_H
+
+#include <stdint.h>
+#include "ThermoFrame.h"
+
+/* Fraction bits of the smoothed range edges */
+#define THERMO_AUTO_RANGE_FRAC      (4)
+
+/* Default step of the range edges (The integer which set a centigrade to 10 times) */
+#define THERMO_AUTO_RANGE_STEP      (5)
+
+/** Counters of a ThermoAutoRange */
+struct ThermoAutoRangeStats {
+    uint32_t frames;            // frames given to update
+    uint32_t changes;           // frames which moved the range
+};
+
+/** Color range which follows the temperatures of the frames (auto-gain)
+ *
+ *  The range goes from the low to the high percentile of each frame
+ *  (ThermoFrame::stats), widened to a minimum span around its center.
+ *  Both edges are smoothed with an EMA and then only move in whole steps:
+ *  an edge moves out as soon as the smoothed value leaves the range and
+ *  moves in when it is two steps inside. Frames of a steady scene keep the
+ *  same min and max, so the palette and the incremental redraw stay valid.
+ *
+ * Example:
+ * @code
+ *
+ * static ThermoAutoRange auto_range(3, 20);    // 1/8 weight, at least 2.0 degC
+ *
+ * if (auto_range.update(frame.stats)) {
+ *     palette.set_raw_range(auto_range.max() - auto_range.min());
+ * }
+ * kernel.begin(&frame.pixel[0], 4, 4, auto_range.min(), auto_range.max(), &resampler160x120);
+ * @endcode
+ */
+class ThermoAutoRange
+{
+public:
+    /** Create a range
+     *
+     *  @param strength weight shift of a new frame (0-8, 0: no smoothing)
+     *  @param min_span smallest max - min (The integer which set a centigrade to 10 times)
+     *  @param step     step of the edges (The integer which set a centigrade to 10 times)
+     */
+    ThermoAutoRange(int strength, int min_span, int step = THERMO_AUTO_RANGE_STEP);
+
+    /** Follow the statistics of a frame
+     *
+     *  @param stats statistics of the frame, low and high are used
+     *  @return true if min or max changed
+     */
+    bool update(const ThermoFrameStats& stats);
+
+    /** Forget the history, the next frame sets the range as it is */
+    void reset(void) { mCount = 0; }
+
+    int min(void) const { return mMin; }
+    int max(void) const { return mMax; }
+
+    ThermoAutoRangeStats stats(void) const { return mStats; }
+    void reset_stats(void) { mStats.frames = 0; mStats.changes = 0; }
+
+private:
+    int mStrength;
+    int mMinSpan;
+    int mStep;
+    uint32_t mCount;            // frames since reset
+    int32_t mLowEma;            // smoothed edges with fraction bits
+    int32_t mHighEma;
+    int mMin;
+    int mMax;
+    ThermoAutoRangeStats mStats;
+
+    int step_below(int data) const;
+    int step_above(int data) const;
+};
+
+#endif
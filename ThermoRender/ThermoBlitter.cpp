@@ -0,0 +1,300 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <string.h>
+#include "ThermoBlitter.h"
+
+/* 32-bit access to the 16-bit surface */
+typedef uint32_t __attribute__((__may_alias__)) pixel_pair_t;
+
+static void fill_span(uint16_t* p_dst, uint16_t color, int count)
+{
+    uint32_t pair = ((uint32_t)color << 16) | color;
+    pixel_pair_t* p_pair;
+
+    if ((((uintptr_t)p_dst & 0x3) != 0) && (count > 0)) {
+        *p_dst++ = color;
+        count--;
+    }
+
+    p_pair = (pixel_pair_t*)p_dst;
+    while (count >= 8) {
+        p_pair[0] = pair;
+        p_pair[1] = pair;
+        p_pair[2] = pair;
+        p_pair[3] = pair;
+        p_pair += 4;
+        count -= 8;
+    }
+    while (count >= 2) {
+        *p_pair++ = pair;
+        count -= 2;
+    }
+
+    if (count > 0) {
+        *(uint16_t*)p_pair = color;
+    }
+}
+
+ThermoBlitter::ThermoBlitter(uint8_t* p_buf, int width, int height, int stride) :
+    mBuf(p_buf), mWidth(width), mHeight(height), mStride(stride),
+    mTileCount(0), mTileHw(0), mTileVw(0), mLayoutChecked(false), mRedrawAll(true), mRedrawFrame(false), mDirtyCount(0)
+{
+    memset(mOverlay, 0, sizeof(mOverlay));
+    memset(&mStats, 0, sizeof(mStats));
+}
+
+void ThermoBlitter::set_overlay(int x, int y, int w, int h, int index)
+{
+    if ((index < 0) || (index >= THERMO_BLITTER_MAX_OVERLAY)) {
+        return;
+    }
+    mOverlay[index].x = x;
+    mOverlay[index].y = y;
+    mOverlay[index].w = w;
+    mOverlay[index].h = h;
+}
+
+void ThermoBlitter::begin_frame(void)
+{
+    mDirtyCount = 0;
+    mLayoutChecked = false;
+    mRedrawFrame = false;
+    memset(&mStats, 0, sizeof(mStats));
+}
+
+void ThermoBlitter::fill(uint16_t color)
+{
+    fill_rect(color, 0, 0, mWidth, mHeight);
+    mRedrawAll = true;
+}
+
+void ThermoBlitter::fill_rect(uint16_t color, int x, int y, int w, int h)
+{
+    if (x < 0) {
+        w += x;
+        x = 0;
+    }
+    if (y < 0) {
+        h += y;
+        y = 0;
+    }
+    if ((x + w) > mWidth) {
+        w = mWidth - x;
+    }
+    if ((y + h) > mHeight) {
+        h = mHeight - y;
+    }
+    if ((w <= 0) || (h <= 0)) {
+        return;
+    }
+
+    fill_span(pixel(x, y), color, w);
+    copy_rows(y, x, w, y + 1, h - 1);
+    mark_dirty(x, y, w, h);
+}
+
+void ThermoBlitter::draw_tile_row(int row, const uint16_t* p_color, int count, int tile_hw, int tile_vw)
+{
+    draw_tile_span(row, p_color, count, tile_hw, tile_vw, 0, count);
+}
+
+void ThermoBlitter::draw_tile_span(int row, const uint16_t* p_color, int count, int tile_hw, int tile_vw, int first, int last)
+{
+    int y = row * tile_vw;
+    int h = tile_vw;
+    int x0 = mWidth;
+    int x1 = 0;
+    bool redraw;
+    int i;
+
+    redraw = check_layout(count, tile_hw, tile_vw);
+
+    if ((y + h) > mHeight) {
+        h = mHeight - y;
+    }
+    if ((count * tile_hw) > mWidth) {
+        count = (mWidth + tile_hw - 1) / tile_hw;
+    }
+    if (first < 0) {
+        first = 0;
+    }
+    if (last > count) {
+        last = count;
+    }
+    if ((h <= 0) || (first >= last)) {
+        return;
+    }
+
+    // write the first pixel row of the changed tiles, then replicate the span
+    for (i = first; i < last; i++) {
+        int x = i * tile_hw;
+        int w = tile_hw;
+        uint16_t* p_dst = pixel(x, y);
+
+        if ((x + w) > mWidth) {
+            w = mWidth - x;
+        }
+        if ((!redraw) && (*p_dst == p_color[i]) && (!on_overlay(x, y, w, h))) {
+            mStats.tiles_skipped++;
+            continue;
+        }
+
+        fill_span(p_dst, p_color[i], w);
+        mStats.tiles_drawn++;
+        if (x < x0) {
+            x0 = x;
+        }
+        x1 = x + w;
+    }
+
+    if (x0 < x1) {
+        copy_rows(y, x0, x1 - x0, y + 1, h - 1);
+        mark_dirty(x0, y, x1 - x0, h);
+    }
+}
+
+void ThermoBlitter::mark_dirty(int x, int y, int w, int h)
+{
+    ThermoRect* p_last;
+
+    if ((w <= 0) || (h <= 0)) {
+        return;
+    }
+
+    if (mDirtyCount > 0) {
+        // merge with the rectangle just above
+        p_last = &mDirty[mDirtyCount - 1];
+        if ((p_last->x == x) && (p_last->w == w) && ((p_last->y + p_last->h) == y)) {
+            p_last->h += h;
+            return;
+        }
+    }
+
+    if (mDirtyCount < THERMO_BLITTER_MAX_DIRTY) {
+        p_last = &mDirty[mDirtyCount++];
+        p_last->x = x;
+        p_last->y = y;
+        p_last->w = w;
+        p_last->h = h;
+        return;
+    }
+
+    // list is full: grow the last rectangle to cover both
+    p_last = &mDirty[mDirtyCount - 1];
+    int left   = (x < p_last->x) ? x : p_last->x;
+    int top    = (y < p_last->y) ? y : p_last->y;
+    int right  = ((x + w) > (p_last->x + p_last->w)) ? (x + w) : (p_last->x + p_last->w);
+    int bottom = ((y + h) > (p_last->y + p_last->h)) ? (y + h) : (p_last->y + p_last->h);
+    p_last->x = left;
+    p_last->y = top;
+    p_last->w = right - left;
+    p_last->h = bottom - top;
+}
+
+uint32_t ThermoBlitter::clean_dirty(ThermoHalCache& cache)
+{
+    uint32_t total = 0;
+    int i;
+    int j;
+
+    for (i = 0; i < mDirtyCount; i++) {
+        const ThermoRect& rect = mDirty[i];
+        int rows = 1;
+        int span = rect.w * (int)sizeof(uint16_t);
+
+        if ((rect.x == 0) && (rect.w == mWidth)) {
+            // whole rows are one contiguous range
+            span = mStride * (rect.h - 1) + span;
+        } else {
+            rows = rect.h;
+        }
+
+        for (j = 0; j < rows; j++) {
+            uintptr_t start = (uintptr_t)pixel(rect.x, rect.y + j);
+            uintptr_t end   = start + span;
+
+            start &= ~(uintptr_t)(THERMO_CACHE_LINE - 1);
+            end    = (end + THERMO_CACHE_LINE - 1) & ~(uintptr_t)(THERMO_CACHE_LINE - 1);
+            cache.clean((void*)start, (uint32_t)(end - start));
+            total += (uint32_t)(end - start);
+        }
+    }
+
+    mDirtyCount = 0;
+    mStats.bytes_cleaned += total;
+    return total;
+}
+
+void ThermoBlitter::copy_rows(int src_y, int x, int w, int y, int h)
+{
+    const uint16_t* p_src = pixel(x, src_y);
+    size_t len = (size_t)w * sizeof(uint16_t);
+    int i;
+
+    for (i = 0; i < h; i++) {
+        memcpy(pixel(x, y + i), p_src, len);
+    }
+}
+
+bool ThermoBlitter::redraw_pending(int count, int tile_hw, int tile_vw) const
+{
+    return mRedrawAll || (count != mTileCount) || (tile_hw != mTileHw) || (tile_vw != mTileVw);
+}
+
+bool ThermoBlitter::check_layout(int count, int tile_hw, int tile_vw)
+{
+    bool changed = (count != mTileCount) || (tile_hw != mTileHw) || (tile_vw != mTileVw);
+
+    if ((!mLayoutChecked) || changed) {
+        if (changed) {
+            mTileCount = count;
+            mTileHw = tile_hw;
+            mTileVw = tile_vw;
+            mRedrawAll = true;
+        }
+        if (mRedrawAll) {
+            mRedrawFrame = true;
+            mRedrawAll = false;
+        }
+        mLayoutChecked = true;
+    }
+    return mRedrawFrame;
+}
+
+bool ThermoBlitter::on_overlay(int x, int y, int w, int h) const
+{
+    int i;
+
+    for (i = 0; i < THERMO_BLITTER_MAX_OVERLAY; i++) {
+        const ThermoRect& overlay = mOverlay[i];
+
+        if ((x < (overlay.x + overlay.w)) && (overlay.x < (x + w))
+         && (y < (overlay.y + overlay.h)) && (overlay.y < (y + h))) {
+            return true;
+        }
+    }
+    return false;
+}
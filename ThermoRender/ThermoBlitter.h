@@ -0,0 +1,189 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_BLITTER_H
+#define THERMO_BLITTER_H
+
+#include <stdint.h>
+#include "ThermoHalCache.h"
+
+/* Data cache line size of the cache maintenance */
+#ifndef THERMO_CACHE_LINE
+#define THERMO_CACHE_LINE       (32)
+#endif
+
+/* Number of dirty rectangles kept per frame (more are merged) */
+#define THERMO_BLITTER_MAX_DIRTY    (32)
+
+/* Number of overlay areas (title, stats) */
+#define THERMO_BLITTER_MAX_OVERLAY  (2)
+
+/** Rectangle on a surface */
+struct ThermoRect {
+    int x;
+    int y;
+    int w;
+    int h;
+};
+
+/** Per frame counters of a surface */
+struct ThermoBlitterStats {
+    uint32_t tiles_drawn;       // tiles written to the surface
+    uint32_t tiles_skipped;     // tiles left as they were
+    uint32_t bytes_cleaned;     // bytes passed to the cache clean
+};
+
+/** ARGB4444 surface writer of the thermograph
+ *
+ *  Fills whole row spans with 32-bit stores and copies a finished pixel row
+ *  to the remaining rows of the tile with memcpy, instead of clipping and
+ *  filling every tile separately.
+ *
+ *  A tile is skipped when the surface already shows its color, so only the
+ *  tiles which changed since this surface was last drawn are written. The
+ *  written areas are kept as dirty rectangles for the cache clean.
+ *
+ * Example:
+ * @code
+ *
+ * ThermoBlitter blitter(fbuf, 640, 480, ASCII_BUFFER_STRIDE);
+ *
+ * blitter.set_overlay(0, 0, 30, 20);
+ * blitter.begin_frame();
+ * blitter.draw_tile_row(y, &color_row[0], 160, 4, 4);
+ * blitter.fill_rect(0xFFFF, 0, 0, 30, 20);
+ * blitter.clean_dirty(cache);     // ThermoMbedCache
+ * @endcode
+ */
+class ThermoBlitter
+{
+public:
+    /** Create a writer of a surface
+     *
+     *  @param p_buf  surface (2 bytes per pixel)
+     *  @param width  surface width
+     *  @param height surface height
+     *  @param stride bytes per surface row
+     */
+    ThermoBlitter(uint8_t* p_buf, int width, int height, int stride);
+
+    uint8_t* buffer(void) const { return mBuf; }
+    int width(void) const { return mWidth; }
+    int height(void) const { return mHeight; }
+    int stride(void) const { return mStride; }
+
+    /** Set an area which is drawn over the tiles every frame (e.g. the title)
+     *
+     *  Tiles overlapping the area are always redrawn.
+     *  @param index overlay number (less than THERMO_BLITTER_MAX_OVERLAY)
+     */
+    void set_overlay(int x, int y, int w, int h, int index = 0);
+
+    /** Start a frame: clear the dirty rectangles and the counters */
+    void begin_frame(void);
+
+    /** Mark an area as changed by another writer (e.g. AsciiFont) */
+    void mark_dirty(int x, int y, int w, int h);
+
+    /** Clean the data cache of the dirty rectangles
+     *
+     *  @param cache data cache of the surface
+     *  @return number of bytes cleaned (whole cache lines)
+     */
+    uint32_t clean_dirty(ThermoHalCache& cache);
+
+    /** Counters of the current frame */
+    const ThermoBlitterStats& stats(void) const { return mStats; }
+
+    /** Fill the whole surface, the next frame redraws every tile
+     *
+     *  @param color ARGB4444 pixel color
+     */
+    void fill(uint16_t color);
+
+    /** Fill a rectangle (clipped to the surface)
+     *
+     *  @param color ARGB4444 pixel color
+     *  @param x     left position
+     *  @param y     top position
+     *  @param w     width
+     *  @param h     height
+     */
+    void fill_rect(uint16_t color, int x, int y, int w, int h);
+
+    /** Draw one row of tiles (clipped to the surface)
+     *
+     *  Unchanged tiles are skipped unless the tile layout changed.
+     *
+     *  @param row     tile row number (top of the row is row * tile_vw)
+     *  @param p_color ARGB4444 color of each tile [count]
+     *  @param count   number of tiles in the row
+     *  @param tile_hw tile width pixel size
+     *  @param tile_vw tile height pixel size
+     */
+    void draw_tile_row(int row, const uint16_t* p_color, int count, int tile_hw, int tile_vw);
+
+    /** Draw tiles first to last - 1 of a row of tiles (see ThermoRedraw)
+     *
+     *  @param row     tile row number (top of the row is row * tile_vw)
+     *  @param p_color ARGB4444 color of each tile [count], only first to last - 1 are read
+     *  @param count   number of tiles in the row (the layout)
+     *  @param tile_hw tile width pixel size
+     *  @param tile_vw tile height pixel size
+     *  @param first   first tile drawn
+     *  @param last    tile after the last one drawn
+     */
+    void draw_tile_span(int row, const uint16_t* p_color, int count, int tile_hw, int tile_vw, int first, int last);
+
+    /** True if the next frame of this layout redraws every tile (layout change or fill),
+     *  then drawing only a part of the tiles would leave the rest stale */
+    bool redraw_pending(int count, int tile_hw, int tile_vw) const;
+
+private:
+    uint8_t* mBuf;
+    int mWidth;
+    int mHeight;
+    int mStride;
+
+    // tile layout shown on the surface
+    int mTileCount;
+    int mTileHw;
+    int mTileVw;
+    bool mLayoutChecked;
+    bool mRedrawAll;        // next frame redraws every tile
+    bool mRedrawFrame;      // this frame redraws every tile
+
+    ThermoRect mOverlay[THERMO_BLITTER_MAX_OVERLAY];
+    ThermoRect mDirty[THERMO_BLITTER_MAX_DIRTY];
+    int mDirtyCount;
+    ThermoBlitterStats mStats;
+
+    uint16_t* pixel(int x, int y) const { return (uint16_t*)(mBuf + (mStride * y)) + x; }
+    void copy_rows(int src_y, int x, int w, int y, int h);
+    bool check_layout(int count, int tile_hw, int tile_vw);
+    bool on_overlay(int x, int y, int w, int h) const;
+};
+
+#endif
@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_FIXED_H
+#define THERMO_FIXED_H
+
+#include <stdint.h>
+
+/* Normalized thermal data is held as unsigned Q15: 0.0 = 0x0000, 1.0 = 0x8000 */
+#define THERMO_Q15_SHIFT    (15)
+#define THERMO_Q15_ONE      (1 << THERMO_Q15_SHIFT)
+#define THERMO_Q15_HALF     (1 << (THERMO_Q15_SHIFT - 1))
+
+/** Normalize a temperature to Q15 in the range of 0.0-1.0
+ *
+ *  Fixed-point counterpart of normalize0to1(), the value outside min, max is saturated.
+ *  @param data input temperature (The integer which set a centigrade to 10 times)
+ *  @param min  smallest threshold temperature value
+ *  @param max  highest threshold temperature value
+ *  @return normalized data (0 - THERMO_Q15_ONE)
+ */
+static inline uint16_t thermo_normalize_q15(int16_t data, int min, int max)
+{
+    if (data <= min) {
+        return 0;
+    }
+    if (max <= data) {
+        return THERMO_Q15_ONE;
+    }
+    return (uint16_t)(((uint32_t)(data - min) << THERMO_Q15_SHIFT) / (uint32_t)(max - min));
+}
+
+/** Linear interpolation between two Q15 samples
+ *
+ *  @param a      sample at weight 0
+ *  @param b      sample at weight THERMO_Q15_ONE
+ *  @param weight Q15 weight of b
+ *  @return interpolated sample, rounded to nearest
+ */
+static inline uint16_t thermo_lerp_q15(uint16_t a, uint16_t b, uint16_t weight)
+{
+    return (uint16_t)(a + ((((int32_t)b - (int32_t)a) * weight + THERMO_Q15_HALF) >> THERMO_Q15_SHIFT));
+}
+
+/** 8-bit index (0 - 255) of a Q15 normalized value, rounded to nearest
+ *
+ *  The index grid is the input of 8-bit image libraries (e.g. a DRP resize).
+ */
+static inline uint8_t thermo_index_q15(uint16_t data)
+{
+    return (uint8_t)(((uint32_t)data * 255u + THERMO_Q15_HALF) >> THERMO_Q15_SHIFT);
+}
+
+/** Q15 normalized value of an 8-bit index */
+static inline uint16_t thermo_q15_index(uint8_t index)
+{
+    return (uint16_t)((((uint32_t)index << THERMO_Q15_SHIFT) + 127u) / 255u);
+}
+
+#endif
@@ -0,0 +1,126 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <string.h>
+#include "ThermoFusion.h"
+
+static inline uint8_t clamp_u8(int value)
+{
+    return (uint8_t)((value < 0) ? 0 : ((value > 255) ? 255 : value));
+}
+
+/* camera channel under a 4-bit thermograph channel with a 4-bit alpha */
+static inline uint8_t blend(uint8_t camera, int thermo, int alpha)
+{
+    return (uint8_t)(((camera * (15 - alpha)) + (thermo * 17 * alpha) + 7) / 15);
+}
+
+static inline void put_le16(uint8_t* p_buf, uint32_t value)
+{
+    p_buf[0] = (uint8_t)value;
+    p_buf[1] = (uint8_t)(value >> 8);
+}
+
+static inline void put_le32(uint8_t* p_buf, uint32_t value)
+{
+    put_le16(p_buf, value);
+    put_le16(p_buf + 2, value >> 16);
+}
+
+ThermoFusion::ThermoFusion(const ThermoRegistration& registration) : mRegistration(registration)
+{
+}
+
+void ThermoFusion::fuse_row(const uint8_t* p_yuv, const uint16_t* p_colors, int y, int step, uint8_t* p_bgr) const
+{
+    const uint16_t* p_map = mRegistration.map_row(y);
+    int width = out_width(step);
+    int ox;
+
+    for (ox = 0; ox < width; ox++) {
+        int x = ox * step;
+        const uint8_t* p_pair = &p_yuv[(x & ~1) * 2];
+        int luma = p_yuv[x * 2];
+        int cb = p_pair[1] - 128;
+        int cr = p_pair[3] - 128;
+        uint8_t red   = clamp_u8(luma + ((359 * cr) >> 8));
+        uint8_t green = clamp_u8(luma - (((88 * cb) + (183 * cr)) >> 8));
+        uint8_t blue  = clamp_u8(luma + ((454 * cb) >> 8));
+        uint16_t index = p_map[x / THERMO_REG_BLOCK];
+
+        if (index != THERMO_REG_OUTSIDE) {
+            // ARGB4444 in the order of conv_normalize_to_color: G B A R
+            uint16_t color = p_colors[index];
+            int alpha = (color >> 4) & 0x0F;
+
+            green = blend(green, (color >> 12) & 0x0F, alpha);
+            blue  = blend(blue, (color >> 8) & 0x0F, alpha);
+            red   = blend(red, color & 0x0F, alpha);
+        }
+        p_bgr[0] = blue;
+        p_bgr[1] = green;
+        p_bgr[2] = red;
+        p_bgr += 3;
+    }
+}
+
+bool ThermoFusion::write_bmp(const uint8_t* p_yuv, int yuv_stride, const uint16_t* p_colors, int step,
+                             uint8_t* p_row, ThermoWriteFunc write, void* p_context) const
+{
+    uint8_t header[THERMO_BMP_HEADER_SIZE];
+    int width = out_width(step);
+    int height = out_height(step);
+    uint32_t row_size = THERMO_BMP_ROW_SIZE(width);
+    int oy;
+
+    memset(header, 0, sizeof(header));
+    header[0] = 'B';
+    header[1] = 'M';
+    put_le32(&header[2], THERMO_BMP_HEADER_SIZE + (row_size * height));
+    put_le32(&header[10], THERMO_BMP_HEADER_SIZE);
+    put_le32(&header[14], 40);
+    put_le32(&header[18], width);
+    put_le32(&header[22], height);
+    put_le16(&header[26], 1);
+    put_le16(&header[28], 24);
+    put_le32(&header[34], row_size * height);
+    put_le32(&header[38], 2835);    // 72 dpi
+    put_le32(&header[42], 2835);
+    if (!write(p_context, header, sizeof(header))) {
+        return false;
+    }
+
+    // bottom-up rows
+    memset(p_row, 0, row_size);
+    for (oy = height - 1; oy >= 0; oy--) {
+        int y = oy * step;
+
+        fuse_row(&p_yuv[yuv_stride * y], p_colors, y, step, p_row);
+        if (!write(p_context, p_row, row_size)) {
+            return false;
+        }
+    }
+    return true;
+}
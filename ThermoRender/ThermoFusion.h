@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_FUSION_H
+#define THERMO_FUSION_H
+
+#include <stdint.h>
+#include "ThermoRegistration.h"
+
+/* Size of the file and info headers of a 24-bit BMP */
+#define THERMO_BMP_HEADER_SIZE  (54)
+
+/* Row size of a 24-bit BMP (rows are padded to 4 bytes) */
+#define THERMO_BMP_ROW_SIZE(width)  ((((width) * 3) + 3u) & ~3u)
+
+/** Output of the encoder
+ *
+ *  @param p_context context given to write_bmp
+ *  @param p_data    data
+ *  @param size      number of bytes
+ *  @return true on success, false to stop the encoder
+ */
+typedef bool (*ThermoWriteFunc)(void* p_context, const void* p_data, uint32_t size);
+
+/** Thermograph over the camera image, encoded as a 24-bit BMP
+ *
+ *  The camera image is YCbCr422 (Y0 Cb Y1 Cr, the output of the DRP simple
+ *  ISP), the thermograph is the ARGB4444 color grid of the registration map
+ *  and is blended with its own alpha. The image goes out one row at a time,
+ *  so only a row buffer is needed. step > 1 samples every step-th camera
+ *  pixel for a smaller image.
+ *
+ * Example:
+ * @code
+ *
+ * ThermoFusion fusion(registration);
+ * static uint8_t row[THERMO_BMP_ROW_SIZE(640)];
+ *
+ * registration.build(160, 120);
+ * fusion.write_bmp(fbuf_yuv, FRAME_BUFFER_STRIDE_2, colors, 1, row, write_file, &file);
+ * @endcode
+ */
+class ThermoFusion
+{
+public:
+    /** Create a fusion of a registration
+     *
+     *  @param registration registration map (must outlive the fusion)
+     */
+    ThermoFusion(const ThermoRegistration& registration);
+
+    int out_width(int step) const { return mRegistration.width() / step; }
+    int out_height(int step) const { return mRegistration.height() / step; }
+
+    /** Fuse one output row
+     *
+     *  @param p_yuv    camera pixel row of the output row [width * 2]
+     *  @param p_colors color grid [reso_y][reso_x] of the registration map
+     *  @param y        camera pixel row
+     *  @param step     camera pixels per output pixel
+     *  @param p_bgr    output row [out_width(step) * 3], blue, green, red
+     */
+    void fuse_row(const uint8_t* p_yuv, const uint16_t* p_colors, int y, int step, uint8_t* p_bgr) const;
+
+    /** Encode the fused image as a 24-bit BMP
+     *
+     *  @param p_yuv      camera image
+     *  @param yuv_stride camera image stride [bytes]
+     *  @param p_colors   color grid [reso_y][reso_x] of the registration map
+     *  @param step       camera pixels per output pixel
+     *  @param p_row      row buffer [THERMO_BMP_ROW_SIZE(out_width(step))]
+     *  @param write      output of the encoded data
+     *  @param p_context  context of write
+     *  @return true on success, false if write failed
+     */
+    bool write_bmp(const uint8_t* p_yuv, int yuv_stride, const uint16_t* p_colors, int step,
+                   uint8_t* p_row, ThermoWriteFunc write, void* p_context) const;
+
+private:
+    const ThermoRegistration& mRegistration;
+};
+
+#endif
@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ThermoKernel.h"
+
+ThermoKernel::ThermoKernel(const ThermoPalette& palette) :
+    mPalette(palette), mResampler(NULL), mMode(THERMO_RESAMPLE_LINEAR), mWidth(0), mHeight(0), mMin(0)
+{
+}
+
+bool ThermoKernel::begin(const int16_t* p_raw, int width, int height, int min, int max, const ThermoResampler* p_resampler,
+                         ThermoResampleMode mode)
+{
+    int i;
+
+    if ((width * height) > THERMO_KERNEL_MAX_SOURCE) {
+        return false;
+    }
+
+    if (p_resampler == NULL) {
+        // colorized straight from the raw palette
+        for (i = 0; i < (width * height); i++) {
+            mRaw[i] = p_raw[i];
+        }
+        mResampler = NULL;
+        mWidth  = width;
+        mHeight = height;
+        mMin    = min;
+        return true;
+    }
+
+    if ((p_resampler->in_width() != width) || (p_resampler->in_height() != height)
+     || ((height * p_resampler->out_width()) > THERMO_KERNEL_MAX_ROWS)) {
+        return false;
+    }
+
+    for (i = 0; i < (width * height); i++) {
+        mSource[i] = thermo_normalize_q15(p_raw[i], min, max);
+    }
+    mMode = p_resampler->supported(mode);
+    p_resampler->expand_rows(mSource, mRows, mMode);
+
+    mResampler = p_resampler;
+    mWidth  = p_resampler->out_width();
+    mHeight = p_resampler->out_height();
+    mMin    = min;
+    return true;
+}
+
+void ThermoKernel::color_row(int y, uint16_t* p_color) const
+{
+    color_span(y, 0, mWidth, p_color);
+}
+
+void ThermoKernel::color_span(int y, int x0, int x1, uint16_t* p_color) const
+{
+    int x;
+
+    if (mResampler == NULL) {
+        const int16_t* p_src = &mRaw[mWidth * y];
+
+        for (x = x0; x < x1; x++) {
+            p_color[x] = mPalette.color_raw(p_src[x] - mMin);
+        }
+        return;
+    }
+
+    if (mMode != THERMO_RESAMPLE_LINEAR) {
+        // blended into the color row, then colorized in place
+        mResampler->blend_span(mRows, y, x0, x1, p_color, mMode);
+        for (x = x0; x < x1; x++) {
+            p_color[x] = mPalette.color(p_color[x]);
+        }
+        return;
+    }
+
+    const ThermoResampleTap& tap = mResampler->tap_y(y);
+    const uint16_t* p_top    = &mRows[mWidth * tap.index];
+    const uint16_t* p_bottom = p_top + mWidth;
+
+    if (0 == tap.weight) {
+        for (x = x0; x < x1; x++) {
+            p_color[x] = mPalette.color(p_top[x]);
+        }
+        return;
+    }
+
+    for (x = x0; x < x1; x++) {
+        p_color[x] = mPalette.color(thermo_lerp_q15(p_top[x], p_bottom[x], tap.weight));
+    }
+}
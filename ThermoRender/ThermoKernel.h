@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_KERNEL_H
+#define THERMO_KERNEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ThermoPalette.h"
+#include "ThermoResampler.h"
+
+/* Largest sensor grid (number of pixels), D6T-32L-01A */
+#ifndef THERMO_KERNEL_MAX_SOURCE
+#define THERMO_KERNEL_MAX_SOURCE    (32 * 32)
+#endif
+
+/* Largest work area of the x direction expansion (source rows * output width) */
+#ifndef THERMO_KERNEL_MAX_ROWS
+#define THERMO_KERNEL_MAX_ROWS      (32 * 160)
+#endif
+
+/** Streaming thermograph render kernel
+ *
+ *  Goes from the raw sensor data to ARGB4444 rows one output row at a time:
+ *  normalize and x direction expansion run once per frame on the source rows,
+ *  then every output row is y direction blended and colorized in one pass.
+ *  No full-resolution intermediate buffer is used.
+ *
+ * Example:
+ * @code
+ *
+ * ThermoKernel kernel(palette);
+ *
+ * kernel.begin(&buf[0], 4, 4, min, max, &resampler160x120);
+ * for (y = 0; y < kernel.height(); y++) {
+ *     kernel.color_row(y, &row[0]);
+ *     ...
+ * }
+ * @endcode
+ */
+class ThermoKernel
+{
+public:
+    /** Create a kernel instance
+     *
+     *  @param palette color table (must outlive the kernel)
+     */
+    ThermoKernel(const ThermoPalette& palette);
+
+    /** Start a frame
+     *
+     *  @param p_raw       temperature data [height][width] (The integer which set a centigrade to 10 times)
+     *  @param width       sensor grid x size
+     *  @param height      sensor grid y size
+     *  @param min         smallest threshold temperature value
+     *  @param max         highest threshold temperature value
+     *  @param p_resampler expansion table, NULL to render the sensor grid as it is
+     *                     (then max - min must be the raw range of the palette)
+     *  @param mode        interpolation of the expansion (linear if the resampler does not have it)
+     *  @return true on success, false if the sizes exceed the work area
+     */
+    bool begin(const int16_t* p_raw, int width, int height, int min, int max, const ThermoResampler* p_resampler,
+               ThermoResampleMode mode = THERMO_RESAMPLE_LINEAR);
+
+    /** Output grid size of the current frame */
+    int width(void) const { return mWidth; }
+    int height(void) const { return mHeight; }
+
+    /** Colorize one output row
+     *
+     *  @param y       output row number
+     *  @param p_color ARGB4444 colors [width]
+     */
+    void color_row(int y, uint16_t* p_color) const;
+
+    /** Colorize columns x0 to x1 - 1 of one output row (see ThermoRedraw)
+     *
+     *  @param y       output row number
+     *  @param x0      first column
+     *  @param x1      column after the last one
+     *  @param p_color ARGB4444 colors [width], only x0 to x1 - 1 are written
+     */
+    void color_span(int y, int x0, int x1, uint16_t* p_color) const;
+
+private:
+    const ThermoPalette& mPalette;
+    const ThermoResampler* mResampler;
+    ThermoResampleMode mMode;
+    int mWidth;
+    int mHeight;
+    int mMin;
+    int16_t mRaw[THERMO_KERNEL_MAX_SOURCE];
+    uint16_t mSource[THERMO_KERNEL_MAX_SOURCE];     // normalized source grid (kept off the stack)
+    uint16_t mRows[THERMO_KERNEL_MAX_ROWS];
+};
+
+#endif
@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <string.h>
+#include "ThermoPalette.h"
+#include "ThermoReference.h"
+
+#define ALPHA_MASK      (0x00F0)
+#define ALPHA_SHIFT     (4)
+
+ThermoPalette::ThermoPalette() : mRawRange(0), mAlpha(0)
+{
+    memset(mTable, 0, sizeof(mTable));
+    memset(mRawTable, 0, sizeof(mRawTable));
+}
+
+bool ThermoPalette::setup(uint8_t alpha, int raw_range)
+{
+    int i;
+
+    if ((raw_range <= 0) || (THERMO_PALETTE_RAW_MAX < raw_range)) {
+        return false;
+    }
+
+    for (i = 0; i < THERMO_PALETTE_SIZE; i++) {
+        mTable[i] = conv_normalize_to_color(alpha, (float)i / (float)(THERMO_PALETTE_SIZE - 1));
+    }
+
+    mAlpha = alpha;
+    mRawRange = 0;
+    return set_raw_range(raw_range);
+}
+
+bool ThermoPalette::set_raw_range(int raw_range)
+{
+    int i;
+
+    if ((raw_range <= 0) || (THERMO_PALETTE_RAW_MAX < raw_range)) {
+        return false;
+    }
+    if (raw_range == mRawRange) {
+        return true;
+    }
+
+    // same normalization as the float path, with min = 0
+    for (i = 0; i <= raw_range; i++) {
+        mRawTable[i] = conv_normalize_to_color(mAlpha, normalize0to1((int16_t)i, 0, raw_range));
+    }
+    mRawRange = raw_range;
+    return true;
+}
+
+void ThermoPalette::set_alpha(uint8_t alpha)
+{
+    uint16_t bits = (uint16_t)((alpha << ALPHA_SHIFT) & ALPHA_MASK);
+    int i;
+
+    if (alpha == mAlpha) {
+        return;
+    }
+
+    for (i = 0; i < THERMO_PALETTE_SIZE; i++) {
+        mTable[i] = (uint16_t)((mTable[i] & ~ALPHA_MASK) | bits);
+    }
+    for (i = 0; i <= mRawRange; i++) {
+        mRawTable[i] = (uint16_t)((mRawTable[i] & ~ALPHA_MASK) | bits);
+    }
+    mAlpha = alpha;
+}
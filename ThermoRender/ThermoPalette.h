@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_PALETTE_H
+#define THERMO_PALETTE_H
+
+#include <stdint.h>
+#include "ThermoFixed.h"
+
+/* Number of Q15 palette entries: 0.0-1.0 in steps of 1/(2^THERMO_PALETTE_BITS) */
+#define THERMO_PALETTE_BITS     (10)
+#define THERMO_PALETTE_SIZE     ((1 << THERMO_PALETTE_BITS) + 1)
+#define THERMO_PALETTE_SHIFT    (THERMO_Q15_SHIFT - THERMO_PALETTE_BITS)
+
+/* Largest raw temperature range (The integer which set a centigrade to 10 times) */
+#define THERMO_PALETTE_RAW_MAX  (1024)
+
+/** ARGB4444 color lookup table of the thermograph
+ *
+ *  Each entry is conv_normalize_to_color() of the entry point, so the output
+ *  matches the float mapping exactly at the table points.
+ *
+ * Example:
+ * @code
+ *
+ * ThermoPalette palette;
+ *
+ * palette.setup(0x0F, max - min);
+ * color = palette.color(thermo_normalize_q15(data, min, max));
+ * color = palette.color_raw(data - min);    // same mapping, no normalization
+ * @endcode
+ */
+class ThermoPalette
+{
+public:
+    ThermoPalette();
+
+    /** Build the tables
+     *
+     *  @param alpha     alpha pixel value (0x0 - 0xF)
+     *  @param raw_range max - min of the raw temperature range
+     *  @return true on success, false if raw_range is out of range
+     */
+    bool setup(uint8_t alpha, int raw_range);
+
+    /** Change the raw temperature range
+     *
+     *  Only the raw table is rebuilt (at the current alpha), the normalized
+     *  table does not depend on the range. Nothing is done if the range is
+     *  the current one.
+     *  @param raw_range max - min of the raw temperature range
+     *  @return true on success, false if raw_range is out of range
+     */
+    bool set_raw_range(int raw_range);
+
+    /** Change the alpha pixel value of every entry
+     *
+     *  @param alpha alpha pixel value (0x0 - 0xF)
+     */
+    void set_alpha(uint8_t alpha);
+
+    uint8_t alpha(void) const { return mAlpha; }
+    int raw_range(void) const { return mRawRange; }
+
+    /** Color of a Q15 normalized value (rounded to the nearest entry) */
+    uint16_t color(uint16_t data) const
+    {
+        return mTable[(data + (1 << (THERMO_PALETTE_SHIFT - 1))) >> THERMO_PALETTE_SHIFT];
+    }
+
+    /** Color of an 8-bit index (thermo_index_q15) */
+    uint16_t color_index(uint8_t index) const
+    {
+        return color(thermo_q15_index(index));
+    }
+
+    /** Color of a raw temperature
+     *
+     *  @param offset temperature minus the range minimum (saturated to 0 - raw_range)
+     */
+    uint16_t color_raw(int offset) const
+    {
+        if (offset <= 0) {
+            return mRawTable[0];
+        }
+        if (mRawRange <= offset) {
+            return mRawTable[mRawRange];
+        }
+        return mRawTable[offset];
+    }
+
+private:
+    uint16_t mTable[THERMO_PALETTE_SIZE];
+    uint16_t mRawTable[THERMO_PALETTE_RAW_MAX + 1];
+    int mRawRange;
+    uint8_t mAlpha;
+};
+
+#endif
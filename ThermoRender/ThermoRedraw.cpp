@@ -0,0 +1,187 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "ThermoRedraw.h"
+
+/* Output position of source sample index, the knot of liner_interpolation() (clamped to the grid) */
+static inline int knot(int index, int in, int out)
+{
+    if (index <= 0) {
+        return 0;
+    }
+    if (index >= (in - 1)) {
+        return out - 1;
+    }
+    return (out - 1) * index / (in - 1);
+}
+
+static inline bool same_key(const ThermoRedrawKey& a, const ThermoRedrawKey& b)
+{
+    return (a.width == b.width) && (a.height == b.height) && (a.min == b.min) && (a.max == b.max) && (a.style == b.style);
+}
+
+ThermoRedraw::ThermoRedraw(int width, int height, int threshold) :
+    mWidth(width), mHeight(height), mThreshold(threshold), mOutW(0), mOutH(0), mFull(true)
+{
+    memset(mKey, 0, sizeof(mKey));
+    memset(mSpan, 0, sizeof(mSpan));
+    invalidate();
+    reset_stats();
+}
+
+void ThermoRedraw::set_threshold(int threshold)
+{
+    mThreshold = threshold;
+    invalidate();
+}
+
+void ThermoRedraw::invalidate(void)
+{
+    int i;
+
+    for (i = 0; i < THERMO_REDRAW_BUFFERS; i++) {
+        mValid[i] = false;
+    }
+}
+
+void ThermoRedraw::reset_stats(void)
+{
+    memset(&mStats, 0, sizeof(mStats));
+}
+
+bool ThermoRedraw::begin(int buffer, const int16_t* p_raw, const ThermoRedrawKey& key, int reach, bool full)
+{
+    int16_t* p_shown = &mShown[buffer][0];
+    int sx;
+    int sy;
+
+    mOutW = key.width;
+    mOutH = key.height;
+
+    full = full || (mThreshold < 0) || !mValid[buffer] || !same_key(mKey[buffer], key)
+        || ((mWidth * mHeight) > THERMO_REDRAW_MAX_SOURCE) || (mOutH > THERMO_REDRAW_MAX_ROWS);
+    mFull = full;
+    if (full) {
+        if ((mWidth * mHeight) <= THERMO_REDRAW_MAX_SOURCE) {
+            memcpy(p_shown, p_raw, (size_t)(mWidth * mHeight) * sizeof(int16_t));
+            mKey[buffer] = key;
+            mValid[buffer] = (mThreshold >= 0);
+        }
+        return true;
+    }
+
+    memset(mSpan, 0, sizeof(Span) * mOutH);
+
+    // changed columns of each source row, then the output points which read them
+    for (sy = 0; sy < mHeight; sy++) {
+        const int16_t* p_src = &p_raw[mWidth * sy];
+        int16_t* p_dst = &p_shown[mWidth * sy];
+        int lo = mWidth;
+        int hi = -1;
+
+        for (sx = 0; sx < mWidth; sx++) {
+            if (abs(p_src[sx] - p_dst[sx]) > mThreshold) {
+                p_dst[sx] = p_src[sx];
+                if (sx < lo) {
+                    lo = sx;
+                }
+                hi = sx;
+            }
+        }
+        if (hi >= 0) {
+            add_span(knot(sy - reach, mHeight, mOutH), knot(sy + reach, mHeight, mOutH) + 1,
+                     knot(lo - reach, mWidth, mOutW), knot(hi + reach, mWidth, mOutW) + 1);
+        }
+    }
+    return false;
+}
+
+void ThermoRedraw::add_rect(int x, int y, int w, int h)
+{
+    if (mFull) {
+        return;
+    }
+    if (x < 0) {
+        w += x;
+        x = 0;
+    }
+    if (y < 0) {
+        h += y;
+        y = 0;
+    }
+    if ((x + w) > mOutW) {
+        w = mOutW - x;
+    }
+    if ((y + h) > mOutH) {
+        h = mOutH - y;
+    }
+    if ((w > 0) && (h > 0)) {
+        add_span(y, y + h, x, x + w);
+    }
+}
+
+void ThermoRedraw::add_span(int y0, int y1, int x0, int x1)
+{
+    int y;
+
+    for (y = y0; y < y1; y++) {
+        Span& span = mSpan[y];
+
+        if (span.x0 >= span.x1) {
+            span.x0 = (uint16_t)x0;
+            span.x1 = (uint16_t)x1;
+            continue;
+        }
+        if (x0 < span.x0) {
+            span.x0 = (uint16_t)x0;
+        }
+        if (x1 > span.x1) {
+            span.x1 = (uint16_t)x1;
+        }
+    }
+}
+
+void ThermoRedraw::end(void)
+{
+    uint32_t points = 0;
+    int y;
+
+    for (y = 0; (y < mOutH) && !mFull; y++) {
+        if (mSpan[y].x0 < mSpan[y].x1) {
+            points += (uint32_t)(mSpan[y].x1 - mSpan[y].x0);
+        }
+    }
+    mStats.frames++;
+    if (mFull) {
+        points = (uint32_t)(mOutW * mOutH);
+        mStats.full++;
+    }
+    mStats.points += points;
+    mStats.total  += (uint32_t)(mOutW * mOutH);
+    mStats.last_points = points;
+    mStats.last_total  = (uint32_t)(mOutW * mOutH);
+}
@@ -0,0 +1,185 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_REDRAW_H
+#define THERMO_REDRAW_H
+
+#include <stdint.h>
+
+/* Number of display buffers tracked (drawn in turn) */
+#ifndef THERMO_REDRAW_BUFFERS
+#define THERMO_REDRAW_BUFFERS       (2)
+#endif
+
+/* Largest sensor grid (number of pixels), D6T-32L-01A */
+#ifndef THERMO_REDRAW_MAX_SOURCE
+#define THERMO_REDRAW_MAX_SOURCE    (32 * 32)
+#endif
+
+/* Largest output grid height */
+#ifndef THERMO_REDRAW_MAX_ROWS
+#define THERMO_REDRAW_MAX_ROWS      (240)
+#endif
+
+/* Source samples on each side of an output point read by the expansion */
+#define THERMO_REDRAW_REACH_NONE    (0)     // the sensor grid as it is
+#define THERMO_REDRAW_REACH_LINEAR  (1)     // linear and edge-aware
+#define THERMO_REDRAW_REACH_CUBIC   (2)     // Catmull-Rom, also covers a center aligned bilinear resize
+
+/** What a buffer shows besides the sensor pixels, any change redraws the whole buffer */
+struct ThermoRedrawKey {
+    int      width;     // output grid size
+    int      height;
+    int      min;       // color range
+    int      max;
+    uint32_t style;     // anything else of the caller (alpha, expansion, ...)
+};
+
+/** Counters of a ThermoRedraw */
+struct ThermoRedrawStats {
+    uint32_t frames;            // frames drawn
+    uint32_t full;              // frames redrawn in full
+    uint64_t points;            // output grid points redrawn, all frames
+    uint64_t total;             // output grid points, all frames
+    uint32_t last_points;       // output grid points redrawn by the last frame
+    uint32_t last_total;        // output grid points of the last frame
+};
+
+/** Output region to redraw on a display buffer
+ *
+ *  The buffers are drawn in turn, so each one shows an older frame than
+ *  the last one drawn. The sensor pixels a buffer shows are kept; a new
+ *  frame is compared with them and only pixels which moved more than the
+ *  threshold count as changed. A changed pixel is mapped through the
+ *  footprint of the expansion (the knots of liner_interpolation() and the
+ *  reach of the interpolation) to the output points which read it, as one
+ *  column span per output row.
+ *
+ *  A pixel below the threshold keeps the value the buffer shows, so small
+ *  drifts add up until they pass it. A change of the key (size, range,
+ *  style) or invalidate() redraws the whole buffer.
+ *
+ * Example:
+ * @code
+ *
+ * ThermoRedraw redraw(4, 4, 0);
+ *
+ * redraw.begin(screen, &raw[0], key, THERMO_REDRAW_REACH_LINEAR, blitter.redraw_pending(160, 4, 4));
+ * redraw.add_rect(0, 0, title_w, title_h);
+ * for (y = 0; y < 120; y++) {
+ *     if (redraw.row_span(y, &x0, &x1)) {
+ *         kernel.color_span(y, x0, x1, &row[0]);
+ *         blitter.draw_tile_span(y, &row[0], 160, 4, 4, x0, x1);
+ *     }
+ * }
+ * redraw.end();
+ * @endcode
+ */
+class ThermoRedraw
+{
+public:
+    /** Create a tracker of the display buffers
+     *
+     *  @param width     sensor grid x size
+     *  @param height    sensor grid y size
+     *  @param threshold smallest change of a pixel redrawn (The integer which set a centigrade to 10 times),
+     *                   0: any change, negative: every frame is redrawn in full
+     */
+    ThermoRedraw(int width, int height, int threshold);
+
+    /** Change the threshold, every buffer is redrawn in full next */
+    void set_threshold(int threshold);
+    int threshold(void) const { return mThreshold; }
+
+    /** Start a frame of a buffer
+     *
+     *  @param buffer buffer number (less than THERMO_REDRAW_BUFFERS)
+     *  @param p_raw  temperature data [height][width] of the new frame
+     *  @param key    output grid, range and style of the new frame
+     *  @param reach  source samples on each side read by an output point (THERMO_REDRAW_REACH_*)
+     *  @param full   true to redraw the whole buffer in any case (e.g. it was cleared)
+     *  @return true if the whole buffer is redrawn
+     */
+    bool begin(int buffer, const int16_t* p_raw, const ThermoRedrawKey& key, int reach, bool full = false);
+
+    /** Redraw an area of the output grid in any case (e.g. tiles under an overlay)
+     *
+     *  @param x left position (output grid)
+     *  @param y top position (output grid)
+     *  @param w width
+     *  @param h height
+     */
+    void add_rect(int x, int y, int w, int h);
+
+    /** Columns of an output row to redraw
+     *
+     *  @param y      output row number
+     *  @param p_x0   first column (set)
+     *  @param p_x1   column after the last one (set)
+     *  @return false if nothing of the row is redrawn
+     */
+    bool row_span(int y, int* p_x0, int* p_x1) const
+    {
+        if (mFull) {
+            *p_x0 = 0;
+            *p_x1 = mOutW;
+            return true;
+        }
+        *p_x0 = mSpan[y].x0;
+        *p_x1 = mSpan[y].x1;
+        return (mSpan[y].x0 < mSpan[y].x1);
+    }
+
+    /** Finish the frame and count the redrawn points */
+    void end(void);
+
+    /** Forget what the buffers show, their next frames are redrawn in full */
+    void invalidate(void);
+
+    const ThermoRedrawStats& stats(void) const { return mStats; }
+    void reset_stats(void);
+
+private:
+    struct Span {
+        uint16_t x0;
+        uint16_t x1;
+    };
+
+    int mWidth;
+    int mHeight;
+    int mThreshold;
+    int mOutW;
+    int mOutH;
+    bool mValid[THERMO_REDRAW_BUFFERS];
+    bool mFull;
+    ThermoRedrawKey mKey[THERMO_REDRAW_BUFFERS];
+    int16_t mShown[THERMO_REDRAW_BUFFERS][THERMO_REDRAW_MAX_SOURCE];    // pixels each buffer shows
+    Span mSpan[THERMO_REDRAW_MAX_ROWS];
+    ThermoRedrawStats mStats;
+
+    void add_span(int y0, int y1, int x0, int x1);
+};
+
+#endif
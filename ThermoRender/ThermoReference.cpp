@@ -0,0 +1,187 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <math.h>
+#include "ThermoReference.h"
+
+#ifndef M_PI
+#define M_PI                (3.1415926535897932384626433832795)
+#endif
+
+/*******************************************************************************
+* Function Name: normalize0to1
+* Description  : Normalize thermal data of a reception packet to the range of 0-1.
+*                Also the value outside min, max is saturated.
+* Arguments    : data     - input tempetue data
+*                min      - smallest threshold tempature value
+*                           (The integer which set a centigrade to 10 times)
+*                max      - highest threshold  tempature value
+*                           (The integer which set a centigrade to 10 times)
+* Return Value : normalized output data
+*******************************************************************************/
+float normalize0to1(int16_t data, int min, int max)
+{
+    float normalized;
+
+    if (data <= min) {
+        normalized = 0.0;
+    }
+    else if (max <= data) {
+        normalized = 1.0;
+    }
+    else {
+        normalized = ((float)(data - min)) / ((float)(max - min));
+    }
+    return normalized;
+}
+/*******************************************************************************
+ End of function normalize0to1
+*******************************************************************************/
+
+/*******************************************************************************
+* Function Name: conv_normalize_to_color
+* Description  : Change a floating-point data of 0.0-1.0 to the pixel color of
+*                ARGB4444(truth order:GBAR).
+*                Low temperature changes blue and high temperature to red.
+* Arguments    : data        - Normalized thermal data from 0.0 to 1.0.
+* Return Value : ARGB4444 pixel color data.
+*******************************************************************************/
+uint16_t conv_normalize_to_color(uint8_t alpha, float data) {
+    uint8_t green;
+    uint8_t blue;
+    uint8_t red;
+
+    if (0.0 == data) {
+        /* Display blue when the temperature is below the minimum. */
+        blue  = 0x0F;
+        green = 0x00;
+        red   = 0x00;
+    }
+    else if (1.0 == data) {
+        /* Display red when the maximum temperature is exceeded. */
+        blue  = 0x00;
+        green = 0x00;
+        red   = 0x0F;
+    }
+    else {
+        float cosval   = cos( 4 * M_PI * data);
+        int    color    = (int)((((-cosval)/2) + 0.5) * 15);
+        if (data < 0.25) {
+            blue  = 0xF;
+            green = color;
+            red   = 0x00;
+        }
+        else if (data < 0.50) {
+            blue  = color;
+            green = 0x0F;
+            red   = 0x00;
+        }
+        else if (data < 0.75) {
+            blue  = 0x00;
+            green = 0x0F;
+            red   = color;
+        }
+        else {
+            blue  = 0x00;
+            green = color;
+            red   = 0x0F;
+        }
+    }
+
+    return ((green << 12) | (blue << 8) | (alpha << 4) | red);
+}
+
+/*******************************************************************************
+ End of function conv_normalize_to_color
+*******************************************************************************/
+
+/*******************************************************************************
+* Function Name: liner_interpolation
+* Description  : Expand float data array from array[y_in_size][x_in_size] to array[y_out_size][x_out_size]
+*                Linear complementation is used for expansion algorithm.
+* Arguments    : p_in_array   - pointer of input data
+*                p_out_array  - pointer of output data
+*                x_in_size    - input array x size
+*                y_in_size    - input array y size
+*                x_out_size   - output array x size
+*                y_out_size   - output array y size
+* Return Value : none
+*******************************************************************************/
+void liner_interpolation(float* p_in_array, float* p_out_array, int x_in_size, int y_in_size, int x_out_size, int y_out_size)
+{
+    int   x_in;
+    int   y_in;
+    int   x_out_start;
+    int   x_out_goal;
+    float x_delta;
+    int   x_w_pos;
+    int   y_out_start;
+    int   y_out_goal;
+    float y_delta;
+    int   y_w_pos;
+    float data_start;
+    float data_goal;
+    float data_w_pos;
+
+    /* expand x direction */
+    for (y_in = 0; y_in < y_in_size; y_in++) {
+        y_out_goal = (y_out_size - 1) * y_in / (y_in_size - 1);
+        for (x_in = 1; x_in < x_in_size; x_in++) {
+            x_out_start  = (x_out_size - 1) * (x_in - 1) / (x_in_size - 1);
+            x_out_goal   = (x_out_size - 1) * (x_in    ) / (x_in_size - 1);
+            x_delta   = x_out_goal - x_out_start;
+
+            data_start = p_in_array[(x_in - 1) + (x_in_size * y_in)];
+            data_goal  = p_in_array[(x_in    ) + (x_in_size * y_in)];
+
+            for (x_w_pos = x_out_start; x_w_pos <= x_out_goal; x_w_pos++) {
+                data_w_pos = (data_start * ((x_out_goal - x_w_pos ) / x_delta))
+                           + (data_goal  * ((x_w_pos - x_out_start) / x_delta));
+                p_out_array[x_w_pos + (x_out_size * y_out_goal)] = data_w_pos;
+            }
+        }
+    }
+
+    /* expand y direction */
+    for (x_w_pos = 0; x_w_pos < x_out_size; x_w_pos++) {
+        for (y_in = 1; y_in < y_in_size; y_in++) {
+            y_out_start  = (y_out_size - 1) * (y_in - 1) / (y_in_size - 1);
+            y_out_goal   = (y_out_size - 1) * (y_in    ) / (y_in_size - 1);
+            y_delta   = y_out_goal - y_out_start;
+
+            data_start = p_out_array[x_w_pos + (x_out_size * y_out_start)];
+            data_goal  = p_out_array[x_w_pos + (x_out_size * y_out_goal)];
+
+            for (y_w_pos = y_out_start+1; y_w_pos < y_out_goal; y_w_pos++) {
+                data_w_pos = (data_start * ((y_out_goal - y_w_pos ) / y_delta))
+                           + (data_goal  * ((y_w_pos - y_out_start) / y_delta));
+                p_out_array[x_w_pos + (x_out_size * y_w_pos)] = data_w_pos;
+            }
+        }
+    }
+}
+/*******************************************************************************
+ End of function liner_interpolation
+*******************************************************************************/
@@ -0,0 +1,191 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <math.h>
+#include <string.h>
+#include "ThermoRegistration.h"
+
+/* Smallest pivot of the point pair solver */
+#define THERMO_REG_EPSILON      (1.0e-6f)
+
+ThermoRegistration::ThermoRegistration(uint16_t* p_map, int width, int height) :
+    mMap(p_map), mWidth(width), mHeight(height),
+    mMapW(width / THERMO_REG_BLOCK), mMapH(height / THERMO_REG_BLOCK),
+    mResoX(0), mResoY(0), mBuilds(0)
+{
+    static const float identity[9] = { 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+
+    set_transform(identity);
+}
+
+void ThermoRegistration::set_transform(const float* p_h)
+{
+    memcpy(mH, p_h, sizeof(mH));
+    mResoX = 0;
+    mResoY = 0;
+}
+
+bool ThermoRegistration::build(int reso_x, int reso_y)
+{
+    int cx;
+    int cy;
+
+    if ((reso_x == mResoX) && (reso_y == mResoY)) {
+        return false;
+    }
+    for (cy = 0; cy < mMapH; cy++) {
+        float y = (float)((cy * THERMO_REG_BLOCK) + (THERMO_REG_BLOCK / 2));
+        uint16_t* p_out = &mMap[cy * mMapW];
+
+        for (cx = 0; cx < mMapW; cx++) {
+            float x = (float)((cx * THERMO_REG_BLOCK) + (THERMO_REG_BLOCK / 2));
+            float w = (mH[6] * x) + (mH[7] * y) + mH[8];
+            float u;
+            float v;
+            int gx;
+            int gy;
+
+            p_out[cx] = THERMO_REG_OUTSIDE;
+            if (w <= THERMO_REG_EPSILON) {
+                // behind the camera
+                continue;
+            }
+            u = ((mH[0] * x) + (mH[1] * y) + mH[2]) / w;
+            v = ((mH[3] * x) + (mH[4] * y) + mH[5]) / w;
+            if ((u < 0.0f) || (v < 0.0f) || (u >= (float)mWidth) || (v >= (float)mHeight)) {
+                continue;
+            }
+            gx = (int)((u * reso_x) / mWidth);
+            gy = (int)((v * reso_y) / mHeight);
+            p_out[cx] = (uint16_t)((gy * reso_x) + gx);
+        }
+    }
+    mResoX = reso_x;
+    mResoY = reso_y;
+    mBuilds++;
+    return true;
+}
+
+bool ThermoRegistration::solve_homography(const ThermoRegPoint* p_points, float* p_h)
+{
+    float a[8 * 8];
+    float b[8];
+    int i;
+
+    // u = (h0 x + h1 y + h2) / (h6 x + h7 y + 1), v likewise with h3 - h5
+    for (i = 0; i < 4; i++) {
+        const ThermoRegPoint& p = p_points[i];
+        float* p_u = &a[(i * 2) * 8];
+        float* p_v = &a[((i * 2) + 1) * 8];
+
+        p_u[0] = p.x;  p_u[1] = p.y;  p_u[2] = 1.0f;
+        p_u[3] = 0.0f; p_u[4] = 0.0f; p_u[5] = 0.0f;
+        p_u[6] = -p.x * p.u; p_u[7] = -p.y * p.u;
+        p_v[0] = 0.0f; p_v[1] = 0.0f; p_v[2] = 0.0f;
+        p_v[3] = p.x;  p_v[4] = p.y;  p_v[5] = 1.0f;
+        p_v[6] = -p.x * p.v; p_v[7] = -p.y * p.v;
+        b[i * 2]       = p.u;
+        b[(i * 2) + 1] = p.v;
+    }
+    if (!solve(a, b, 8)) {
+        return false;
+    }
+    memcpy(p_h, b, sizeof(b));
+    p_h[8] = 1.0f;
+    return true;
+}
+
+bool ThermoRegistration::solve_affine(const ThermoRegPoint* p_points, float* p_h)
+{
+    float a[3 * 3];
+    float bu[3];
+    float bv[3];
+    int i;
+
+    for (i = 0; i < 3; i++) {
+        a[(i * 3)]     = p_points[i].x;
+        a[(i * 3) + 1] = p_points[i].y;
+        a[(i * 3) + 2] = 1.0f;
+        bu[i] = p_points[i].u;
+        bv[i] = p_points[i].v;
+    }
+    float a2[3 * 3];
+    memcpy(a2, a, sizeof(a));
+    if (!solve(a, bu, 3) || !solve(a2, bv, 3)) {
+        return false;
+    }
+    p_h[0] = bu[0]; p_h[1] = bu[1]; p_h[2] = bu[2];
+    p_h[3] = bv[0]; p_h[4] = bv[1]; p_h[5] = bv[2];
+    p_h[6] = 0.0f;  p_h[7] = 0.0f;  p_h[8] = 1.0f;
+    return true;
+}
+
+/* Gaussian elimination with partial pivoting, the result replaces p_b */
+bool ThermoRegistration::solve(float* p_a, float* p_b, int n)
+{
+    int col;
+    int row;
+    int k;
+
+    for (col = 0; col < n; col++) {
+        int pivot = col;
+
+        for (row = col + 1; row < n; row++) {
+            if (fabsf(p_a[(row * n) + col]) > fabsf(p_a[(pivot * n) + col])) {
+                pivot = row;
+            }
+        }
+        if (fabsf(p_a[(pivot * n) + col]) < THERMO_REG_EPSILON) {
+            return false;
+        }
+        if (pivot != col) {
+            for (k = 0; k < n; k++) {
+                float t = p_a[(col * n) + k];
+                p_a[(col * n) + k]   = p_a[(pivot * n) + k];
+                p_a[(pivot * n) + k] = t;
+            }
+            float t = p_b[col];
+            p_b[col]   = p_b[pivot];
+            p_b[pivot] = t;
+        }
+        for (row = col + 1; row < n; row++) {
+            float f = p_a[(row * n) + col] / p_a[(col * n) + col];
+
+            for (k = col; k < n; k++) {
+                p_a[(row * n) + k] -= f * p_a[(col * n) + k];
+            }
+            p_b[row] -= f * p_b[col];
+        }
+    }
+    for (row = n - 1; row >= 0; row--) {
+        float sum = p_b[row];
+
+        for (k = row + 1; k < n; k++) {
+            sum -= p_a[(row * n) + k] * p_b[k];
+        }
+        p_b[row] = sum / p_a[(row * n) + row];
+    }
+    return true;
+}
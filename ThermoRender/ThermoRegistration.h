@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_REGISTRATION_H
+#define THERMO_REGISTRATION_H
+
+#include <stdint.h>
+
+/* Camera pixels per map cell in each direction (4: one cell per 160*120 tile) */
+#define THERMO_REG_BLOCK        (4)
+
+/* Map entry of a cell outside the sensor field of view */
+#define THERMO_REG_OUTSIDE      (0xFFFF)
+
+/* Map size of a camera image [entries] */
+#define THERMO_REG_MAP_SIZE(width, height)  (((width) / THERMO_REG_BLOCK) * ((height) / THERMO_REG_BLOCK))
+
+/** A point pair of the calibration */
+struct ThermoRegPoint {
+    float x;        // camera pixel
+    float y;
+    float u;        // same point on the thermograph [display pixel]
+    float v;
+};
+
+/** Registration of the thermograph on the camera image
+ *
+ *  A 3x3 homography (row-major, an affine transform has 0, 0, 1 as the last
+ *  row) maps a camera pixel (x, y, 1) to the thermograph stretched over the
+ *  same image size, so the identity is the alignment of the display layers.
+ *  build() evaluates it once per THERMO_REG_BLOCK * THERMO_REG_BLOCK cell and
+ *  keeps the grid index of the cell center, a frame then only looks up the
+ *  map. The map is built again only when the grid size or the transform
+ *  changes.
+ *
+ * Example:
+ * @code
+ *
+ * static uint16_t reg_map[THERMO_REG_MAP_SIZE(640, 480)];
+ * ThermoRegistration registration(reg_map, 640, 480);
+ *
+ * registration.set_transform(h);           // or solve_homography(points, h)
+ * registration.build(160, 120);
+ * color = colors[registration.index(x, y)];
+ * @endcode
+ */
+class ThermoRegistration
+{
+public:
+    /** Create a registration with the identity transform
+     *
+     *  @param p_map  map storage [THERMO_REG_MAP_SIZE(width, height)]
+     *  @param width  camera image x size
+     *  @param height camera image y size
+     */
+    ThermoRegistration(uint16_t* p_map, int width, int height);
+
+    /** Set the transform (the map is built again by the next build)
+     *
+     *  @param p_h homography [9], row-major
+     */
+    void set_transform(const float* p_h);
+
+    /** Build the map of a grid size if it is not built yet
+     *
+     *  @param reso_x grid x size
+     *  @param reso_y grid y size
+     *  @return true if the map was built now
+     */
+    bool build(int reso_x, int reso_y);
+
+    /** Grid index of a camera pixel, THERMO_REG_OUTSIDE outside the sensor field of view */
+    uint16_t index(int x, int y) const
+    {
+        return mMap[((y / THERMO_REG_BLOCK) * mMapW) + (x / THERMO_REG_BLOCK)];
+    }
+
+    /** Map row of a camera pixel row [width / THERMO_REG_BLOCK] */
+    const uint16_t* map_row(int y) const { return &mMap[(y / THERMO_REG_BLOCK) * mMapW]; }
+
+    int width(void) const { return mWidth; }
+    int height(void) const { return mHeight; }
+    int reso_x(void) const { return mResoX; }
+    int reso_y(void) const { return mResoY; }
+
+    /** Number of map builds */
+    uint32_t builds(void) const { return mBuilds; }
+
+    /** Homography of 4 point pairs (no 3 points on a line)
+     *
+     *  @param p_points point pairs [4]
+     *  @param p_h      result [9], row-major
+     *  @return true on success, false if the points are degenerate
+     */
+    static bool solve_homography(const ThermoRegPoint* p_points, float* p_h);
+
+    /** Affine transform of 3 point pairs (not on a line)
+     *
+     *  @param p_points point pairs [3]
+     *  @param p_h      result [9], row-major
+     *  @return true on success, false if the points are degenerate
+     */
+    static bool solve_affine(const ThermoRegPoint* p_points, float* p_h);
+
+private:
+    uint16_t* mMap;
+    int mWidth;
+    int mHeight;
+    int mMapW;
+    int mMapH;
+    int mResoX;         // grid size of the map, 0: not built
+    int mResoY;
+    float mH[9];
+    uint32_t mBuilds;
+
+    static bool solve(float* p_a, float* p_b, int n);
+};
+
+#endif
@@ -0,0 +1,218 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include "ThermoResampler.h"
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+static inline uint16_t clamp_q15(int32_t data)
+{
+    return (uint16_t)((data < 0) ? 0 : ((data > THERMO_Q15_ONE) ? THERMO_Q15_ONE : data));
+}
+
+/* Catmull-Rom of four Q15 samples, the overshoot is clamped to 0.0-1.0 */
+static inline uint16_t cubic_q15(int32_t s0, int32_t s1, int32_t s2, int32_t s3, const int16_t* p_weight)
+{
+    int32_t sum = (s0 * p_weight[0]) + (s1 * p_weight[1]) + (s2 * p_weight[2]) + (s3 * p_weight[3]);
+
+    return clamp_q15((sum + (1 << (THERMO_CUBIC_SHIFT - 1))) >> THERMO_CUBIC_SHIFT);
+}
+
+/* Linear between two Q15 samples, the weight goes to the smoothstep as their difference grows */
+static inline uint16_t edge_q15(uint16_t a, uint16_t b, const ThermoResampleTap& tap)
+{
+    int32_t contrast = abs((int32_t)b - (int32_t)a) << THERMO_EDGE_SHIFT;
+    int32_t weight;
+
+    if (contrast > THERMO_Q15_ONE) {
+        contrast = THERMO_Q15_ONE;
+    }
+    weight = tap.weight + ((((int32_t)tap.sharp - (int32_t)tap.weight) * contrast) >> THERMO_Q15_SHIFT);
+    return thermo_lerp_q15(a, b, (uint16_t)weight);
+}
+
+#if defined(__ARM_NEON)
+/* 4 Q15 samples as signed 32-bit lanes */
+static inline int32x4_t load_q15x4(const uint16_t* p_data)
+{
+    return vreinterpretq_s32_u32(vmovl_u16(vld1_u16(p_data)));
+}
+
+static inline void store_q15x4(uint16_t* p_data, int32x4_t data)
+{
+    vst1_u16(p_data, vmovn_u32(vreinterpretq_u32_s32(data)));
+}
+#endif
+
+static void lerp_rows(const uint16_t* p_top, const uint16_t* p_bottom, uint16_t weight, uint16_t* p_out, int width)
+{
+    int x = 0;
+
+#if defined(__ARM_NEON)
+    for (; (x + 4) <= width; x += 4) {
+        int32x4_t a = load_q15x4(&p_top[x]);
+        int32x4_t d = vsubq_s32(load_q15x4(&p_bottom[x]), a);
+
+        store_q15x4(&p_out[x], vaddq_s32(a, vrshrq_n_s32(vmulq_n_s32(d, weight), THERMO_Q15_SHIFT)));
+    }
+#endif
+    for (; x < width; x++) {
+        p_out[x] = thermo_lerp_q15(p_top[x], p_bottom[x], weight);
+    }
+}
+
+static void edge_rows(const uint16_t* p_top, const uint16_t* p_bottom, const ThermoResampleTap& tap, uint16_t* p_out, int width)
+{
+    int x = 0;
+
+#if defined(__ARM_NEON)
+    const int32x4_t one   = vdupq_n_s32(THERMO_Q15_ONE);
+    const int32x4_t base  = vdupq_n_s32(tap.weight);
+    const int32x4_t sharp = vdupq_n_s32((int32_t)tap.sharp - (int32_t)tap.weight);
+
+    for (; (x + 4) <= width; x += 4) {
+        int32x4_t a = load_q15x4(&p_top[x]);
+        int32x4_t d = vsubq_s32(load_q15x4(&p_bottom[x]), a);
+        int32x4_t contrast = vminq_s32(vshlq_n_s32(vabsq_s32(d), THERMO_EDGE_SHIFT), one);
+        int32x4_t weight = vaddq_s32(base, vshrq_n_s32(vmulq_s32(sharp, contrast), THERMO_Q15_SHIFT));
+
+        store_q15x4(&p_out[x], vaddq_s32(a, vrshrq_n_s32(vmulq_s32(d, weight), THERMO_Q15_SHIFT)));
+    }
+#endif
+    for (; x < width; x++) {
+        p_out[x] = edge_q15(p_top[x], p_bottom[x], tap);
+    }
+}
+
+static void cubic_rows(const uint16_t* const* p_row, const int16_t* p_weight, uint16_t* p_out, int width)
+{
+    int x = 0;
+
+#if defined(__ARM_NEON)
+    const int32x4_t zero = vdupq_n_s32(0);
+    const int32x4_t one  = vdupq_n_s32(THERMO_Q15_ONE);
+
+    for (; (x + 4) <= width; x += 4) {
+        int32x4_t sum = vmulq_n_s32(load_q15x4(&p_row[0][x]), p_weight[0]);
+
+        sum = vmlaq_n_s32(sum, load_q15x4(&p_row[1][x]), p_weight[1]);
+        sum = vmlaq_n_s32(sum, load_q15x4(&p_row[2][x]), p_weight[2]);
+        sum = vmlaq_n_s32(sum, load_q15x4(&p_row[3][x]), p_weight[3]);
+        sum = vrshrq_n_s32(sum, THERMO_CUBIC_SHIFT);
+        store_q15x4(&p_out[x], vminq_s32(vmaxq_s32(sum, zero), one));
+    }
+#endif
+    for (; x < width; x++) {
+        p_out[x] = cubic_q15(p_row[0][x], p_row[1][x], p_row[2][x], p_row[3][x], p_weight);
+    }
+}
+
+void ThermoResampler::expand_rows(const uint16_t* p_in, uint16_t* p_rows, ThermoResampleMode mode) const
+{
+    int x;
+    int y;
+
+    mode = supported(mode);
+    for (y = 0; y < mInH; y++) {
+        const uint16_t* p_src = &p_in[mInW * y];
+
+        for (x = 0; x < mOutW; x++) {
+            if (mode == THERMO_RESAMPLE_CUBIC) {
+                const ThermoCubicTap& cubic = mCubicX[x];
+                p_rows[x] = cubic_q15(p_src[cubic.index[0]], p_src[cubic.index[1]],
+                                      p_src[cubic.index[2]], p_src[cubic.index[3]], cubic.weight);
+                continue;
+            }
+            const ThermoResampleTap& tap = mTapX[x];
+            if (0 == tap.weight) {
+                p_rows[x] = p_src[tap.index];
+            } else if (mode == THERMO_RESAMPLE_EDGE) {
+                p_rows[x] = edge_q15(p_src[tap.index], p_src[tap.index + 1], tap);
+            } else {
+                p_rows[x] = thermo_lerp_q15(p_src[tap.index], p_src[tap.index + 1], tap.weight);
+            }
+        }
+        p_rows += mOutW;
+    }
+}
+
+void ThermoResampler::blend_row(const uint16_t* p_rows, int y, uint16_t* p_out, ThermoResampleMode mode) const
+{
+    blend_span(p_rows, y, 0, mOutW, p_out, mode);
+}
+
+void ThermoResampler::blend_span(const uint16_t* p_rows, int y, int x0, int x1, uint16_t* p_out, ThermoResampleMode mode) const
+{
+    int x;
+
+    mode = supported(mode);
+    if (mode == THERMO_RESAMPLE_CUBIC) {
+        const ThermoCubicTap& cubic = mCubicY[y];
+        const uint16_t* row[4];
+
+        for (x = 0; x < 4; x++) {
+            row[x] = &p_rows[(mOutW * cubic.index[x]) + x0];
+        }
+        if (THERMO_CUBIC_ONE == cubic.weight[1]) {
+            /* Output row is on a source row */
+            for (x = x0; x < x1; x++) {
+                p_out[x] = row[1][x - x0];
+            }
+            return;
+        }
+        cubic_rows(row, cubic.weight, &p_out[x0], x1 - x0);
+        return;
+    }
+
+    const ThermoResampleTap& tap = mTapY[y];
+    const uint16_t* p_top    = &p_rows[(mOutW * tap.index) + x0];
+    const uint16_t* p_bottom = p_top + mOutW;
+
+    if (0 == tap.weight) {
+        /* Output row is on a source row */
+        for (x = x0; x < x1; x++) {
+            p_out[x] = p_top[x - x0];
+        }
+        return;
+    }
+
+    if (mode == THERMO_RESAMPLE_EDGE) {
+        edge_rows(p_top, p_bottom, tap, &p_out[x0], x1 - x0);
+    } else {
+        lerp_rows(p_top, p_bottom, tap.weight, &p_out[x0], x1 - x0);
+    }
+}
+
+void ThermoResampler::resample(const uint16_t* p_in, uint16_t* p_out, uint16_t* p_rows, ThermoResampleMode mode) const
+{
+    int y;
+
+    expand_rows(p_in, p_rows, mode);
+    for (y = 0; y < mOutH; y++) {
+        blend_row(p_rows, y, &p_out[mOutW * y], mode);
+    }
+}
@@ -0,0 +1,270 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_RESAMPLER_H
+#define THERMO_RESAMPLER_H
+
+#include <stdint.h>
+#include "ThermoFixed.h"
+
+/* Cubic weights are signed Q14 (Catmull-Rom weights are -0.15 - 1.0) */
+#define THERMO_CUBIC_SHIFT      (14)
+#define THERMO_CUBIC_ONE        (1 << THERMO_CUBIC_SHIFT)
+
+/* Q15 difference of two samples from which the edge-aware mode takes the
+   sharpened weight in full (1/4 of the temperature range) */
+#define THERMO_EDGE_SHIFT       (2)
+
+/** Interpolation of the resampler */
+enum ThermoResampleMode {
+    THERMO_RESAMPLE_LINEAR = 0,     // liner_interpolation()
+    THERMO_RESAMPLE_CUBIC  = 1,     // Catmull-Rom spline through the source samples
+    THERMO_RESAMPLE_EDGE   = 2,     // linear, steeper between samples of a strong edge
+};
+
+/** One output position of a resampling axis */
+struct ThermoResampleTap {
+    uint16_t index;     // source sample on the left (index + 1 is the right one)
+    uint16_t weight;    // Q15 weight of the right source sample
+    uint16_t sharp;     // Q15 smoothstep of weight, the weight across an edge
+};
+
+/** One output position of a cubic resampling axis */
+struct ThermoCubicTap {
+    uint8_t index[4];   // source samples, repeated at the borders
+    int16_t weight[4];  // Q14 Catmull-Rom weights (sum THERMO_CUBIC_ONE)
+};
+
+/* Q15 position of output pos between the source samples around it (0 on a sample) */
+static constexpr int thermo_resample_t(int in, int out, int pos, int* p_seg)
+{
+    int seg = 1;
+    while ((seg < (in - 1)) && (((out - 1) * seg / (in - 1)) < pos)) {
+        seg++;
+    }
+    int start = (out - 1) * (seg - 1) / (in - 1);
+    int goal  = (out - 1) * (seg    ) / (in - 1);
+    int delta = goal - start;
+
+    *p_seg = seg;
+    return (delta > 0) ? ((((pos - start) << THERMO_Q15_SHIFT) + (delta / 2)) / delta) : 0;
+}
+
+/** Index/weight table of one axis, built at compile time
+ *
+ *  The knot positions are the same as liner_interpolation():
+ *  source sample i lands on output (OUT - 1) * i / (IN - 1).
+ *  A single source sample (1-row or 1-column sensors) is repeated.
+ */
+template <int IN, int OUT>
+struct ThermoResampleAxis {
+    static_assert(IN >= 1, "empty source");
+    static_assert(OUT >= 1, "empty output");
+
+    ThermoResampleTap tap[OUT];   // weight 0: only index is read
+
+    constexpr ThermoResampleAxis() : tap()
+    {
+        for (int pos = 0; pos < OUT; pos++) {
+            int seg = 1;
+            if (IN == 1) {
+                tap[pos].index  = 0;
+                tap[pos].weight = 0;
+                tap[pos].sharp  = 0;
+                continue;
+            }
+            int64_t t = thermo_resample_t(IN, OUT, pos, &seg);
+            int64_t t2 = (t * t) >> THERMO_Q15_SHIFT;
+
+            tap[pos].index  = (uint16_t)(seg - 1);
+            tap[pos].weight = (uint16_t)t;
+            tap[pos].sharp  = (uint16_t)((3 * t2) - ((2 * t2 * t) >> THERMO_Q15_SHIFT));
+        }
+    }
+};
+
+/** Catmull-Rom weight table of one axis, built at compile time
+ *
+ *  Same knot positions as ThermoResampleAxis, the spline goes through the
+ *  source samples. The outer samples are repeated at the borders.
+ */
+template <int IN, int OUT>
+struct ThermoCubicAxis {
+    static_assert(IN >= 1, "empty source");
+    static_assert(OUT >= 1, "empty output");
+    static_assert(IN <= 256, "source index is 8 bits");
+
+    ThermoCubicTap tap[OUT];
+
+    constexpr ThermoCubicAxis() : tap()
+    {
+        for (int pos = 0; pos < OUT; pos++) {
+            int seg = 1;
+            int64_t t = (IN == 1) ? 0 : thermo_resample_t(IN, OUT, pos, &seg);
+            int64_t t2 = (t * t) >> THERMO_Q15_SHIFT;
+            int64_t t3 = (t2 * t) >> THERMO_Q15_SHIFT;
+            // Q15 -> Q14 is the / 2 of the Catmull-Rom basis, rounded
+            int64_t w0 = ((-t3 + (2 * t2) - t) + 2) >> 2;
+            int64_t w2 = (((-3 * t3) + (4 * t2) + t) + 2) >> 2;
+            int64_t w3 = ((t3 - t2) + 2) >> 2;
+
+            for (int k = 0; k < 4; k++) {
+                int index = seg - 2 + k;
+                tap[pos].index[k] = (uint8_t)((index < 0) ? 0 : ((index > (IN - 1)) ? (IN - 1) : index));
+            }
+            tap[pos].weight[0] = (int16_t)w0;
+            tap[pos].weight[1] = (int16_t)(THERMO_CUBIC_ONE - (w0 + w2 + w3));
+            tap[pos].weight[2] = (int16_t)w2;
+            tap[pos].weight[3] = (int16_t)w3;
+        }
+    }
+};
+
+/** Index/weight tables of a fixed source and output size */
+template <int IN_W, int IN_H, int OUT_W, int OUT_H>
+struct ThermoResampleTable {
+    ThermoResampleAxis<IN_W, OUT_W> x;
+    ThermoResampleAxis<IN_H, OUT_H> y;
+};
+
+/** Catmull-Rom weight tables of a fixed source and output size */
+template <int IN_W, int IN_H, int OUT_W, int OUT_H>
+struct ThermoCubicTable {
+    ThermoCubicAxis<IN_W, OUT_W> x;
+    ThermoCubicAxis<IN_H, OUT_H> y;
+};
+
+/** Fixed-point resampler
+ *
+ *  Expands a Q15 grid with precomputed index/weight tables. In the linear
+ *  mode the result equals liner_interpolation() within the Q15 rounding
+ *  error. The cubic mode needs a ThermoCubicTable and clamps the overshoot
+ *  of the spline to 0.0-1.0. The edge-aware mode moves the linear weight
+ *  to its smoothstep as the difference of the two samples grows, so strong
+ *  edges stay steep and flat areas stay linear.
+ *
+ *  The output rows are blended with NEON when the compiler targets it.
+ *
+ * Example:
+ * @code
+ *
+ * static constexpr ThermoResampleTable<4, 4, 160, 120> table160x120{};
+ * static constexpr ThermoCubicTable<4, 4, 160, 120> cubic160x120{};
+ * static const ThermoResampler resampler160x120(table160x120, cubic160x120);
+ *
+ * resampler160x120.resample(&grid4x4[0][0], &grid160x120[0][0], &rows[0], THERMO_RESAMPLE_CUBIC);
+ * @endcode
+ */
+class ThermoResampler
+{
+public:
+    /** Create a resampler which refers to a table
+     *
+     *  @param table index/weight table (must outlive the resampler)
+     */
+    template <int IN_W, int IN_H, int OUT_W, int OUT_H>
+    constexpr ThermoResampler(const ThermoResampleTable<IN_W, IN_H, OUT_W, OUT_H>& table) :
+        mTapX(table.x.tap), mTapY(table.y.tap), mCubicX(nullptr), mCubicY(nullptr),
+        mInW(IN_W), mInH(IN_H), mOutW(OUT_W), mOutH(OUT_H)
+    {
+    }
+
+    /** Create a resampler which also has the cubic mode
+     *
+     *  @param table index/weight table (must outlive the resampler)
+     *  @param cubic Catmull-Rom weight table of the same sizes (must outlive the resampler)
+     */
+    template <int IN_W, int IN_H, int OUT_W, int OUT_H>
+    constexpr ThermoResampler(const ThermoResampleTable<IN_W, IN_H, OUT_W, OUT_H>& table,
+                              const ThermoCubicTable<IN_W, IN_H, OUT_W, OUT_H>& cubic) :
+        mTapX(table.x.tap), mTapY(table.y.tap), mCubicX(cubic.x.tap), mCubicY(cubic.y.tap),
+        mInW(IN_W), mInH(IN_H), mOutW(OUT_W), mOutH(OUT_H)
+    {
+    }
+
+    int in_width(void) const { return mInW; }
+    int in_height(void) const { return mInH; }
+    int out_width(void) const { return mOutW; }
+    int out_height(void) const { return mOutH; }
+
+    /** Table entry of output row y */
+    const ThermoResampleTap& tap_y(int y) const { return mTapY[y]; }
+
+    /** The mode itself if the resampler has it, otherwise THERMO_RESAMPLE_LINEAR */
+    ThermoResampleMode supported(ThermoResampleMode mode) const
+    {
+        return ((mode == THERMO_RESAMPLE_CUBIC) && (mCubicX == nullptr)) ? THERMO_RESAMPLE_LINEAR : mode;
+    }
+
+    /** Expand every source row in x direction
+     *
+     *  @param p_in   source grid [in_height][in_width]
+     *  @param p_rows output rows [in_height][out_width]
+     *  @param mode   interpolation (see supported)
+     */
+    void expand_rows(const uint16_t* p_in, uint16_t* p_rows, ThermoResampleMode mode = THERMO_RESAMPLE_LINEAR) const;
+
+    /** Compute one output row from the rows of expand_rows()
+     *
+     *  @param p_rows rows [in_height][out_width]
+     *  @param y      output row number
+     *  @param p_out  output row [out_width]
+     *  @param mode   interpolation, the mode of expand_rows
+     */
+    void blend_row(const uint16_t* p_rows, int y, uint16_t* p_out, ThermoResampleMode mode = THERMO_RESAMPLE_LINEAR) const;
+
+    /** Compute columns x0 to x1 - 1 of one output row
+     *
+     *  @param p_rows rows [in_height][out_width]
+     *  @param y      output row number
+     *  @param x0     first column
+     *  @param x1     column after the last one
+     *  @param p_out  output row [out_width], only x0 to x1 - 1 are written
+     *  @param mode   interpolation, the mode of expand_rows
+     */
+    void blend_span(const uint16_t* p_rows, int y, int x0, int x1, uint16_t* p_out,
+                    ThermoResampleMode mode = THERMO_RESAMPLE_LINEAR) const;
+
+    /** Expand a whole grid
+     *
+     *  @param p_in   source grid [in_height][in_width]
+     *  @param p_out  output grid [out_height][out_width]
+     *  @param p_rows work area [in_height][out_width]
+     *  @param mode   interpolation (see supported)
+     */
+    void resample(const uint16_t* p_in, uint16_t* p_out, uint16_t* p_rows, ThermoResampleMode mode = THERMO_RESAMPLE_LINEAR) const;
+
+private:
+    const ThermoResampleTap* mTapX;
+    const ThermoResampleTap* mTapY;
+    const ThermoCubicTap* mCubicX;      // nullptr: no cubic mode
+    const ThermoCubicTap* mCubicY;
+    int mInW;
+    int mInH;
+    int mOutW;
+    int mOutH;
+};
+
+#endif
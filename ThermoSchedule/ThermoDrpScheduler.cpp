@@ -0,0 +1,244 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ThermoCycle.h"
+#include "ThermoDrpScheduler.h"
+
+ThermoDrpScheduler::ThermoDrpScheduler(ThermoHalDrp& drp, const ThermoDrpLibrary& isp, uint32_t period_us) :
+    mDrp(drp), mIsp(isp), mThermalOk(true), mIspId(0), mJobParam(NULL), mJobSize(0), mWaitCycles(0),
+    mCalibrate(0), mLastFrame(0), mFrameSeen(false)
+{
+    mThermal.p_config  = NULL;
+    mThermal.top_tiles = 0;
+    mThermal.pattern   = 0;
+    memset(&mStats, 0, sizeof(mStats));
+    mStats.camera_us = period_us;
+}
+
+bool ThermoDrpScheduler::start(void)
+{
+    if (!mDrp.initialize()) {
+        return false;
+    }
+    return load_isp();
+}
+
+bool ThermoDrpScheduler::camera_frame(void* p_param, uint32_t size)
+{
+    uint32_t frame_start = thermo_cycle_read();
+    uint32_t flags;
+    uint32_t used_us;
+    bool ok;
+
+    if (mFrameSeen) {
+        mean(&mStats.camera_us, to_us(frame_start - mLastFrame));
+    }
+    mLastFrame  = frame_start;
+    mFrameSeen  = true;
+
+    ok = mDrp.run(mIspId, p_param, size);
+    mean(&mStats.isp_us, to_us(thermo_cycle_read() - frame_start));
+    mStats.camera_frames++;
+
+    // take a waiting job, run_thermal can not take it back from here on
+    flags = mFlags.wait_any(FLAG_PENDING, 0);
+    if ((flags & osFlagsError) != 0) {
+        return ok;
+    }
+
+    used_us = to_us(thermo_cycle_read() - frame_start);
+    if (!has_thermal() || !fits(used_us)) {
+        mStats.rejected++;
+        mFlags.set(FLAG_REJECT);
+        return ok;
+    }
+    mFlags.set(run_job() ? FLAG_DONE : FLAG_REJECT);
+    return ok;
+}
+
+bool ThermoDrpScheduler::run_thermal(void* p_param, uint32_t size, uint32_t timeout_ms)
+{
+    uint32_t start = thermo_cycle_read();
+    uint32_t flags;
+
+    mWaitCycles = 0;
+    if (!has_thermal()) {
+        return false;
+    }
+    if (mCalibrate == 0) {
+        mCalibrate = THERMO_DRP_CALIBRATE - 1;
+        return false;
+    }
+    mCalibrate--;
+    if (slower() && (mCalibrate != (THERMO_DRP_CALIBRATE / 2))) {
+        // the wait costs more than the CPU saves, the DRP side stays measured
+        mStats.slower++;
+        return false;
+    }
+    if (!fits(mStats.isp_us)) {
+        // the ISP leaves no time for a job, no need to wait for a camera frame
+        mStats.rejected++;
+        return false;
+    }
+
+    mJobParam = p_param;
+    mJobSize  = size;
+    mFlags.clear(FLAG_DONE | FLAG_REJECT);
+    mFlags.set(FLAG_PENDING);
+
+    flags = mFlags.wait_any(FLAG_DONE | FLAG_REJECT, timeout_ms);
+    if ((flags & osFlagsError) != 0) {
+        if ((mFlags.clear(FLAG_PENDING) & FLAG_PENDING) != 0) {
+            // not taken by the DRP thread, the CPU does it
+            mStats.timeouts++;
+            mWaitCycles = thermo_cycle_read() - start;
+            return false;
+        }
+        // taken just now, the DRP thread ends it soon
+        flags = mFlags.wait_any(FLAG_DONE | FLAG_REJECT);
+    }
+    mWaitCycles = thermo_cycle_read() - start;
+    return (flags & FLAG_DONE) != 0;
+}
+
+void ThermoDrpScheduler::record_frame(uint32_t cycles, bool on_drp)
+{
+    if (on_drp) {
+        // the render thread waited for the DRP thread, the frame was not shown earlier
+        mean(&mStats.wait_us, to_us(mWaitCycles));
+        mean(&mStats.drp_cpu_us, to_us(cycles));
+    } else {
+        // a wait which ended on the CPU is not part of the CPU time
+        cycles -= (mWaitCycles < cycles) ? mWaitCycles : cycles;
+        mean(&mStats.cpu_us, to_us(cycles));
+    }
+}
+
+ThermoDrpStats ThermoDrpScheduler::stats(void) const
+{
+    ThermoDrpStats result = mStats;
+
+    if ((result.cpu_us != 0) && (result.drp_cpu_us != 0) && (result.cpu_us > result.drp_cpu_us)) {
+        result.saved_us = result.cpu_us - result.drp_cpu_us;
+    } else {
+        result.saved_us = 0;
+    }
+    return result;
+}
+
+void ThermoDrpScheduler::reset_stats(void)
+{
+    mStats.camera_frames = 0;
+    mStats.jobs          = 0;
+    mStats.rejected      = 0;
+    mStats.failed        = 0;
+    mStats.timeouts      = 0;
+    mStats.slower        = 0;
+}
+
+bool ThermoDrpScheduler::fits(uint32_t used_us) const
+{
+    uint32_t budget_us = mStats.camera_us - ((mStats.camera_us * THERMO_DRP_MARGIN) / 8);
+
+    return (used_us + mStats.switch_us + mStats.job_us) <= budget_us;
+}
+
+bool ThermoDrpScheduler::slower(void) const
+{
+    return (mStats.cpu_us != 0) && (mStats.drp_cpu_us != 0) && (mStats.drp_cpu_us >= mStats.cpu_us);
+}
+
+bool ThermoDrpScheduler::load_isp(void)
+{
+    uint8_t id[THERMO_DRP_TILE_NUM];
+
+    if (!mDrp.load(mIsp.p_config, mIsp.top_tiles, mIsp.pattern, id)) {
+        mIspId = 0;
+        return false;
+    }
+    mIspId = first_id(id, mIsp.top_tiles);
+    return true;
+}
+
+bool ThermoDrpScheduler::run_job(void)
+{
+    uint8_t  id[THERMO_DRP_TILE_NUM];
+    uint8_t  thermal_id;
+    uint32_t start = thermo_cycle_read();
+    uint32_t job_start;
+    uint32_t job_end;
+    bool     ok;
+
+    // the thermal library takes the tiles of the ISP until the job is done
+    mDrp.unload(mIspId);
+    if (!mDrp.load(mThermal.p_config, mThermal.top_tiles, mThermal.pattern, id)) {
+        mThermalOk = false;
+        mStats.failed++;
+        load_isp();
+        return false;
+    }
+    thermal_id = first_id(id, mThermal.top_tiles);
+
+    job_start = thermo_cycle_read();
+    ok = mDrp.run(thermal_id, mJobParam, mJobSize);
+    job_end = thermo_cycle_read();
+
+    mDrp.unload(thermal_id);
+    load_isp();
+    if (!ok) {
+        mStats.failed++;
+        return false;
+    }
+    mean(&mStats.job_us, to_us(job_end - job_start));
+    mean(&mStats.switch_us, to_us((thermo_cycle_read() - start) - (job_end - job_start)));
+    mStats.jobs++;
+    return true;
+}
+
+uint8_t ThermoDrpScheduler::first_id(const uint8_t* p_id, uint8_t top_tiles)
+{
+    int tile;
+
+    for (tile = 0; tile < THERMO_DRP_TILE_NUM; tile++) {
+        if ((top_tiles & (1 << tile)) != 0) {
+            return p_id[tile];
+        }
+    }
+    return 0;
+}
+
+uint32_t ThermoDrpScheduler::to_us(uint32_t cycles)
+{
+    return (uint32_t)(((uint64_t)cycles * 1000000u) / thermo_cycle_hz());
+}
+
+void ThermoDrpScheduler::mean(uint32_t* p_mean, uint32_t sample)
+{
+    if (*p_mean == 0) {
+        *p_mean = sample;
+        return;
+    }
+    *p_mean = (uint32_t)((int64_t)*p_mean + (((int64_t)sample - (int64_t)*p_mean) >> THERMO_DRP_MEAN_SHIFT));
+}
@@ -0,0 +1,190 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_DRP_SCHEDULER_H
+#define THERMO_DRP_SCHEDULER_H
+
+#include "mbed.h"
+#include "ThermoHalDrp.h"
+
+/* Tiles of the DRP (R_DK2_TILE_NUM) */
+#define THERMO_DRP_TILE_NUM     (6)
+
+/* Every n-th thermal job is done on the CPU to measure the CPU time saved */
+#define THERMO_DRP_CALIBRATE    (32)
+
+/* Share of the camera period kept free after a thermal job [1/8] */
+#define THERMO_DRP_MARGIN       (1)
+
+/* Weight of a new sample in the running means [1/2^n] */
+#define THERMO_DRP_MEAN_SHIFT   (3)
+
+/** A library and the tiles it is loaded on (values of R_DK2_Load) */
+struct ThermoDrpLibrary {
+    const uint8_t* p_config;    // configuration data, NULL: no library
+    uint8_t top_tiles;          // R_DK2_TILE_n
+    uint32_t pattern;           // R_DK2_TILE_PATTERN_n
+};
+
+/** DRP sharing counters (times are running means [us]) */
+struct ThermoDrpStats {
+    uint32_t camera_frames;     // ISP runs
+    uint32_t camera_us;         // camera frame period
+    uint32_t isp_us;            // ISP run
+    uint32_t jobs;              // thermal jobs run on the DRP
+    uint32_t rejected;          // thermal jobs left to the CPU (no time before the next camera frame)
+    uint32_t failed;            // thermal jobs which did not load or run
+    uint32_t timeouts;          // thermal jobs not taken in time (no camera frame)
+    uint32_t slower;            // thermal jobs left to the CPU (DRP frames took longer, wait included)
+    uint32_t job_us;            // DRP time of a thermal job
+    uint32_t switch_us;         // loading the thermal library and the ISP again
+    uint32_t wait_us;           // wait of the caller of run_thermal
+    uint32_t cpu_us;            // render time of a frame expanded on the CPU
+    uint32_t drp_cpu_us;        // render time of a frame expanded on the DRP, the wait included
+    uint32_t saved_us;          // render time saved per frame expanded on the DRP
+};
+
+/** Time-sharing of the DRP tiles between the camera ISP and thermal jobs
+ *
+ *  The ISP library stays loaded. A thermal job (e.g. resizing the 8-bit
+ *  index grid of the thermograph) is run by the DRP thread right after the
+ *  ISP of a camera frame: the ISP is unloaded, the thermal library is
+ *  loaded and run, then the ISP is loaded again. The job is only taken
+ *  when the measured load and run times fit before the next camera frame,
+ *  otherwise the caller does the work on the CPU (at once when the ISP
+ *  alone leaves no time, without waiting for a camera frame). Every
+ *  THERMO_DRP_CALIBRATE-th job is left to the CPU as well, so the time
+ *  saved per frame stays measured. The caller blocks until the job ran,
+ *  so a frame expanded on the DRP counts that wait; while such frames take
+ *  longer than those on the CPU, only one job of THERMO_DRP_CALIBRATE is
+ *  given to the DRP.
+ *
+ * Example:
+ * @code
+ *
+ * ThermoDrpScheduler drp_scheduler(hal_drp, isp_library, 33333);
+ *
+ * void drp_task() {                    // DRP thread
+ *     drp_scheduler.start();
+ *     while (1) {
+ *         wait_camera_frame();
+ *         drp_scheduler.camera_frame(&param_isp, sizeof(param_isp));
+ *     }
+ * }
+ *
+ * if (!drp_scheduler.run_thermal(&param_resize, sizeof(param_resize), 67)) {
+ *     expand_on_cpu();                 // main thread
+ * }
+ * @endcode
+ */
+class ThermoDrpScheduler
+{
+public:
+    /** Create a scheduler
+     *
+     *  @param drp       DRP (must outlive the scheduler)
+     *  @param isp       camera ISP library
+     *  @param period_us camera frame period until it is measured
+     */
+    ThermoDrpScheduler(ThermoHalDrp& drp, const ThermoDrpLibrary& isp, uint32_t period_us);
+
+    /** Set the library of the thermal jobs (before start) */
+    void set_thermal(const ThermoDrpLibrary& thermal) { mThermal = thermal; }
+
+    /** True if thermal jobs can be run */
+    bool has_thermal(void) const { return (mThermal.p_config != NULL) && mThermalOk; }
+
+    /** Initialize the DRP and load the ISP (DRP thread)
+     *
+     *  @return true on success, false on failure
+     */
+    bool start(void);
+
+    /** Run the ISP of a camera frame, then a waiting thermal job if it fits (DRP thread)
+     *
+     *  @param p_param parameter structure of the ISP
+     *  @param size    size of the parameter structure
+     *  @return true if the ISP ran
+     */
+    bool camera_frame(void* p_param, uint32_t size);
+
+    /** Run a thermal job after the next camera frame and wait for it
+     *
+     *  The caller waits for the next camera frame and the job, a camera
+     *  period and the job time on average, so timeout_ms of two camera
+     *  periods is enough.
+     *
+     *  @param p_param    parameter structure of the thermal library (valid until the return)
+     *  @param size       size of the parameter structure
+     *  @param timeout_ms longest wait for the DRP thread to take the job
+     *  @return true if the DRP ran the job, false to do it on the CPU
+     */
+    bool run_thermal(void* p_param, uint32_t size, uint32_t timeout_ms);
+
+    /** Record the CPU time of a frame whose grid was expanded
+     *
+     *  @param cycles CPU cycles of the frame, the wait in run_thermal included
+     *                (only counted for a frame expanded on the DRP)
+     *  @param on_drp true if the DRP expanded the grid
+     */
+    void record_frame(uint32_t cycles, bool on_drp);
+
+    /** Sharing counters since start or reset_stats */
+    ThermoDrpStats stats(void) const;
+
+    /** Clear the counters (the running means are kept) */
+    void reset_stats(void);
+
+private:
+    enum {
+        FLAG_PENDING = (1 << 0),    // job waiting for the DRP thread
+        FLAG_DONE    = (1 << 1),    // job ran on the DRP
+        FLAG_REJECT  = (1 << 2),    // job left to the CPU
+    };
+
+    ThermoHalDrp& mDrp;
+    ThermoDrpLibrary mIsp;
+    ThermoDrpLibrary mThermal;
+    bool mThermalOk;                // false after the thermal library failed
+    uint8_t mIspId;
+    EventFlags mFlags;
+    void* mJobParam;
+    uint32_t mJobSize;
+    uint32_t mWaitCycles;           // wait of the last run_thermal
+    int mCalibrate;                 // jobs until the next one on the CPU
+    uint32_t mLastFrame;            // cycle count of the last camera frame
+    bool mFrameSeen;
+    ThermoDrpStats mStats;
+
+    bool fits(uint32_t used_us) const;
+    bool slower(void) const;
+    bool load_isp(void);
+    bool run_job(void);
+    static uint8_t first_id(const uint8_t* p_id, uint8_t top_tiles);
+    static uint32_t to_us(uint32_t cycles);
+    static void mean(uint32_t* p_mean, uint32_t sample);
+};
+
+#endif
@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ThermoFrameScheduler.h"
+
+ThermoFrameScheduler::ThermoFrameScheduler(uint32_t period_ms) :
+    mPeriodMs((period_ms == 0) ? 1 : period_ms), mNext(0), mFrameStart(0), mDegrade(0), mRecover(0)
+{
+    reset_stats();
+}
+
+void ThermoFrameScheduler::start(void)
+{
+    mNext = Kernel::get_ms_count();
+    mFrameStart = mNext;
+    mStats.frames = 1;
+}
+
+uint32_t ThermoFrameScheduler::wait_next(void)
+{
+    uint64_t now = Kernel::get_ms_count();
+    uint64_t work = now - mFrameStart;
+    uint32_t dropped = 0;
+
+    mStats.work_last_ms = (uint32_t)work;
+    if (mStats.work_last_ms > mStats.work_max_ms) {
+        mStats.work_max_ms = mStats.work_last_ms;
+    }
+
+    mNext += mPeriodMs;
+    if (now > mNext) {
+        // overrun: start on the next deadline still ahead, do not pile up
+        dropped = (uint32_t)((now - mNext) / mPeriodMs) + 1;
+        mNext += (uint64_t)dropped * mPeriodMs;
+        mStats.overruns++;
+        mStats.skipped += dropped;
+        if (mDegrade < THERMO_SCHEDULER_MAX_DEGRADE) {
+            mDegrade++;
+        }
+        mRecover = 0;
+    } else if ((work * 2) < mPeriodMs) {
+        mRecover++;
+        if ((mRecover >= THERMO_SCHEDULER_RECOVER) && (mDegrade > 0)) {
+            mDegrade--;
+            mRecover = 0;
+        }
+    } else {
+        mRecover = 0;
+    }
+
+    ThisThread::sleep_until(mNext);
+
+    mFrameStart = Kernel::get_ms_count();
+    mStats.jitter_last_ms = (mFrameStart > mNext) ? (uint32_t)(mFrameStart - mNext) : 0;
+    if (mStats.jitter_last_ms > mStats.jitter_max_ms) {
+        mStats.jitter_max_ms = mStats.jitter_last_ms;
+    }
+    mStats.frames++;
+    return dropped;
+}
+
+ThermoPacingStats ThermoFrameScheduler::stats(void) const
+{
+    ThermoPacingStats stats = mStats;
+
+    stats.degrade = mDegrade;
+    return stats;
+}
+
+void ThermoFrameScheduler::reset_stats(void)
+{
+    memset(&mStats, 0, sizeof(mStats));
+}
@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_FRAME_SCHEDULER_H
+#define THERMO_FRAME_SCHEDULER_H
+
+#include "mbed.h"
+
+/* Frames under half the period before the degrade level goes down */
+#define THERMO_SCHEDULER_RECOVER    (10)
+
+/* Highest degrade level */
+#define THERMO_SCHEDULER_MAX_DEGRADE    (8)
+
+/** Frame pacing counters [ms] */
+struct ThermoPacingStats {
+    uint32_t frames;        // frames started
+    uint32_t overruns;      // frames which took longer than the period
+    uint32_t skipped;       // deadlines dropped after the overruns
+    uint32_t work_last_ms;  // time of the last frame
+    uint32_t work_max_ms;
+    uint32_t jitter_last_ms;    // wake up after the deadline
+    uint32_t jitter_max_ms;
+    int degrade;            // current degrade level
+};
+
+/** Absolute-deadline frame pacing
+ *
+ *  Frame n starts at start + n * period, the time of a frame does not shift
+ *  the next one. A frame which overruns the period drops the deadlines that
+ *  have already passed (no catching up) and raises the degrade level, which
+ *  the caller uses to lower the work (e.g. the resolution). After
+ *  THERMO_SCHEDULER_RECOVER frames under half the period, the level goes
+ *  down one step again.
+ *
+ * Example:
+ * @code
+ *
+ * ThermoFrameScheduler scheduler(200);
+ *
+ * int main() {
+ *     scheduler.start();
+ *     while (1) {
+ *         render(scheduler.degrade());
+ *         scheduler.wait_next();
+ *     }
+ * }
+ * @endcode
+ */
+class ThermoFrameScheduler
+{
+public:
+    /** Create a scheduler
+     *
+     *  @param period_ms frame period (1000 / target fps)
+     */
+    ThermoFrameScheduler(uint32_t period_ms);
+
+    /** Set the first deadline to now */
+    void start(void);
+
+    /** End a frame and sleep until the next deadline
+     *
+     *  @return number of deadlines dropped because this frame overran
+     */
+    uint32_t wait_next(void);
+
+    /** Degrade level of the next frame (0: full work) */
+    int degrade(void) const { return mDegrade; }
+
+    uint32_t period_ms(void) const { return mPeriodMs; }
+
+    /** Pacing counters since start or reset_stats */
+    ThermoPacingStats stats(void) const;
+
+    /** Clear the pacing counters */
+    void reset_stats(void);
+
+private:
+    uint32_t mPeriodMs;
+    uint64_t mNext;         // deadline of the frame in progress
+    uint64_t mFrameStart;
+    int mDegrade;
+    int mRecover;           // frames under half the period in a row
+    ThermoPacingStats mStats;
+};
+
+#endif
@@ -0,0 +1,244 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ThermoAcquisition.h"
+
+#define SETUP_DELAY     (150)   // wait after setup before the first reading
+#define READ_MARGIN     (50)    // thread wakeup and clock stretching on top of the bus time
+
+#define FLG_READ_OK     (0x00000001)
+#define FLG_READ_NG     (0x00000002)
+
+ThermoAcquisition::ThermoAcquisition(uint32_t period_ms, osPriority priority, uint32_t stack_size) :
+    mPeriodMs(period_ms), mThread(priority, stack_size), mSlotNum(0), mProfiler(NULL), mProfileStage(0)
+{
+}
+
+bool ThermoAcquisition::add(ThermoSensorDevice& device, uint16_t id)
+{
+    Slot* p_slot;
+
+    if (mSlotNum >= THERMO_ACQUISITION_MAX_SENSOR) {
+        return false;
+    }
+    p_slot = &mSlot[mSlotNum];
+    p_slot->device = &device;
+    p_slot->id = id;
+    p_slot->errors = 0;
+    p_slot->ready = false;
+    p_slot->filter = NULL;
+    p_slot->timeout_ms = READ_MARGIN;
+    memset(&p_slot->frame, 0, sizeof(p_slot->frame));
+    p_slot->frame.sensor_id = id;
+    mSlotNum++;
+    return true;
+}
+
+bool ThermoAcquisition::set_filter(uint16_t id, ThermoFrameFilter* p_filter)
+{
+    Slot* p_slot = (Slot*)find(id);
+
+    if (p_slot == NULL) {
+        return false;
+    }
+    p_slot->filter = p_filter;
+    return true;
+}
+
+void ThermoAcquisition::set_profiler(ThermoProfiler* p_profiler, int stage)
+{
+    mProfiler = p_profiler;
+    mProfileStage = stage;
+}
+
+void ThermoAcquisition::start(void)
+{
+    uint32_t read_ms = 0;
+    uint32_t time_ms;
+    int i;
+
+    // e.g. 38 bytes of D6T-44L-06 take 3.4ms at 100kHz, 2054 bytes of D6T-32L-01A 185ms
+    for (i = 0; i < mSlotNum; i++) {
+        time_ms = (mSlot[i].device->read_time_us() + 999) / 1000;
+        mSlot[i].timeout_ms = (time_ms * 3 / 2) + READ_MARGIN;
+        read_ms += time_ms;
+    }
+    if (mPeriodMs < read_ms) {
+        mPeriodMs = read_ms;
+    }
+    mThread.start(callback(this, &ThermoAcquisition::task));
+}
+
+bool ThermoAcquisition::latest(uint16_t id, ThermoFrame& frame) const
+{
+    const Slot* p_slot = find(id);
+
+    if (p_slot == NULL) {
+        return false;
+    }
+    return p_slot->ring.latest(frame);
+}
+
+bool ThermoAcquisition::read(uint16_t id, uint32_t& cursor, ThermoFrame& frame) const
+{
+    const Slot* p_slot = find(id);
+
+    if (p_slot == NULL) {
+        return false;
+    }
+    return p_slot->ring.read(cursor, frame);
+}
+
+bool ThermoAcquisition::read_raw(uint16_t id, uint32_t& cursor, ThermoFrame& frame) const
+{
+    const Slot* p_slot = find(id);
+
+    if (p_slot == NULL) {
+        return false;
+    }
+    if (p_slot->filter == NULL) {
+        return p_slot->ring.read(cursor, frame);
+    }
+    return p_slot->raw_ring.read(cursor, frame);
+}
+
+uint32_t ThermoAcquisition::errors(uint16_t id) const
+{
+    const Slot* p_slot = find(id);
+
+    if (p_slot == NULL) {
+        return 0;
+    }
+    return p_slot->errors;
+}
+
+bool ThermoAcquisition::ready(uint16_t id) const
+{
+    const Slot* p_slot = find(id);
+
+    if (p_slot == NULL) {
+        return false;
+    }
+    return p_slot->ready;
+}
+
+void ThermoAcquisition::task(void)
+{
+    uint64_t next;
+    int i;
+
+    for (i = 0; i < mSlotNum; i++) {
+        mSlot[i].ready = mSlot[i].device->setup();
+    }
+    ThisThread::sleep_for(SETUP_DELAY);
+
+    next = Kernel::get_ms_count();
+    while (true) {
+        // one pass over the bus queue, a failed sensor waits for the next period
+        for (i = 0; i < mSlotNum; i++) {
+            Slot& slot = mSlot[i];
+            uint32_t start;
+            bool result;
+
+            // a failed setup is tried again, the first reading follows a period later
+            if (!slot.ready) {
+                slot.ready = slot.device->setup();
+                slot.errors++;
+                continue;
+            }
+            start = thermo_cycle_read();
+            result = read_frame(slot);
+
+            if (result != false) {
+                if (slot.filter != NULL) {
+                    mRaw = slot.frame;
+                    slot.filter->apply(slot.frame);
+                } else {
+                    memset(slot.frame.changed, 0xFF, sizeof(slot.frame.changed));
+                }
+                mHistogram.measure(slot.frame);
+            }
+            if (mProfiler != NULL) {
+                mProfiler->record(mProfileStage, thermo_cycle_read() - start);
+            }
+            if (result == false) {
+                slot.errors++;
+                continue;
+            }
+            slot.frame.sequence++;
+            slot.frame.timestamp_ms = (uint32_t)Kernel::get_ms_count();
+            if (slot.filter != NULL) {
+                mRaw.sequence = slot.frame.sequence;
+                mRaw.timestamp_ms = slot.frame.timestamp_ms;
+                mRaw.stats = slot.frame.stats;
+                memset(mRaw.changed, 0xFF, sizeof(mRaw.changed));
+                slot.raw_ring.push(mRaw);
+            }
+            slot.ring.push(slot.frame);
+        }
+
+        // absolute period: the reading time does not shift the next reading
+        next += mPeriodMs;
+        if (next < Kernel::get_ms_count()) {
+            next = Kernel::get_ms_count();
+        }
+        ThisThread::sleep_until(next);
+    }
+}
+
+bool ThermoAcquisition::read_frame(Slot& slot)
+{
+    uint32_t flags;
+
+    mFlags.clear(FLG_READ_OK | FLG_READ_NG);
+    if (slot.device->read_async(&slot.frame.ptat, &slot.frame.pixel[0],
+                                callback(this, &ThermoAcquisition::read_done)) == false) {
+        return false;
+    }
+
+    flags = mFlags.wait_any(FLG_READ_OK | FLG_READ_NG, slot.timeout_ms);
+    if ((flags & osFlagsError) != 0) {
+        slot.device->abort_async();
+        return false;
+    }
+    return (flags & FLG_READ_OK) != 0;
+}
+
+void ThermoAcquisition::read_done(bool result)
+{
+    mFlags.set(result ? FLG_READ_OK : FLG_READ_NG);
+}
+
+const ThermoAcquisition::Slot* ThermoAcquisition::find(uint16_t id) const
+{
+    int i;
+
+    for (i = 0; i < mSlotNum; i++) {
+        if (mSlot[i].id == id) {
+            return &mSlot[i];
+        }
+    }
+    return NULL;
+}
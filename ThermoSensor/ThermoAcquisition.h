@@ -0,0 +1,202 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_ACQUISITION_H
+#define THERMO_ACQUISITION_H
+
+#include "mbed.h"
+#include "ThermoFrame.h"
+#include "ThermoFrameRing.h"
+#include "ThermoFrameFilter.h"
+#include "ThermoFrameHistogram.h"
+#include "ThermoSensorDevice.h"
+#include "ThermoProfiler.h"
+
+/* Number of frames kept for the readers (per sensor) */
+#define THERMO_ACQUISITION_RING     (4)
+
+/* Number of sensors of one bus */
+#ifndef THERMO_ACQUISITION_MAX_SENSOR
+#define THERMO_ACQUISITION_MAX_SENSOR   (4)
+#endif
+
+/* Stack of the acquisition thread [byte], enough for the I2C sensor devices */
+#define THERMO_ACQUISITION_STACK    (1024 * 2)
+
+/** Sensor acquisition thread of one I2C bus
+ *
+ *  Only this thread accesses the sensors of its bus. Every period the
+ *  sensors are read one after another in the order of add(), and each
+ *  reading is published as a timestamped ThermoFrame with the sensor ID
+ *  and the statistics of its pixels (ThermoFrame::stats).
+ *  The render loop and other readers take frames from the per-sensor rings
+ *  without waiting for the I2C bus. The thread itself sleeps while the I2C
+ *  transfer is in progress (ThermoSensorDevice::read_async).
+ *
+ *  Sensors on different buses should use different instances, so that their
+ *  transfers run in parallel (see ThermoSensorManager).
+ *
+ * Example:
+ * @code
+ *
+ * D6T_44L_06 d6t_44l(I2C_SDA, I2C_SCL);
+ * ThermoD6TDevice sensor(d6t_44l);
+ * ThermoAcquisition acquisition(100);
+ *
+ * int main() {
+ *     ThermoFrame frame;
+ *
+ *     acquisition.add(sensor, 0);
+ *     acquisition.start();
+ *     while (1) {
+ *         if (acquisition.latest(0, frame)) {
+ *             ...
+ *         }
+ *         ThisThread::sleep_for(200);
+ *     }
+ * }
+ * @endcode
+ */
+class ThermoAcquisition
+{
+public:
+    /** Create an acquisition instance
+     *
+     *  @param period_ms  reading period of every sensor
+     *  @param priority   thread priority
+     *  @param stack_size stack of the thread, more for devices which do file I/O (THERMO_REPLAY_STACK)
+     */
+    ThermoAcquisition(uint32_t period_ms, osPriority priority = osPriorityAboveNormal,
+                      uint32_t stack_size = THERMO_ACQUISITION_STACK);
+
+    /** Add a sensor of this bus (before start)
+     *
+     *  @param device sensor to read (must not be used by other threads)
+     *  @param id     sensor ID, written to the frames
+     *  @return true on success, false if THERMO_ACQUISITION_MAX_SENSOR is exceeded
+     */
+    bool add(ThermoSensorDevice& device, uint16_t id);
+
+    /** Filter the readings of a sensor before they are published (before start)
+     *
+     *  Without a filter every pixel of a frame is marked as changed.
+     *  @param id       sensor ID given to add
+     *  @param p_filter filter, only used by the acquisition thread (NULL: none)
+     *  @return true on success, false if the sensor is not read by this instance
+     */
+    bool set_filter(uint16_t id, ThermoFrameFilter* p_filter);
+
+    /** Change the percentiles of ThermoFrame::stats of every sensor (before start)
+     *
+     *  @param low  percentile of ThermoFrameStats::low (0-100)
+     *  @param high percentile of ThermoFrameStats::high (0-100)
+     */
+    void set_percentiles(int low, int high) { mHistogram.set_percentiles(low, high); }
+
+    /** Time every reading (I2C transfer, PEC check, decoding, filter and statistics) to a profiler stage (before start)
+     *
+     *  @param p_profiler profiler (NULL: no timing)
+     *  @param stage      stage number of the readings
+     */
+    void set_profiler(ThermoProfiler* p_profiler, int stage);
+
+    /** Start the acquisition thread
+     *
+     *  The reading timeout of each sensor follows from its bus time
+     *  (ThermoSensorDevice::read_time_us), so the bus frequency must be set
+     *  before. When the readings of all sensors take longer than the period,
+     *  the period is stretched to fit them (see period_ms).
+     */
+    void start(void);
+
+    /** Reading period after start [ms] */
+    uint32_t period_ms(void) const { return mPeriodMs; }
+
+    /** Check whether a sensor is read by this instance */
+    bool has(uint16_t id) const { return find(id) != NULL; }
+
+    /** Copy the newest frame of a sensor, without waiting
+     *
+     *  @return true on success, false if no frame has been read yet
+     */
+    bool latest(uint16_t id, ThermoFrame& frame) const;
+
+    /** Copy the next frame of a sensor after a reader cursor, without waiting
+     *
+     *  @param cursor number of frames consumed by the reader (updated)
+     *  @return true on success, false if there is no new frame
+     */
+    bool read(uint16_t id, uint32_t& cursor, ThermoFrame& frame) const;
+
+    /** Copy the next reading of a sensor as it was before the filter, without waiting
+     *
+     *  Same sequence numbers and timestamps as read(), for recording the
+     *  sensor values (see ThermoRecorder). Without a filter it is read().
+     *  @param cursor number of frames consumed by the reader (updated)
+     *  @return true on success, false if there is no new frame
+     */
+    bool read_raw(uint16_t id, uint32_t& cursor, ThermoFrame& frame) const;
+
+    /** Number of readings of a sensor which failed (I2C error, PEC error or failed setup) */
+    uint32_t errors(uint16_t id) const;
+
+    /** Check whether the setup of a sensor succeeded
+     *
+     *  A sensor whose setup failed (e.g. a missing log of ThermoReplayDevice)
+     *  is not read, its setup is tried again every period and counted in errors.
+     *  @return true once the setup succeeded, false before or while it fails
+     */
+    bool ready(uint16_t id) const;
+
+private:
+    struct Slot {
+        ThermoSensorDevice* device;
+        uint16_t id;
+        volatile uint32_t errors;
+        volatile bool ready;    // setup succeeded
+        ThermoFrameFilter* filter;
+        uint32_t timeout_ms;    // bus time of a reading with a margin
+        ThermoFrame frame;  // reading buffer, only used by the thread
+        ThermoFrameRing<ThermoFrame, THERMO_ACQUISITION_RING> ring;
+        ThermoFrameRing<ThermoFrame, THERMO_ACQUISITION_RING> raw_ring;    // readings before the filter
+    };
+
+    uint32_t mPeriodMs;
+    Thread mThread;
+    Slot mSlot[THERMO_ACQUISITION_MAX_SENSOR];
+    int mSlotNum;
+    ThermoFrameHistogram mHistogram;    // only used by the thread
+    ThermoFrame mRaw;                   // reading before the filter, only used by the thread
+    EventFlags mFlags;
+    ThermoProfiler* mProfiler;
+    int mProfileStage;
+
+    void task(void);
+    bool read_frame(Slot& slot);
+    void read_done(bool result);
+    const Slot* find(uint16_t id) const;
+};
+
+#endif
@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_D6T_DEVICE_H
+#define THERMO_D6T_DEVICE_H
+
+#include "mbed.h"
+#include "D6T_44L_06.h"
+#include "ThermoFrame.h"
+#include "ThermoI2cMux.h"
+#include "ThermoSensorDevice.h"
+
+/** D6T sensor as a ThermoSensorDevice
+ *
+ *  The sensor model must be the one of the frames (ThermoSensorModel).
+ *
+ * Example:
+ * @code
+ *
+ * ThermoMbedI2c i2c(I2C_SDA, I2C_SCL);
+ * ThermoI2cMux mux(i2c);
+ * D6T_44L_06 d6t_a(i2c);
+ * D6T_44L_06 d6t_b(i2c);
+ * ThermoD6TDevice sensor_a(d6t_a, &mux, 0);   // mux channel 0
+ * ThermoD6TDevice sensor_b(d6t_b, &mux, 1);   // mux channel 1
+ * @endcode
+ */
+class ThermoD6TDevice : public ThermoSensorDevice
+{
+public:
+    /** Create a device
+     *
+     *  @param sensor  sensor driver
+     *  @param p_mux   mux in front of the sensor (NULL: none)
+     *  @param channel mux channel of the sensor
+     */
+    template <typename Traits>
+    ThermoD6TDevice(D6T<Traits>& sensor, ThermoI2cMux* p_mux = NULL, int channel = 0) :
+        mSensor(sensor), mMux(p_mux), mChannel(channel)
+    {
+        static_assert((Traits::ROWS == THERMO_FRAME_ROWS) && (Traits::COLS == THERMO_FRAME_COLS),
+                      "sensor model differs from the frame (d6t-model)");
+    }
+
+    virtual bool setup(void)
+    {
+        if (select() == false) {
+            return false;
+        }
+        return mSensor.setup();
+    }
+
+    virtual bool read_async(int16_t* ptat, int16_t* buf, Callback<void(bool)> callback)
+    {
+        if (select() == false) {
+            return false;
+        }
+        return mSensor.read_async(ptat, buf, callback);
+    }
+
+    virtual void abort_async(void)
+    {
+        mSensor.abort_async();
+    }
+
+    virtual uint32_t read_time_us(void) const
+    {
+        return mSensor.read_time_us();
+    }
+
+private:
+    D6T_Base& mSensor;
+    ThermoI2cMux* mMux;
+    int mChannel;
+
+    bool select(void)
+    {
+        if (mMux == NULL) {
+            return true;
+        }
+        return mMux->select(mChannel);
+    }
+};
+
+#endif
@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_FRAME_H
+#define THERMO_FRAME_H
+
+#include <stdint.h>
+#include "D6T_Traits.h"
+
+/* Sensor model of the frames (mbed_app.json "d6t-model") */
+#ifndef MBED_CONF_APP_D6T_MODEL
+#define MBED_CONF_APP_D6T_MODEL D6T_44L_06_Traits
+#endif
+typedef MBED_CONF_APP_D6T_MODEL ThermoSensorModel;
+
+/* Number of thermopile pixels of a frame */
+#define THERMO_FRAME_ROWS       (ThermoSensorModel::ROWS)
+#define THERMO_FRAME_COLS       (ThermoSensorModel::COLS)
+#define THERMO_FRAME_PIXEL      (THERMO_FRAME_ROWS * THERMO_FRAME_COLS)
+
+/* 32-bit words of the change mask of a frame */
+#define THERMO_FRAME_MASK_WORDS ((THERMO_FRAME_PIXEL + 31) / 32)
+
+/** Statistics of the pixels of a frame (ThermoFrameHistogram) */
+struct ThermoFrameStats {
+    int16_t  min;                           // coldest pixel (The integer which set a centigrade to 10 times)
+    int16_t  max;                           // hottest pixel
+    int16_t  mean;                          // rounded mean of the pixels
+    int16_t  low;                           // low percentile (ThermoFrameHistogram::set_percentiles)
+    int16_t  high;                          // high percentile
+    uint8_t  hot_x;                         // column of the hottest pixel (the first one)
+    uint8_t  hot_y;                         // row of the hottest pixel
+    uint8_t  cold_x;                        // column of the coldest pixel (the first one)
+    uint8_t  cold_y;                        // row of the coldest pixel
+};
+
+/** One sensor reading */
+struct ThermoFrame {
+    uint32_t sequence;                      // 1 for the first frame of the sensor
+    uint32_t timestamp_ms;                  // kernel time of the reading
+    uint16_t sensor_id;                     // ID given to ThermoAcquisition::add
+    int16_t  ptat;                          // (The integer which set a centigrade to 10 times)
+    int16_t  pixel[THERMO_FRAME_PIXEL];     // [row][col]
+    uint32_t changed[THERMO_FRAME_MASK_WORDS];  // bit i: pixel i differs from the previous frame
+                                                // (all set without a ThermoFrameFilter)
+    ThermoFrameStats stats;                 // of the published pixels, after the filter
+};
+
+/* Check the change mask bit of a pixel */
+static inline bool thermo_frame_changed(const ThermoFrame& frame, int i)
+{
+    return (frame.changed[i >> 5] & (1u << (i & 31))) != 0;
+}
+
+#endif
@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <string.h>
+#include "ThermoFrameFilter.h"
+
+ThermoFrameFilter::ThermoFrameFilter(ThermoFilterMode mode, int strength, int deadband) :
+    mMode(mode), mStrength(strength), mDeadband(deadband), mCount(0)
+{
+    if (mMode == THERMO_FILTER_EMA) {
+        mStrength = (strength < 1) ? 1 : ((strength > 8) ? 8 : strength);
+    } else if (mMode == THERMO_FILTER_MEDIAN) {
+        mStrength = (strength <= 3) ? 3 : THERMO_FILTER_MEDIAN_MAX;
+    }
+    reset_stats();
+}
+
+void ThermoFrameFilter::apply(ThermoFrame& frame)
+{
+    uint32_t changed = 0;
+    int16_t value;
+    int i;
+
+    memset(frame.changed, 0, sizeof(frame.changed));
+    for (i = 0; i < VALUES; i++) {
+        int16_t& data = (i == 0) ? frame.ptat : frame.pixel[i - 1];
+
+        if (mCount == 0) {
+            // first reading: the history starts with it
+            int n;
+
+            mEma[i] = (int32_t)data << THERMO_FILTER_EMA_FRAC;
+            for (n = 0; n < THERMO_FILTER_MEDIAN_MAX; n++) {
+                mHistory[n][i] = data;
+            }
+            value = data;
+        } else {
+            value = filter(i, data);
+            if ((value - mOut[i] <= mDeadband) && (mOut[i] - value <= mDeadband)) {
+                data = mOut[i];
+                continue;
+            }
+        }
+        mOut[i] = value;
+        data = value;
+        if (i > 0) {
+            frame.changed[(i - 1) >> 5] |= 1u << ((i - 1) & 31);
+            changed++;
+        }
+    }
+    mCount++;
+
+    mStats.frames++;
+    mStats.changed += changed;
+    mStats.last_changed = changed;
+}
+
+int16_t ThermoFrameFilter::filter(int index, int16_t value)
+{
+    int16_t window[THERMO_FILTER_MEDIAN_MAX];
+    int n;
+    int k;
+
+    switch (mMode) {
+        case THERMO_FILTER_EMA:
+            mEma[index] += (((int32_t)value << THERMO_FILTER_EMA_FRAC) - mEma[index]) >> mStrength;
+            return (int16_t)((mEma[index] + (1 << (THERMO_FILTER_EMA_FRAC - 1))) >> THERMO_FILTER_EMA_FRAC);
+        case THERMO_FILTER_MEDIAN:
+            mHistory[mCount % mStrength][index] = value;
+            // insertion sort of 3 or 5 values
+            for (n = 0; n < mStrength; n++) {
+                int16_t data = mHistory[n][index];
+                for (k = n; (k > 0) && (window[k - 1] > data); k--) {
+                    window[k] = window[k - 1];
+                }
+                window[k] = data;
+            }
+            return window[mStrength / 2];
+        default:
+            return value;
+    }
+}
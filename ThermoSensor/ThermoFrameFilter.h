@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_FRAME_FILTER_H
+#define THERMO_FRAME_FILTER_H
+
+#include <stdint.h>
+#include "ThermoFrame.h"
+
+/* Largest window of the median filter */
+#define THERMO_FILTER_MEDIAN_MAX    (5)
+
+/* Fraction bits of the EMA state */
+#define THERMO_FILTER_EMA_FRAC      (4)
+
+/** Temporal filter of a ThermoFrameFilter */
+enum ThermoFilterMode {
+    THERMO_FILTER_OFF    = 0,   // readings as they are (the deadband still applies)
+    THERMO_FILTER_EMA    = 1,   // exponential moving average, weight 1/2^strength of a new reading
+    THERMO_FILTER_MEDIAN = 2,   // median of the last strength readings (3 or 5)
+};
+
+/** Counters of a ThermoFrameFilter */
+struct ThermoFilterStats {
+    uint32_t frames;            // frames filtered
+    uint32_t changed;           // pixels reported as changed, all frames
+    uint32_t last_changed;      // pixels reported as changed by the last frame
+};
+
+/** Per-pixel temporal filter and deadband of the frames of one sensor
+ *
+ *  Applied by the acquisition thread to every reading before it is
+ *  published (ThermoAcquisition::set_filter). The PTAT and each pixel are
+ *  filtered on integers, then a value is only passed on when it moved more
+ *  than the deadband away from the value passed on last; otherwise the last
+ *  value is repeated. The change mask of the frame marks the pixels which
+ *  were passed on, so readers can skip the unchanged ones.
+ *
+ *  The EMA keeps THERMO_FILTER_EMA_FRAC fraction bits, so small steps are
+ *  not lost to the integer rounding. The median follows steps after half
+ *  the window and removes single-frame spikes completely.
+ *
+ * Example:
+ * @code
+ *
+ * static ThermoFrameFilter filter(THERMO_FILTER_EMA, 2, 2);     // 1/4 weight, 0.2 degC deadband
+ *
+ * acquisition.add(sensor, 0);
+ * acquisition.set_filter(0, &filter);
+ * @endcode
+ */
+class ThermoFrameFilter
+{
+public:
+    /** Create a filter
+     *
+     *  @param mode     temporal filter
+     *  @param strength EMA: weight shift (1-8), median: window (3 or 5)
+     *  @param deadband smallest change passed on (The integer which set a centigrade to 10 times), 0: any change
+     */
+    ThermoFrameFilter(ThermoFilterMode mode, int strength, int deadband);
+
+    /** Filter a reading in place and set its change mask
+     *
+     *  @param frame reading, PTAT and pixels are replaced by the filtered values
+     */
+    void apply(ThermoFrame& frame);
+
+    /** Forget the history, the next reading is passed on as it is */
+    void reset(void) { mCount = 0; }
+
+    ThermoFilterMode mode(void) const { return mMode; }
+    ThermoFilterStats stats(void) const { return mStats; }
+    void reset_stats(void) { mStats.frames = 0; mStats.changed = 0; mStats.last_changed = 0; }
+
+private:
+    /* the PTAT is value 0, pixel i is value i + 1 */
+    static const int VALUES = THERMO_FRAME_PIXEL + 1;
+
+    ThermoFilterMode mMode;
+    int mStrength;
+    int mDeadband;
+    uint32_t mCount;                                    // readings since reset
+    int32_t mEma[VALUES];                               // EMA state with fraction bits
+    int16_t mHistory[THERMO_FILTER_MEDIAN_MAX][VALUES]; // last readings of the median
+    int16_t mOut[VALUES];                               // values passed on last
+    ThermoFilterStats mStats;
+
+    int16_t filter(int index, int16_t value);
+};
+
+#endif
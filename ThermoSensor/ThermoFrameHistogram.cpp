@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <string.h>
+#include "ThermoFrameHistogram.h"
+
+static inline int bin_of(int data)
+{
+    int bin = (data - THERMO_HISTOGRAM_BASE) >> THERMO_HISTOGRAM_SHIFT;
+
+    return (bin < 0) ? 0 : ((bin >= THERMO_HISTOGRAM_BINS) ? (THERMO_HISTOGRAM_BINS - 1) : bin);
+}
+
+static inline int16_t clamp_data(int data, int min, int max)
+{
+    return (int16_t)((data < min) ? min : ((data > max) ? max : data));
+}
+
+ThermoFrameHistogram::ThermoFrameHistogram(int low, int high)
+{
+    memset(mCount, 0, sizeof(mCount));
+    set_percentiles(low, high);
+}
+
+void ThermoFrameHistogram::set_percentiles(int low, int high)
+{
+    mHigh = (high < 0) ? 0 : ((high > 100) ? 100 : high);
+    mLow  = (low < 0) ? 0 : ((low > mHigh) ? mHigh : low);
+}
+
+void ThermoFrameHistogram::measure(const int16_t* p_pixel, int width, int height, ThermoFrameStats* p_stats)
+{
+    int num = width * height;
+    int32_t sum = 0;
+    int min;
+    int max;
+    int hot = 0;
+    int cold = 0;
+    int rank_low;
+    int rank_high;
+    int seen = 0;
+    int bin;
+    int i;
+
+    if (num <= 0) {
+        memset(p_stats, 0, sizeof(*p_stats));
+        return;
+    }
+
+    min = p_pixel[0];
+    max = p_pixel[0];
+    for (i = 0; i < num; i++) {
+        int data = p_pixel[i];
+
+        sum += data;
+        if (data > max) {
+            max = data;
+            hot = i;
+        } else if (data < min) {
+            min = data;
+            cold = i;
+        }
+        mCount[bin_of(data)]++;
+    }
+
+    p_stats->min    = (int16_t)min;
+    p_stats->max    = (int16_t)max;
+    p_stats->mean   = (int16_t)((sum >= 0) ? ((sum + (num / 2)) / num) : -((-sum + (num / 2)) / num));
+    p_stats->hot_x  = (uint8_t)(hot % width);
+    p_stats->hot_y  = (uint8_t)(hot / width);
+    p_stats->cold_x = (uint8_t)(cold % width);
+    p_stats->cold_y = (uint8_t)(cold / width);
+    p_stats->low    = (int16_t)min;
+    p_stats->high   = (int16_t)max;
+
+    // nearest rank below, the position inside a bin is spread over its width
+    rank_low  = ((num - 1) * mLow) / 100;
+    rank_high = ((num - 1) * mHigh) / 100;
+    for (bin = bin_of(min); bin <= bin_of(max); bin++) {
+        int count = mCount[bin];
+        int base = THERMO_HISTOGRAM_BASE + (bin << THERMO_HISTOGRAM_SHIFT);
+
+        if (count == 0) {
+            continue;
+        }
+        if ((seen <= rank_low) && (rank_low < (seen + count))) {
+            p_stats->low = clamp_data(base + (((((rank_low - seen) * 2) + 1) << THERMO_HISTOGRAM_SHIFT) / (count * 2)), min, max);
+        }
+        if ((seen <= rank_high) && (rank_high < (seen + count))) {
+            p_stats->high = clamp_data(base + (((((rank_high - seen) * 2) + 1) << THERMO_HISTOGRAM_SHIFT) / (count * 2)), min, max);
+        }
+        seen += count;
+        mCount[bin] = 0;
+    }
+}
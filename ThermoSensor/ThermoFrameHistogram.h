@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_FRAME_HISTOGRAM_H
+#define THERMO_FRAME_HISTOGRAM_H
+
+#include <stdint.h>
+#include "ThermoFrame.h"
+
+/* Bins of 2^shift raw units (0.4 degC) from THERMO_HISTOGRAM_BASE, -40.0 to 164.8 degC.
+   Pixels outside count to the first or the last bin, min and max stay exact */
+#define THERMO_HISTOGRAM_SHIFT      (2)
+#define THERMO_HISTOGRAM_BINS       (512)
+#define THERMO_HISTOGRAM_BASE       (-400)
+
+/* Default percentiles of ThermoFrameStats::low and high */
+#define THERMO_HISTOGRAM_LOW        (2)
+#define THERMO_HISTOGRAM_HIGH       (98)
+
+/** Statistics of the pixels of a frame in one pass
+ *
+ *  One pass over the pixels finds min, max, their positions and the sum,
+ *  and counts every pixel to an integer histogram. The percentiles are
+ *  then read from the bins between min and max only, interpolated inside
+ *  the bin, and these bins are cleared again, so a frame costs the pixels
+ *  plus the occupied temperature span, not the whole table.
+ *
+ *  ThermoAcquisition measures every frame it publishes (ThermoFrame::stats).
+ *
+ * Example:
+ * @code
+ *
+ * ThermoFrameHistogram histogram(5, 95);
+ *
+ * histogram.measure(frame);
+ * printf("hot spot %d,%d\n", frame.stats.hot_x, frame.stats.hot_y);
+ * @endcode
+ */
+class ThermoFrameHistogram
+{
+public:
+    /** Create a histogram
+     *
+     *  @param low  percentile of ThermoFrameStats::low (0-100)
+     *  @param high percentile of ThermoFrameStats::high (0-100)
+     */
+    ThermoFrameHistogram(int low = THERMO_HISTOGRAM_LOW, int high = THERMO_HISTOGRAM_HIGH);
+
+    /** Change the percentiles
+     *
+     *  @param low  percentile of ThermoFrameStats::low (0-100, at most high)
+     *  @param high percentile of ThermoFrameStats::high (0-100)
+     */
+    void set_percentiles(int low, int high);
+
+    int low(void) const { return mLow; }
+    int high(void) const { return mHigh; }
+
+    /** Statistics of a pixel grid
+     *
+     *  @param p_pixel temperature data [height][width] (The integer which set a centigrade to 10 times)
+     *  @param width   grid x size (up to 256)
+     *  @param height  grid y size (up to 256)
+     *  @param p_stats statistics of the grid
+     */
+    void measure(const int16_t* p_pixel, int width, int height, ThermoFrameStats* p_stats);
+
+    /** Set the statistics of a frame from its pixels */
+    void measure(ThermoFrame& frame)
+    {
+        measure(&frame.pixel[0], THERMO_FRAME_COLS, THERMO_FRAME_ROWS, &frame.stats);
+    }
+
+private:
+    uint16_t mCount[THERMO_HISTOGRAM_BINS];     // all 0 between two measure() calls
+    int mLow;
+    int mHigh;
+};
+
+#endif
@@ -0,0 +1,153 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_FRAME_RING_H
+#define THERMO_FRAME_RING_H
+
+#include <stdint.h>
+#include <atomic>
+
+/** Lock-free frame ring of one producer
+ *
+ *  The producer never waits: when the ring is full the oldest entry is
+ *  overwritten. Each slot is guarded by a sequence number (odd while being
+ *  written), readers copy a slot and retry if it was rewritten meanwhile, so
+ *  readers never block the producer either.
+ *
+ *  latest() returns the newest entry. read() walks the entries in order with
+ *  a cursor held by the reader, so several readers can follow the same ring.
+ *
+ * Example:
+ * @code
+ *
+ * ThermoFrameRing<ThermoFrame, 4> ring;
+ * ThermoFrame frame;
+ * uint32_t cursor = 0;
+ *
+ * ring.push(frame);                // producer thread
+ * if (ring.latest(frame)) { ... }  // newest frame
+ * while (ring.read(cursor, frame)) { ... }  // every frame in order
+ * @endcode
+ */
+template <typename T, int N>
+class ThermoFrameRing
+{
+public:
+    static_assert(N >= 2, "ring needs two slots at least");
+
+    ThermoFrameRing() : mHead(0)
+    {
+        for (int i = 0; i < N; i++) {
+            mSlot[i].seq.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /** Publish an entry (producer only) */
+    void push(const T& entry)
+    {
+        uint32_t count = mHead.load(std::memory_order_relaxed);
+        Slot& slot = mSlot[count % N];
+
+        slot.seq.store((count * 2) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.data = entry;
+        slot.seq.store((count + 1) * 2, std::memory_order_release);
+        mHead.store(count + 1, std::memory_order_release);
+    }
+
+    /** Number of entries published so far */
+    uint32_t count(void) const
+    {
+        return mHead.load(std::memory_order_acquire);
+    }
+
+    /** Copy the newest entry
+     *
+     *  @param entry copy destination
+     *  @return true on success, false if nothing was published yet
+     */
+    bool latest(T& entry) const
+    {
+        while (true) {
+            uint32_t head = mHead.load(std::memory_order_acquire);
+
+            if (head == 0) {
+                return false;
+            }
+            if (copy(head - 1, entry)) {
+                return true;
+            }
+        }
+    }
+
+    /** Copy the next entry after a cursor
+     *
+     *  Entries which were overwritten before being read are skipped.
+     *  @param cursor number of entries consumed by this reader (updated)
+     *  @param entry  copy destination
+     *  @return true on success, false if there is no new entry
+     */
+    bool read(uint32_t& cursor, T& entry) const
+    {
+        while (true) {
+            uint32_t head = mHead.load(std::memory_order_acquire);
+
+            if (cursor == head) {
+                return false;
+            }
+            if ((head - cursor) > (uint32_t)(N - 1)) {
+                cursor = head - (N - 1);
+            }
+            if (copy(cursor, entry)) {
+                cursor++;
+                return true;
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        std::atomic<uint32_t> seq;
+        T data;
+    };
+
+    Slot mSlot[N];
+    std::atomic<uint32_t> mHead;
+
+    bool copy(uint32_t index, T& entry) const
+    {
+        const Slot& slot = mSlot[index % N];
+        uint32_t expect = (index + 1) * 2;
+
+        if (slot.seq.load(std::memory_order_acquire) != expect) {
+            return false;
+        }
+        entry = slot.data;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return slot.seq.load(std::memory_order_relaxed) == expect;
+    }
+};
+
+#endif
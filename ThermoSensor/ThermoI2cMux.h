@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_I2C_MUX_H
+#define THERMO_I2C_MUX_H
+
+#include "mbed.h"
+#include "ThermoHalI2c.h"
+
+#define THERMO_I2C_MUX_ADDR     (0x70 << 1)   // for I2C 7bit address
+
+/** I2C mux with one control byte (PCA9548A/TCA9548A type)
+ *
+ *  Bit n of the control byte connects channel n. Needed for several
+ *  D6T sensors on one bus, because their address is fixed.
+ */
+class ThermoI2cMux
+{
+public:
+    /** Create a mux instance
+     *
+     *  @param i2c  I2C bus of the mux (must outlive the mux)
+     *  @param addr 8bit I2C address
+     */
+    ThermoI2cMux(ThermoHalI2c& i2c, int addr = THERMO_I2C_MUX_ADDR);
+
+    /** Connect one channel, the others are disconnected
+     *
+     *  Nothing is written when the channel is already selected.
+     *  @param channel channel number (0-7)
+     *  @return true on success, false on failure
+     */
+    bool select(int channel);
+
+private:
+    ThermoHalI2c& mI2c;
+    int mAddr;
+    int mChannel;   // -1: unknown
+};
+
+#endif
@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_SENSOR_DEVICE_H
+#define THERMO_SENSOR_DEVICE_H
+
+#include "mbed.h"
+
+/** Thermal sensor seen by the acquisition threads
+ *
+ *  Implemented by ThermoD6TDevice for the real sensor. A simulated sensor
+ *  only has to call the read_async callback (after any latency it wants).
+ */
+class ThermoSensorDevice
+{
+public:
+    virtual ~ThermoSensorDevice() {}
+
+    /** Initialize the sensor device
+     *
+     *  @return true on success, false on failure
+     */
+    virtual bool setup(void) = 0;
+
+    /** Start reading one frame
+     *
+     *  @param ptat     PTAT destination
+     *  @param buf      pixel data destination
+     *  @param callback completion callback (may be called from interrupt context)
+     *  @return true if started, false on failure (the callback is not called)
+     */
+    virtual bool read_async(int16_t* ptat, int16_t* buf, Callback<void(bool)> callback) = 0;
+
+    /** Abort a read started by read_async (the callback is not called) */
+    virtual void abort_async(void) = 0;
+
+    /** Bus time of one reading [us], 0 if there is no bus
+     *
+     *  The acquisition waits this long plus a margin before it aborts a reading.
+     */
+    virtual uint32_t read_time_us(void) const { return 0; }
+};
+
+#endif
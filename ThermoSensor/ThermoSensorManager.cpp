@@ -0,0 +1,112 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ThermoSensorManager.h"
+
+ThermoSensorManager::ThermoSensorManager() :
+    mBusNum(0)
+{
+}
+
+bool ThermoSensorManager::add(ThermoAcquisition& bus)
+{
+    if (mBusNum >= THERMO_SENSOR_MANAGER_MAX_BUS) {
+        return false;
+    }
+    mBus[mBusNum] = &bus;
+    mBusNum++;
+    return true;
+}
+
+void ThermoSensorManager::start(void)
+{
+    int i;
+
+    for (i = 0; i < mBusNum; i++) {
+        mBus[i]->start();
+    }
+}
+
+bool ThermoSensorManager::latest(uint16_t id, ThermoFrame& frame) const
+{
+    const ThermoAcquisition* p_bus = find(id);
+
+    if (p_bus == NULL) {
+        return false;
+    }
+    return p_bus->latest(id, frame);
+}
+
+bool ThermoSensorManager::read(uint16_t id, uint32_t& cursor, ThermoFrame& frame) const
+{
+    const ThermoAcquisition* p_bus = find(id);
+
+    if (p_bus == NULL) {
+        return false;
+    }
+    return p_bus->read(id, cursor, frame);
+}
+
+bool ThermoSensorManager::read_raw(uint16_t id, uint32_t& cursor, ThermoFrame& frame) const
+{
+    const ThermoAcquisition* p_bus = find(id);
+
+    if (p_bus == NULL) {
+        return false;
+    }
+    return p_bus->read_raw(id, cursor, frame);
+}
+
+uint32_t ThermoSensorManager::errors(uint16_t id) const
+{
+    const ThermoAcquisition* p_bus = find(id);
+
+    if (p_bus == NULL) {
+        return 0;
+    }
+    return p_bus->errors(id);
+}
+
+bool ThermoSensorManager::ready(uint16_t id) const
+{
+    const ThermoAcquisition* p_bus = find(id);
+
+    if (p_bus == NULL) {
+        return false;
+    }
+    return p_bus->ready(id);
+}
+
+const ThermoAcquisition* ThermoSensorManager::find(uint16_t id) const
+{
+    int i;
+
+    for (i = 0; i < mBusNum; i++) {
+        if (mBus[i]->has(id)) {
+            return mBus[i];
+        }
+    }
+    return NULL;
+}
@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_SENSOR_MANAGER_H
+#define THERMO_SENSOR_MANAGER_H
+
+#include "mbed.h"
+#include "ThermoAcquisition.h"
+
+/* Number of I2C buses */
+#ifndef THERMO_SENSOR_MANAGER_MAX_BUS
+#define THERMO_SENSOR_MANAGER_MAX_BUS   (4)
+#endif
+
+/** Thermal sensors of several I2C buses
+ *
+ *  Each bus has its own ThermoAcquisition thread, so the transfers of
+ *  different buses run at the same time while the sensors of one bus are
+ *  read in turn. Frames are looked up by sensor ID.
+ *
+ * Example:
+ * @code
+ *
+ * D6T_44L_06 d6t_a(P_SDA_A, P_SCL_A);
+ * D6T_44L_06 d6t_b(P_SDA_B, P_SCL_B);
+ * ThermoD6TDevice sensor_a(d6t_a);
+ * ThermoD6TDevice sensor_b(d6t_b);
+ * ThermoAcquisition bus_a(100);
+ * ThermoAcquisition bus_b(100);
+ * ThermoSensorManager sensors;
+ *
+ * int main() {
+ *     ThermoFrame frame;
+ *
+ *     bus_a.add(sensor_a, 0);
+ *     bus_b.add(sensor_b, 1);
+ *     sensors.add(bus_a);
+ *     sensors.add(bus_b);
+ *     sensors.start();
+ *     while (1) {
+ *         if (sensors.latest(1, frame)) {
+ *             ...
+ *         }
+ *         ThisThread::sleep_for(200);
+ *     }
+ * }
+ * @endcode
+ */
+class ThermoSensorManager
+{
+public:
+    ThermoSensorManager();
+
+    /** Add a bus (before start)
+     *
+     *  @return true on success, false if THERMO_SENSOR_MANAGER_MAX_BUS is exceeded
+     */
+    bool add(ThermoAcquisition& bus);
+
+    /** Start the threads of all buses */
+    void start(void);
+
+    /** Copy the newest frame of a sensor, without waiting
+     *
+     *  @return true on success, false if no frame has been read yet
+     */
+    bool latest(uint16_t id, ThermoFrame& frame) const;
+
+    /** Copy the next frame of a sensor after a reader cursor, without waiting
+     *
+     *  @param cursor number of frames consumed by the reader (updated)
+     *  @return true on success, false if there is no new frame
+     */
+    bool read(uint16_t id, uint32_t& cursor, ThermoFrame& frame) const;
+
+    /** Copy the next reading of a sensor before the filter (see ThermoAcquisition::read_raw) */
+    bool read_raw(uint16_t id, uint32_t& cursor, ThermoFrame& frame) const;
+
+    /** Number of readings of a sensor which failed */
+    uint32_t errors(uint16_t id) const;
+
+    /** Check whether the setup of a sensor succeeded (see ThermoAcquisition::ready) */
+    bool ready(uint16_t id) const;
+
+private:
+    ThermoAcquisition* mBus[THERMO_SENSOR_MANAGER_MAX_BUS];
+    int mBusNum;
+
+    const ThermoAcquisition* find(uint16_t id) const;
+};
+
+#endif
@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_CRC16_H
+#define THERMO_CRC16_H
+
+#include <stdint.h>
+
+/* CRC-16/CCITT-FALSE: polynomial x^16 + x^12 + x^5 + 1, initial value 0xFFFF */
+#define THERMO_CRC16_POLY   (0x1021)
+#define THERMO_CRC16_INIT   (0xFFFF)
+
+/** CRC-16 lookup table, built at compile time
+ *
+ *  crc[n] is the value of the 8-iteration bit loop for the byte n in the
+ *  upper bits, so one byte takes a single lookup.
+ */
+struct ThermoCrc16Table {
+    uint16_t crc[256];
+
+    constexpr ThermoCrc16Table() : crc()
+    {
+        for (int n = 0; n < 256; n++) {
+            uint16_t data = (uint16_t)(n << 8);
+            for (int bit = 0; bit < 8; bit++) {
+                data = (uint16_t)((data & 0x8000) ? ((data << 1) ^ THERMO_CRC16_POLY) : (data << 1));
+            }
+            crc[n] = data;
+        }
+    }
+
+    /** Continue a CRC over more bytes (start with THERMO_CRC16_INIT) */
+    uint16_t update(uint16_t value, const uint8_t* p_data, uint32_t size) const
+    {
+        for (uint32_t i = 0; i < size; i++) {
+            value = (uint16_t)((value << 8) ^ crc[(value >> 8) ^ p_data[i]]);
+        }
+        return value;
+    }
+};
+
+#endif
@@ -0,0 +1,118 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <string.h>
+#include "ThermoTelemetry.h"
+
+static constexpr ThermoCrc16Table crc16_table{};
+
+static inline uint8_t* put_u16(uint8_t* p_data, uint16_t value)
+{
+    p_data[0] = (uint8_t)value;
+    p_data[1] = (uint8_t)(value >> 8);
+    return p_data + 2;
+}
+
+static inline uint8_t* put_u32(uint8_t* p_data, uint32_t value)
+{
+    p_data = put_u16(p_data, (uint16_t)value);
+    return put_u16(p_data, (uint16_t)(value >> 16));
+}
+
+/* zigzag varint: 7 bits per byte, the sign in bit 0 */
+static inline uint8_t* put_delta(uint8_t* p_data, int32_t delta)
+{
+    uint32_t value = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+
+    while (value >= 0x80) {
+        *p_data++ = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    *p_data++ = (uint8_t)value;
+    return p_data;
+}
+
+ThermoTelemetryEncoder::ThermoTelemetryEncoder(int key_interval, bool delta) :
+    mKeyInterval((key_interval < 1) ? 1 : key_interval), mSinceKey(0), mDelta(delta), mCounter(0), mSensorId(0)
+{
+    resync();
+    memset(mLast, 0, sizeof(mLast));
+}
+
+uint16_t ThermoTelemetryEncoder::crc(const uint8_t* p_data, uint32_t size)
+{
+    return crc16_table.update(THERMO_CRC16_INIT, p_data, size);
+}
+
+uint32_t ThermoTelemetryEncoder::encode(const ThermoFrame& frame, uint8_t* p_packet)
+{
+    const int values = THERMO_TELEMETRY_VALUES(THERMO_FRAME_PIXEL);
+    const uint32_t key_length = values * 2;
+    uint8_t* p_payload = &p_packet[THERMO_TELEMETRY_HEADER];
+    uint8_t* p_data = p_payload;
+    uint8_t type = THERMO_TELEMETRY_KEY;
+    uint32_t length;
+    int i;
+
+    if (mDelta && (mSinceKey < mKeyInterval) && (frame.sensor_id == mSensorId)) {
+        // stops at the size of a key frame, the last varint (3 bytes at most) may overrun into the CRC
+        const uint8_t* p_limit = p_payload + key_length;
+
+        p_data = put_delta(p_data, (int32_t)frame.ptat - mLast[0]);
+        for (i = 1; (i < values) && (p_data < p_limit); i++) {
+            p_data = put_delta(p_data, (int32_t)frame.pixel[i - 1] - mLast[i]);
+        }
+        if ((i == values) && (p_data <= p_limit)) {
+            type = THERMO_TELEMETRY_DELTA;
+        }
+    }
+    if (type == THERMO_TELEMETRY_KEY) {
+        p_data = put_u16(p_payload, (uint16_t)frame.ptat);
+        for (i = 0; i < THERMO_FRAME_PIXEL; i++) {
+            p_data = put_u16(p_data, (uint16_t)frame.pixel[i]);
+        }
+        mSinceKey = 0;
+    }
+    mSinceKey++;
+    length = (uint32_t)(p_data - p_payload);
+
+    p_packet[0] = THERMO_TELEMETRY_SYNC0;
+    p_packet[1] = THERMO_TELEMETRY_SYNC1;
+    p_packet[2] = THERMO_TELEMETRY_VERSION;
+    p_packet[3] = type;
+    p_packet[4] = mCounter++;
+    p_packet[5] = (uint8_t)frame.sensor_id;
+    p_packet[6] = THERMO_FRAME_COLS;
+    p_packet[7] = THERMO_FRAME_ROWS;
+    put_u32(&p_packet[8], frame.sequence);
+    put_u32(&p_packet[12], frame.timestamp_ms);
+    put_u16(&p_packet[16], (uint16_t)length);
+    put_u16(p_data, crc(&p_packet[2], (THERMO_TELEMETRY_HEADER - 2) + length));
+
+    mSensorId = frame.sensor_id;
+    mLast[0] = frame.ptat;
+    memcpy(&mLast[1], frame.pixel, sizeof(frame.pixel));
+    return THERMO_TELEMETRY_HEADER + length + THERMO_TELEMETRY_CRC;
+}
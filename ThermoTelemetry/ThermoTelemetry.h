@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_TELEMETRY_H
+#define THERMO_TELEMETRY_H
+
+#include <stdint.h>
+#include "ThermoFrame.h"
+#include "ThermoCrc16.h"
+
+/* Packet of one frame, all fields little endian:
+ *
+ *   0  sync       0xA5 0x5A (not ASCII, console text between packets is skipped)
+ *   2  version    THERMO_TELEMETRY_VERSION
+ *   3  type       THERMO_TELEMETRY_KEY or THERMO_TELEMETRY_DELTA
+ *   4  counter    packet number (mod 256), a gap means a lost packet
+ *   5  sensor_id  (low 8 bits)
+ *   6  cols, rows
+ *   8  sequence   uint32 of ThermoFrame
+ *  12  timestamp  uint32 [ms] of ThermoFrame
+ *  16  length     uint16 bytes of the payload
+ *  18  payload    key:   ptat, pixel[0] ... pixel[N-1] as int16
+ *                 delta: the same values minus the ones of the previous
+ *                        packet, zigzag varints (1 byte for -64 to 63)
+ *  18+length      CRC-16/CCITT-FALSE of version ... payload
+ */
+#define THERMO_TELEMETRY_SYNC0      (0xA5)
+#define THERMO_TELEMETRY_SYNC1      (0x5A)
+#define THERMO_TELEMETRY_VERSION    (1)
+#define THERMO_TELEMETRY_KEY        (1)
+#define THERMO_TELEMETRY_DELTA      (2)
+#define THERMO_TELEMETRY_HEADER     (18)
+#define THERMO_TELEMETRY_CRC        (2)
+
+/* Values of a frame (PTAT and the pixels) */
+#define THERMO_TELEMETRY_VALUES(pixels)     ((pixels) + 1)
+/* Largest packet: a key frame (a delta frame longer than it is sent as a key frame) */
+#define THERMO_TELEMETRY_PACKET_SIZE(pixels) \
+    (THERMO_TELEMETRY_HEADER + (THERMO_TELEMETRY_VALUES(pixels) * 2) + THERMO_TELEMETRY_CRC)
+#define THERMO_TELEMETRY_MAX_PACKET         THERMO_TELEMETRY_PACKET_SIZE(THERMO_FRAME_PIXEL)
+
+/** Encoder of the frames of one sensor into telemetry packets
+ *
+ *  Every key_interval-th packet is a key frame, so a decoder which joins the
+ *  stream or lost a packet starts again there. After a packet could not be
+ *  sent, resync() makes the next one a key frame as well.
+ *
+ * Example:
+ * @code
+ *
+ * ThermoTelemetryEncoder encoder(16, true);
+ * uint8_t packet[THERMO_TELEMETRY_MAX_PACKET];
+ *
+ * uint32_t size = encoder.encode(frame, packet);
+ * if (!writer.write(packet, size)) {
+ *     encoder.resync();
+ * }
+ * @endcode
+ */
+class ThermoTelemetryEncoder
+{
+public:
+    /** Create an encoder
+     *
+     *  @param key_interval packets from one key frame to the next (1: key frames only)
+     *  @param delta        false: key frames only
+     */
+    ThermoTelemetryEncoder(int key_interval, bool delta);
+
+    /** Encode a frame
+     *
+     *  @param frame    sensor reading
+     *  @param p_packet output [THERMO_TELEMETRY_MAX_PACKET]
+     *  @return packet size [byte]
+     */
+    uint32_t encode(const ThermoFrame& frame, uint8_t* p_packet);
+
+    /** Send the next frame as a key frame */
+    void resync(void) { mSinceKey = mKeyInterval; }
+
+    /** CRC of a packet body (version ... payload) */
+    static uint16_t crc(const uint8_t* p_data, uint32_t size);
+
+private:
+    int mKeyInterval;
+    int mSinceKey;          // packets since the last key frame
+    bool mDelta;
+    uint8_t mCounter;
+    uint16_t mSensorId;     // sensor of mLast
+    int16_t mLast[THERMO_TELEMETRY_VALUES(THERMO_FRAME_PIXEL)];
+};
+
+#endif
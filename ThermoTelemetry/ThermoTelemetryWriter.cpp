@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ThermoTelemetryWriter.h"
+
+#define FLG_QUEUED      (0x00000001)
+#define RETRY_DELAY     (10)    // [ms] after the serial port failed
+
+ThermoTelemetryWriter::ThermoTelemetryWriter(ThermoHalSerial& serial, uint8_t* p_buffer, uint32_t size,
+                                             osPriority priority) :
+    mSerial(serial), mBuffer(p_buffer), mSize(size), mHead(0), mTail(0), mThread(priority, 1024)
+{
+    MBED_ASSERT((size != 0) && ((size & (size - 1)) == 0));
+    reset_stats();
+}
+
+void ThermoTelemetryWriter::start(void)
+{
+    mThread.start(callback(this, &ThermoTelemetryWriter::task));
+}
+
+bool ThermoTelemetryWriter::write(const uint8_t* p_data, uint32_t size)
+{
+    uint32_t head = mHead.load(std::memory_order_relaxed);
+    uint32_t used = head - mTail.load(std::memory_order_acquire);
+    uint32_t offset = head & (mSize - 1);
+    uint32_t first;
+
+    if ((mSize - used) < size) {
+        mStats.dropped++;
+        return false;
+    }
+    first = ((mSize - offset) < size) ? (mSize - offset) : size;
+    memcpy(&mBuffer[offset], p_data, first);
+    memcpy(&mBuffer[0], &p_data[first], size - first);
+    mHead.store(head + size, std::memory_order_release);
+    mFlags.set(FLG_QUEUED);
+
+    mStats.packets++;
+    mStats.bytes += size;
+    if ((used + size) > mStats.max_used) {
+        mStats.max_used = used + size;
+    }
+    return true;
+}
+
+void ThermoTelemetryWriter::task(void)
+{
+    while (true) {
+        uint32_t tail = mTail.load(std::memory_order_relaxed);
+        uint32_t head = mHead.load(std::memory_order_acquire);
+        uint32_t offset = tail & (mSize - 1);
+        uint32_t size;
+        int written;
+
+        if (head == tail) {
+            mFlags.wait_any(FLG_QUEUED);
+            continue;
+        }
+        // up to the end of the ring, the rest in the next round
+        size = head - tail;
+        if (size > (mSize - offset)) {
+            size = mSize - offset;
+        }
+        written = mSerial.write(&mBuffer[offset], size);
+        if (written <= 0) {
+            ThisThread::sleep_for(RETRY_DELAY);
+            continue;
+        }
+        mTail.store(tail + written, std::memory_order_release);
+    }
+}
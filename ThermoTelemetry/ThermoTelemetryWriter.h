@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_TELEMETRY_WRITER_H
+#define THERMO_TELEMETRY_WRITER_H
+
+#include <atomic>
+#include "mbed.h"
+#include "ThermoHalSerial.h"
+
+/** Counters of a ThermoTelemetryWriter */
+struct ThermoTelemetryStats {
+    uint32_t packets;       // queued packets
+    uint32_t dropped;       // packets which did not fit into the buffer
+    uint32_t bytes;         // queued bytes
+    uint32_t max_used;      // highest buffer use [byte]
+};
+
+/** Buffered writer of telemetry packets
+ *
+ *  write() copies a packet into a byte ring and returns at once; a thread
+ *  of low priority passes the ring on to the serial port, so a slow UART
+ *  never stalls the render loop. A packet which does not fit is dropped as
+ *  a whole (the encoder should send a key frame next).
+ *
+ *  write() is called from one thread only.
+ *
+ * Example:
+ * @code
+ *
+ * static uint8_t buffer[4096];
+ * ThermoTelemetryWriter writer(serial, buffer, sizeof(buffer));
+ *
+ * writer.start();
+ * if (!writer.write(packet, size)) {
+ *     encoder.resync();
+ * }
+ * @endcode
+ */
+class ThermoTelemetryWriter
+{
+public:
+    /** Create a writer
+     *
+     *  @param serial   output port, only used by the writer thread
+     *  @param p_buffer byte ring (must outlive the writer)
+     *  @param size     size of the ring, a power of 2
+     *  @param priority priority of the writer thread
+     */
+    ThermoTelemetryWriter(ThermoHalSerial& serial, uint8_t* p_buffer, uint32_t size,
+                          osPriority priority = osPriorityBelowNormal);
+
+    /** Start the writer thread */
+    void start(void);
+
+    /** Queue a packet, without waiting
+     *
+     *  @return true on success, false if the packet was dropped
+     */
+    bool write(const uint8_t* p_data, uint32_t size);
+
+    /** Bytes queued and not yet passed to the serial port */
+    uint32_t pending(void) const
+    {
+        return mHead.load(std::memory_order_acquire) - mTail.load(std::memory_order_acquire);
+    }
+
+    ThermoTelemetryStats stats(void) const { return mStats; }
+    void reset_stats(void) { memset(&mStats, 0, sizeof(mStats)); }
+
+private:
+    ThermoHalSerial& mSerial;
+    uint8_t* mBuffer;
+    uint32_t mSize;
+    std::atomic<uint32_t> mHead;    // bytes queued so far (producer)
+    std::atomic<uint32_t> mTail;    // bytes written so far (writer thread)
+    ThermoTelemetryStats mStats;
+    Thread mThread;
+    EventFlags mFlags;
+
+    void task(void);
+};
+
+#endif
@@ -23,13 +23,39 @@
  * DEALINGS IN THE SOFTWARE.
  */
 
+#include <stdarg.h>
 #include "mbed.h"
 #include "EasyAttach_CameraAndLCD.h"
 #include "r_dk2_if.h"
 #include "r_drp_simple_isp.h"
+#if MBED_CONF_APP_DRP_THERMAL
+#include "r_drp_resize_bilinear.h"
+#endif
 #include "D6T_44L_06.h"
-#include "dcache-control.h"
+#include "ThermoD6TDevice.h"
+#include "ThermoSensorManager.h"
+#include "ThermoMbedCache.h"
+#include "ThermoMbedDisplay.h"
+#include "ThermoMbedDrp.h"
 #include "AsciiFont.h"
+#include "ThermoKernel.h"
+#include "ThermoAutoRange.h"
+#include "ThermoBlitter.h"
+#include "ThermoRedraw.h"
+#include "ThermoReference.h"
+#include "ThermoRegistration.h"
+#include "ThermoFusion.h"
+#include "ThermoProfiler.h"
+#include "ThermoFrameScheduler.h"
+#include "ThermoDrpScheduler.h"
+#include "ThermoMbedSerial.h"
+#include "ThermoTelemetry.h"
+#include "ThermoTelemetryWriter.h"
+#if MBED_CONF_APP_RECORD
+#include "SdUsbConnect.h"
+#include "ThermoRecorder.h"
+#include "ThermoReplayDevice.h"
+#endif
 
 /*! Frame buffer stride: Frame buffer stride should be set to a multiple of 32 or 128
     in accordance with the frame buffer burst transfer mode. */
@@ -40,16 +66,34 @@
 #define FRAME_BUFFER_STRIDE_2  (((VIDEO_PIXEL_HW * 2) + 31u) & ~31u)
 #define FRAME_BUFFER_HEIGHT    (VIDEO_PIXEL_VW)
 
-#define DRP_FLG_TILE_ALL       (R_DK2_TILE_0 | R_DK2_TILE_1 | R_DK2_TILE_2 | R_DK2_TILE_3 | R_DK2_TILE_4 | R_DK2_TILE_5)
 #define DRP_FLG_CAMER_IN       (0x00000100)
+#define DRP_CAMERA_PERIOD_US   (33333)  /* camera frame period until it is measured */
+#define DRP_JOB_TIMEOUT        ((2 * DRP_CAMERA_PERIOD_US) / 1000)  /* [ms] longest wait of the render for the next camera frame */
 
 /* ASCII BUFFER Parameter GRAPHICS_LAYER_3 */
 #define ASCII_BUFFER_BYTE_PER_PIXEL   (2)
 #define ASCII_BUFFER_STRIDE           (((VIDEO_PIXEL_HW * ASCII_BUFFER_BYTE_PER_PIXEL) + 31u) & ~31u)
 #define ASCII_COLOR_WHITE             (0xFFFF)
 #define ASCII_COLOR_BLACK             (0x00F0)
+
+/* GRID BUFFER Parameter GRAPHICS_LAYER_2: one pixel per grid point, scaled up by the layer */
+#define GRID_BUFFER_STRIDE            (((TILE_RESO_160 * ASCII_BUFFER_BYTE_PER_PIXEL) + 31u) & ~31u)
 #define ASCII_FONT_SIZE               (3)
 
+/* Title of the thermograph: white box and text drawn over the tiles */
+#define TITLE_BOX_HW        (30)
+#define TITLE_BOX_VW        (20)
+#define TITLE_MAX_CHAR      (18)
+#define TITLE_AREA_HW       (AsciiFont::CHAR_PIX_WIDTH * ASCII_FONT_SIZE * TITLE_MAX_CHAR)
+#define TITLE_AREA_VW       (AsciiFont::CHAR_PIX_HEIGHT * ASCII_FONT_SIZE)
+
+#define STATS_FONT_SIZE     (1)
+#define STATS_MAX_CHAR      (32)
+#define STATS_AREA_HW       (AsciiFont::CHAR_PIX_WIDTH * STATS_FONT_SIZE * STATS_MAX_CHAR)
+#define STATS_AREA_VW       (AsciiFont::CHAR_PIX_HEIGHT * STATS_FONT_SIZE * 2)
+#define STATS_AREA_X        (VIDEO_PIXEL_HW - STATS_AREA_HW)
+#define STATS_AREA_Y        (VIDEO_PIXEL_VW - STATS_AREA_VW)
+
 #define TILE_ALPHA_MAX      (0x0F)
 #define TILE_ALPHA_SWITCH2  (0x0A)
 #define TILE_ALPHA_SWITCH1  (0x06)
@@ -58,7 +102,10 @@
 #define TILE_TEMP_MARGIN_UPPER (20)
 #define TILE_TEMP_MARGIN_UNDER (70)
 
-#define TILE_RESO_4         (4)
+/* sensor grid, the input of every resolution (mbed_app.json "d6t-model") */
+#define SENSOR_RESO_HW      (THERMO_FRAME_COLS)
+#define SENSOR_RESO_VW      (THERMO_FRAME_ROWS)
+
 #define TILE_RESO_8         (8)
 #define TILE_RESO_16        (16)
 #define TILE_RESO_32        (32)
@@ -69,8 +116,8 @@
 #define TILE_RESO_240       (240)
 #define TILE_RESO_320       (320)
 
-#define TILE_SIZE_HW_4x4    (VIDEO_PIXEL_HW/TILE_RESO_4)
-#define TILE_SIZE_VW_4x4    (VIDEO_PIXEL_VW/TILE_RESO_4)
+#define TILE_SIZE_HW_SENSOR (VIDEO_PIXEL_HW/SENSOR_RESO_HW)
+#define TILE_SIZE_VW_SENSOR (VIDEO_PIXEL_VW/SENSOR_RESO_VW)
 #define TILE_SIZE_HW_8x8    (VIDEO_PIXEL_HW/TILE_RESO_8)
 #define TILE_SIZE_VW_8x8    (VIDEO_PIXEL_VW/TILE_RESO_8)
 #define TILE_SIZE_HW_16x16  (VIDEO_PIXEL_HW/TILE_RESO_16)
@@ -87,11 +134,23 @@
 #define SUB_PHASE_MAX       (10)
 #define SUB_PHASE_DEMO1     SUB_PHASE_MAX*2
 #define SUB_PHASE_DEMO2     SUB_PHASE_MAX*3
-#define PHASE_DELAY         (200)
+#define FRAME_PERIOD        (1000 / MBED_CONF_APP_TARGET_FPS)   /* [ms], phases count frames */
 
-#ifndef M_PI
-#define M_PI                (3.1415926535897932384626433832795)
-#endif
+#define DISPLAY_SENSOR_ID   (0)     /* sensor shown on the display */
+#define REPLAY_OPEN_WAIT    (2000)  /* [ms] until a log which is not opened is reported */
+
+#define FUSED_ALPHA         (TILE_ALPHA_SWITCH1)    /* thermograph over the camera image of the fused export */
+#define FUSED_LINE_CHAR     (76)                    /* base64 characters per console line */
+
+#define TELEMETRY_BUFFER_SIZE   (4096)  /* byte ring of the telemetry writer, a power of 2 */
+
+/* profiler stages */
+#define PROFILE_FRAME       (0)     /* main loop work, without the sleep */
+#define PROFILE_RENDER      (1)     /* thermograph colors and tiles */
+#define PROFILE_CLEAN       (2)     /* cache clean of the dirty areas */
+#define PROFILE_CONSOLE     (3)     /* console dump */
+#define PROFILE_SENSOR      (4)     /* I2C reading, PEC check, decoding and temporal filter */
+#define PROFILE_DRP         (5)     /* camera ISP and thermal jobs on the DRP */
 
 static DisplayBase Display;
 
@@ -104,227 +163,706 @@ AsciiFont* p_af0;
 AsciiFont* p_af1;
 int screen = 0;
 
-/* thermal data array[y][x] */
-static float array4x4[TILE_RESO_4][TILE_RESO_4];
-static float array8x8[TILE_RESO_8][TILE_RESO_8];
-static float array16x16[TILE_RESO_16][TILE_RESO_16];
-static float array32x32[TILE_RESO_32][TILE_RESO_32];
-static float array64x60[TILE_RESO_60][TILE_RESO_64];
-static float array160x120[TILE_RESO_120][TILE_RESO_160];
+/* thermograph surface of each buffer (AsciiFont is only used for the title) */
+static ThermoBlitter blitter0(fbuf_ascii0, VIDEO_PIXEL_HW, VIDEO_PIXEL_VW, ASCII_BUFFER_STRIDE);
+static ThermoBlitter blitter1(fbuf_ascii1, VIDEO_PIXEL_HW, VIDEO_PIXEL_VW, ASCII_BUFFER_STRIDE);
+static uint16_t      color_row[TILE_RESO_160];
+
+/* display layer, cache and DRP of the board */
+static ThermoMbedDisplay hal_display(Display, DisplayBase::GRAPHICS_LAYER_3, VIDEO_PIXEL_HW, VIDEO_PIXEL_VW);
+static ThermoMbedCache   hal_cache;
+
+/* thermograph at grid size (mbed_app.json "grid-layer"), only when the layer has a scaler */
+static volatile bool grid_layer = false;
+#if MBED_CONF_APP_GRID_LAYER
+static uint8_t fbuf_grid0[GRID_BUFFER_STRIDE * TILE_RESO_120]__attribute((aligned(32)));
+static uint8_t fbuf_grid1[GRID_BUFFER_STRIDE * TILE_RESO_120]__attribute((aligned(32)));
+static ThermoBlitter grid_blitter0(fbuf_grid0, TILE_RESO_160, TILE_RESO_120, GRID_BUFFER_STRIDE);
+static ThermoBlitter grid_blitter1(fbuf_grid1, TILE_RESO_160, TILE_RESO_120, GRID_BUFFER_STRIDE);
+static ThermoMbedDisplay hal_grid_display(Display, DisplayBase::GRAPHICS_LAYER_2, VIDEO_PIXEL_HW, VIDEO_PIXEL_VW);
+#endif
+static ThermoMbedDrp     hal_drp;
+
+/* alpha of the thermograph at the display layer (mbed_app.json "layer-alpha"),
+   set when the layer is started; the tiles are drawn with TILE_ALPHA_MAX then */
+static volatile bool layer_alpha = false;
+static uint8_t       layer_alpha_value = 0xFF;
+
+/* counters of the last displayed frame */
+static ThermoBlitterStats frame_stats;
+
+/* color range of the frames (mbed_app.json "color-range"), the key 'a' switches fixed/auto */
+static ThermoAutoRange auto_range(MBED_CONF_APP_AUTO_RANGE_STRENGTH, MBED_CONF_APP_AUTO_RANGE_MIN_SPAN);
+static bool            range_auto = (MBED_CONF_APP_COLOR_RANGE != 0);
+static uint32_t        range_sequence = 0;     // sensor frame the range was last updated with (0: none)
+
+/* output region which differs from what the buffer being drawn shows (mbed_app.json "redraw-threshold") */
+static ThermoRedraw redraw(SENSOR_RESO_HW, SENSOR_RESO_VW, MBED_CONF_APP_REDRAW_THRESHOLD);
+
+/* hot path timing, shown by the console command 's' and the overlay 'o' */
+static ThermoProfiler profiler;
+static bool stats_console = false;
+static bool stats_overlay = (MBED_CONF_APP_STATS_OVERLAY != 0);
+
+/* display frames on absolute deadlines, overruns lower the resolution */
+static ThermoFrameScheduler scheduler(FRAME_PERIOD);
+
+typedef struct {
+    int reso_x;
+    int reso_y;
+    int tile_hw;
+    int tile_vw;
+} reso_step_t;
+
+/* resolutions from the highest, each degrade level goes one step down */
+static const reso_step_t reso_ladder[] = {
+    { TILE_RESO_160, TILE_RESO_120, TILE_SIZE_HW_160x120, TILE_SIZE_VW_160x120 },
+    { TILE_RESO_64,  TILE_RESO_60,  TILE_SIZE_HW_64x60,   TILE_SIZE_VW_64x60   },
+    { TILE_RESO_32,  TILE_RESO_32,  TILE_SIZE_HW_32x32,   TILE_SIZE_VW_32x32   },
+    { TILE_RESO_16,  TILE_RESO_16,  TILE_SIZE_HW_16x16,   TILE_SIZE_VW_16x16   },
+    { TILE_RESO_8,   TILE_RESO_8,   TILE_SIZE_HW_8x8,     TILE_SIZE_VW_8x8     },
+};
+
+typedef struct {
+    int16_t reso_x;     /* 0: thermograph off */
+    int16_t reso_y;
+    int16_t tile_hw;
+    int16_t tile_vw;
+    uint8_t alpha;
+    uint8_t frames;     /* number of frames the mode is shown in the demo cycle */
+} display_mode_t;
+
+/* display modes of the demo cycle, in the order they are shown */
+static constexpr display_mode_t mode_table[] = {
+    { SENSOR_RESO_HW, SENSOR_RESO_VW, TILE_SIZE_HW_SENSOR,  TILE_SIZE_VW_SENSOR,  TILE_ALPHA_MAX,     SUB_PHASE_DEMO1 },
+    { TILE_RESO_8,    TILE_RESO_8,    TILE_SIZE_HW_8x8,     TILE_SIZE_VW_8x8,     TILE_ALPHA_MAX,     SUB_PHASE_MAX   },
+    { TILE_RESO_16,   TILE_RESO_16,   TILE_SIZE_HW_16x16,   TILE_SIZE_VW_16x16,   TILE_ALPHA_MAX,     SUB_PHASE_MAX   },
+    { TILE_RESO_32,   TILE_RESO_32,   TILE_SIZE_HW_32x32,   TILE_SIZE_VW_32x32,   TILE_ALPHA_MAX,     SUB_PHASE_MAX   },
+    { TILE_RESO_64,   TILE_RESO_60,   TILE_SIZE_HW_64x60,   TILE_SIZE_VW_64x60,   TILE_ALPHA_MAX,     SUB_PHASE_MAX   },
+    { TILE_RESO_160,  TILE_RESO_120,  TILE_SIZE_HW_160x120, TILE_SIZE_VW_160x120, TILE_ALPHA_MAX,     SUB_PHASE_DEMO2 },
+    { TILE_RESO_160,  TILE_RESO_120,  TILE_SIZE_HW_160x120, TILE_SIZE_VW_160x120, TILE_ALPHA_SWITCH2, SUB_PHASE_MAX   },
+    { TILE_RESO_160,  TILE_RESO_120,  TILE_SIZE_HW_160x120, TILE_SIZE_VW_160x120, TILE_ALPHA_SWITCH1, SUB_PHASE_MAX   },
+    { TILE_RESO_160,  TILE_RESO_120,  TILE_SIZE_HW_160x120, TILE_SIZE_VW_160x120, TILE_ALPHA_DEFAULT, SUB_PHASE_DEMO2 },
+    { TILE_RESO_64,   TILE_RESO_60,   TILE_SIZE_HW_64x60,   TILE_SIZE_VW_64x60,   TILE_ALPHA_DEFAULT, SUB_PHASE_MAX   },
+    { TILE_RESO_32,   TILE_RESO_32,   TILE_SIZE_HW_32x32,   TILE_SIZE_VW_32x32,   TILE_ALPHA_DEFAULT, SUB_PHASE_MAX   },
+    { TILE_RESO_16,   TILE_RESO_16,   TILE_SIZE_HW_16x16,   TILE_SIZE_VW_16x16,   TILE_ALPHA_DEFAULT, SUB_PHASE_MAX   },
+    { TILE_RESO_8,    TILE_RESO_8,    TILE_SIZE_HW_8x8,     TILE_SIZE_VW_8x8,     TILE_ALPHA_DEFAULT, SUB_PHASE_MAX   },
+    { SENSOR_RESO_HW, SENSOR_RESO_VW, TILE_SIZE_HW_SENSOR,  TILE_SIZE_VW_SENSOR,  TILE_ALPHA_DEFAULT, SUB_PHASE_DEMO1 },
+    { 0,              0,              0,                    0,                    0,                  SUB_PHASE_MAX   },
+};
+#define DISPLAY_MODE_NUM    ((int)(sizeof(mode_table) / sizeof(mode_table[0])))
+
+/* mbed_app.json "display-mode": -1 runs the demo cycle, otherwise one mode of mode_table is shown */
+static_assert((MBED_CONF_APP_DISPLAY_MODE >= -1) && (MBED_CONF_APP_DISPLAY_MODE < DISPLAY_MODE_NUM), "display-mode is not an index of mode_table");
+
+/* key of the expanded grid held by the renderer, the modes which only change the alpha reuse it */
+typedef struct {
+    bool     valid;
+    uint16_t sensor_id;
+    uint32_t sequence;
+    int      reso_x;
+    int      reso_y;
+    int      min;
+    int      max;
+} grid_key_t;
+
+static grid_key_t grid_key;
+static uint32_t   grid_hits;
+static uint32_t   grid_misses;
+
+#if MBED_CONF_APP_RENDER_REFERENCE
+/* reference path: normalized thermal data array[y][x] */
+static_assert((SENSOR_RESO_HW >= 2) && (SENSOR_RESO_VW >= 2), "liner_interpolation needs a 2x2 sensor grid at least");
+static float array_sensor[SENSOR_RESO_VW][SENSOR_RESO_HW];
+static float array_expand[TILE_RESO_120][TILE_RESO_160];
+#else
+/* index/weight tables from the sensor grid to each expansion size (built at compile time) */
+static constexpr ThermoResampleTable<SENSOR_RESO_HW, SENSOR_RESO_VW, TILE_RESO_8, TILE_RESO_8>     table8x8{};
+static constexpr ThermoResampleTable<SENSOR_RESO_HW, SENSOR_RESO_VW, TILE_RESO_16, TILE_RESO_16>   table16x16{};
+static constexpr ThermoResampleTable<SENSOR_RESO_HW, SENSOR_RESO_VW, TILE_RESO_32, TILE_RESO_32>   table32x32{};
+static constexpr ThermoResampleTable<SENSOR_RESO_HW, SENSOR_RESO_VW, TILE_RESO_64, TILE_RESO_60>   table64x60{};
+static constexpr ThermoResampleTable<SENSOR_RESO_HW, SENSOR_RESO_VW, TILE_RESO_160, TILE_RESO_120> table160x120{};
+static constexpr ThermoCubicTable<SENSOR_RESO_HW, SENSOR_RESO_VW, TILE_RESO_8, TILE_RESO_8>       cubic8x8{};
+static constexpr ThermoCubicTable<SENSOR_RESO_HW, SENSOR_RESO_VW, TILE_RESO_16, TILE_RESO_16>     cubic16x16{};
+static constexpr ThermoCubicTable<SENSOR_RESO_HW, SENSOR_RESO_VW, TILE_RESO_32, TILE_RESO_32>     cubic32x32{};
+static constexpr ThermoCubicTable<SENSOR_RESO_HW, SENSOR_RESO_VW, TILE_RESO_64, TILE_RESO_60>     cubic64x60{};
+static constexpr ThermoCubicTable<SENSOR_RESO_HW, SENSOR_RESO_VW, TILE_RESO_160, TILE_RESO_120>   cubic160x120{};
+
+static const ThermoResampler resampler_list[] = {
+    ThermoResampler(table8x8,     cubic8x8),
+    ThermoResampler(table16x16,   cubic16x16),
+    ThermoResampler(table32x32,   cubic32x32),
+    ThermoResampler(table64x60,   cubic64x60),
+    ThermoResampler(table160x120, cubic160x120),
+};
+
+/* interpolation of the expansion (mbed_app.json "upscale-mode") */
+static_assert((MBED_CONF_APP_UPSCALE_MODE >= THERMO_RESAMPLE_LINEAR) && (MBED_CONF_APP_UPSCALE_MODE <= THERMO_RESAMPLE_EDGE),
+              "upscale-mode is 0 (linear), 1 (cubic) or 2 (edge-aware)");
+#define UPSCALE_MODE        ((ThermoResampleMode)MBED_CONF_APP_UPSCALE_MODE)
+
+/* ARGB4444 color table of normalized and raw thermal data */
+static ThermoPalette palette;
+static ThermoKernel  kernel(palette);
+#endif
+
+/* registration of the thermograph on the camera image (mbed_app.json "registration"),
+   a sampling map at 160*120 for the fused export of the console command 'f' */
+static const float    registration_h[9] = MBED_CONF_APP_REGISTRATION;
+static uint16_t       registration_map[THERMO_REG_MAP_SIZE(VIDEO_PIXEL_HW, VIDEO_PIXEL_VW)];
+static ThermoRegistration registration(registration_map, VIDEO_PIXEL_HW, VIDEO_PIXEL_VW);
+static ThermoFusion   fusion(registration);
+static uint16_t       fused_colors[TILE_RESO_120 * TILE_RESO_160];
+static uint8_t        fused_row[THERMO_BMP_ROW_SIZE(VIDEO_PIXEL_HW)];
+static bool           fused_request = false;
+
+#if !MBED_CONF_APP_TELEMETRY
+/* the export runs on its own thread from a copy of the camera rows it reads (every fused-step-th row),
+   taken by the DRP task between two ISP runs; each state is left by one thread only */
+static_assert((MBED_CONF_APP_FUSED_STEP == 1) || (MBED_CONF_APP_FUSED_STEP == 2) || (MBED_CONF_APP_FUSED_STEP == 4),
+              "fused-step is 1, 2 or 4");
+#define FUSED_IDLE          (0)     /* display loop: colors and a snapshot can be requested */
+#define FUSED_SNAPSHOT      (1)     /* DRP task: copy the next camera image */
+#define FUSED_ENCODE        (2)     /* export task: print the BMP */
+#define FUSED_FLG_ENCODE    (0x00000001)
+static uint8_t        fused_yuv[FRAME_BUFFER_STRIDE_2 * (FRAME_BUFFER_HEIGHT / MBED_CONF_APP_FUSED_STEP)]__attribute((aligned(32)));
+static volatile int   fused_state = FUSED_IDLE;
+static Thread         fusedTask(osPriorityBelowNormal, 1024*4);
+#endif
+
+typedef struct {
+    uint8_t  carry[3];      /* bytes of an incomplete group */
+    int      carry_len;
+    char     line[FUSED_LINE_CHAR + 3];
+    int      line_len;
+} base64_writer_t;
 
 static r_drp_simple_isp_t param_isp __attribute((section("NC_BSS")));
-static uint8_t drp_lib_id[R_DK2_TILE_NUM] = {0};
+
+/* the camera ISP keeps the DRP, thermal jobs borrow its tiles between camera frames */
+static const ThermoDrpLibrary drp_isp = { g_drp_lib_simple_isp_bayer2yuv_6, R_DK2_TILE_0, R_DK2_TILE_PATTERN_6 };
+static ThermoDrpScheduler drp_scheduler(hal_drp, drp_isp, DRP_CAMERA_PERIOD_US);
+
+#if !MBED_CONF_APP_RENDER_REFERENCE
+/* expanded grid of the DRP resize (mbed_app.json "drp-thermal"), the palette maps it on the CPU */
+static bool grid_on_drp = false;
+#endif
+#if MBED_CONF_APP_DRP_THERMAL
+static const ThermoDrpLibrary drp_resize = { g_drp_lib_resize_bilinear, R_DK2_TILE_0, R_DK2_TILE_PATTERN_1_1_1_1_1_1 };
+static r_drp_resize_bilinear_t param_resize __attribute((section("NC_BSS")));
+static uint8_t drp_grid_src[SENSOR_RESO_VW * SENSOR_RESO_HW] __attribute((section("NC_BSS")));
+static uint8_t drp_grid_dst[TILE_RESO_120 * TILE_RESO_160] __attribute((section("NC_BSS")));
+#endif
 static Thread drpTask(osPriorityHigh, 1024*8);
-static D6T_44L_06 d6t_44l(I2C_SDA, I2C_SCL);
+static D6T<ThermoSensorModel> d6t_sensor(I2C_SDA, I2C_SCL, MBED_CONF_APP_I2C_FREQUENCY);
+static ThermoD6TDevice d6t_device(d6t_sensor);
+#if MBED_CONF_APP_RECORD == 2
+/* the replay device opens and reads the log on the acquisition thread */
+static ThermoAcquisition sensor_bus(MBED_CONF_APP_SENSOR_PERIOD, osPriorityAboveNormal, THERMO_REPLAY_STACK);
+#else
+static ThermoAcquisition sensor_bus(MBED_CONF_APP_SENSOR_PERIOD);
+#endif
+static_assert(D6T_READ_TIME_US(ThermoSensorModel::N_READ, MBED_CONF_APP_I2C_FREQUENCY) <= (MBED_CONF_APP_SENSOR_PERIOD * 1000),
+              "a sensor reading takes longer than sensor-period at i2c-frequency");
+static ThermoFrameFilter sensor_filter((ThermoFilterMode)MBED_CONF_APP_FILTER, MBED_CONF_APP_FILTER_STRENGTH,
+                                       MBED_CONF_APP_FILTER_DEADBAND);
+static ThermoSensorManager sensors;
+
+#if MBED_CONF_APP_RECORD
+/* frame log on the SD card or USB drive (mbed_app.json "record") */
+static SdUsbConnect storage("storage");
+static uint8_t      record_chunk[THERMO_LOG_CHUNK_SIZE]__attribute((aligned(32)));
+#endif
+#if MBED_CONF_APP_RECORD == 1
+static ThermoLogWriter    record_log(record_chunk);
+static ThermoRecorder     recorder(sensors, DISPLAY_SENSOR_ID, record_log, MBED_CONF_APP_SENSOR_PERIOD);
+#elif MBED_CONF_APP_RECORD == 2
+static ThermoLogReader    replay_log(record_chunk);
+static ThermoReplayDevice replay_device(replay_log, MBED_CONF_APP_RECORD_FILE, true, MBED_CONF_APP_REPLAY_PACED);
+#endif
+
+#if MBED_CONF_APP_TELEMETRY
+/* binary frame stream on the console UART instead of the text dump (mbed_app.json "telemetry") */
+static_assert(THERMO_TELEMETRY_MAX_PACKET <= TELEMETRY_BUFFER_SIZE, "a telemetry packet does not fit the writer buffer");
+static ThermoMbedSerial       hal_serial;
+static uint8_t                telemetry_buffer[TELEMETRY_BUFFER_SIZE];
+static ThermoTelemetryWriter  telemetry(hal_serial, telemetry_buffer, sizeof(telemetry_buffer));
+static ThermoTelemetryEncoder telemetry_encoder(MBED_CONF_APP_TELEMETRY_KEYFRAME, (MBED_CONF_APP_TELEMETRY == 2));
+static uint8_t                telemetry_packet[THERMO_TELEMETRY_MAX_PACKET];
+static uint32_t               telemetry_cursor = 0;
+#endif
+
+/*******************************************************************************
+* Function Name: draw_stats
+* Description  : Draw the mean stage times and the sensor error counters
+*                in the lower right corner of the buffer being drawn.
+* Arguments    : p_af      - font of the buffer being drawn
+*                p_blitter - surface of the buffer being drawn
+* Return Value : none
+*******************************************************************************/
+static void draw_stats(AsciiFont* p_af, ThermoBlitter* p_blitter)
+{
+    ThermoStageStats frame;
+    ThermoStageStats render;
+    ThermoStageStats sensor;
+    D6T_Stats d6t = d6t_sensor.stats();
+    char str[STATS_MAX_CHAR + 1];
+
+    profiler.stats(PROFILE_FRAME, frame);
+    profiler.stats(PROFILE_RENDER, render);
+    profiler.stats(PROFILE_SENSOR, sensor);
+
+    p_blitter->fill_rect(ASCII_COLOR_BLACK, STATS_AREA_X, STATS_AREA_Y, STATS_AREA_HW, STATS_AREA_VW);
+    snprintf(str, sizeof(str), "frame %6luus render %6luus",
+             (unsigned long)frame.recent_mean_us, (unsigned long)render.recent_mean_us);
+    p_af->DrawStr(str, STATS_AREA_X, STATS_AREA_Y, ASCII_COLOR_WHITE, STATS_FONT_SIZE, STATS_MAX_CHAR);
+    snprintf(str, sizeof(str), "i2c %6luus err %4lu pec %4lu",
+             (unsigned long)sensor.recent_mean_us, (unsigned long)d6t.i2c_errors, (unsigned long)d6t.pec_errors);
+    p_af->DrawStr(str, STATS_AREA_X, STATS_AREA_Y + (AsciiFont::CHAR_PIX_HEIGHT * STATS_FONT_SIZE),
+                  ASCII_COLOR_WHITE, STATS_FONT_SIZE, STATS_MAX_CHAR);
+    p_blitter->mark_dirty(STATS_AREA_X, STATS_AREA_Y, STATS_AREA_HW, STATS_AREA_VW);
+}
+/*******************************************************************************
+ End of function draw_stats
+*******************************************************************************/
 
 /*******************************************************************************
-* Function Name: normalize0to1
-* Description  : Normalize thermal data of a reception packet to the range of 0-1.
-*                Also the value outside min, max is saturated.
-* Arguments    : data     - input tempetue data
-*                min      - smallest threshold tempature value
-*                           (The integer which set a centigrade to 10 times)
-*                max      - highest threshold  tempature value
-*                           (The integer which set a centigrade to 10 times)
-* Return Value : normalized output data
+* Function Name: show_thermograph
+* Description  : Draw the title (and the stats overlay) and display the thermograph buffer being drawn,
+*                then switch the drawing buffer.
+*                Only the dirty areas of the buffer are cleaned from the data cache.
+* Arguments    : p_af      - font of the buffer being drawn
+*                p_blitter - surface of the buffer being drawn
+*                title_str - title string
+*                title_len - max number of title characters
+* Return Value : none
 *******************************************************************************/
-float normalize0to1(int16_t data, int min, int max)
+static void show_thermograph(AsciiFont* p_af, ThermoBlitter* p_blitter, const char* title_str, uint16_t title_len)
 {
-    float normalized;
+    p_blitter->fill_rect(ASCII_COLOR_WHITE, 0, 0, TITLE_BOX_HW, TITLE_BOX_VW);
+    p_af->DrawStr(title_str, 0, 0, ASCII_COLOR_BLACK, ASCII_FONT_SIZE, title_len);
+    p_blitter->mark_dirty(0, 0, TITLE_AREA_HW, TITLE_AREA_VW);
+    if (stats_overlay)
+    {
+        draw_stats(p_af, p_blitter);
+    }
 
-    if (data <= min) {
-        normalized = 0.0;
+    // clean only the cache lines written in this frame
+    {
+        ThermoScopedTimer timer(profiler, PROFILE_CLEAN);
+        p_blitter->clean_dirty(hal_cache);
     }
-    else if (max <= data) {
-        normalized = 1.0;
+    frame_stats = p_blitter->stats();
+    hal_display.swap(p_blitter->buffer());
+
+    if (0 == screen)
+    {
+        screen = 1;
     }
-    else {
-        normalized = ((float)(data - min)) / ((float)(max - min));
+    else
+    {
+        screen = 0;
     }
-    return normalized;
 }
 /*******************************************************************************
- End of function normalize0to1
-*******************************************************************************/
-
-/*******************************************************************************
-* Function Name: conv_normalize_to_color
-* Description  : Change a floating-point data of 0.0-1.0 to the pixel color of
-*                ARGB4444(truth order:GBAR).
-*                Low temperature changes blue and high temperature to red.
-* Arguments    : data        - Normalized thermal data from 0.0 to 1.0.
-* Return Value : ARGB4444 pixel color data.
-*******************************************************************************/
-static uint16_t conv_normalize_to_color(uint8_t alpha, float data) {
-    uint8_t green;
-    uint8_t blue;
-    uint8_t red;
-
-    if (0.0 == data) {
-        /* Display blue when the temperature is below the minimum. */
-        blue  = 0x0F;
-        green = 0x00;
-        red   = 0x00;
-    }
-    else if (1.0 == data) {
-        /* Display red when the maximum temperature is exceeded. */
-        blue  = 0x00;
-        green = 0x00;
-        red   = 0x0F;
-    }
-    else {
-        float cosval   = cos( 4 * M_PI * data);
-        int    color    = (int)((((-cosval)/2) + 0.5) * 15);
-        if (data < 0.25) {
-            blue  = 0xF;
-            green = color;
-            red   = 0x00;
-        }
-        else if (data < 0.50) {
-            blue  = color;
-            green = 0x0F;
-            red   = 0x00;
-        }
-        else if (data < 0.75) {
-            blue  = 0x00;
-            green = 0x0F;
-            red   = color;
+ End of function show_thermograph
+*******************************************************************************/
+
+#if !MBED_CONF_APP_RENDER_REFERENCE
+/*******************************************************************************
+* Function Name: find_resampler
+* Description  : Find the expansion table of the sensor grid.
+* Arguments    : reso_x    - output array x size
+*                reso_y    - output array y size
+* Return Value : expansion table, NULL if the output is the sensor grid
+*******************************************************************************/
+static const ThermoResampler* find_resampler(int reso_x, int reso_y)
+{
+    if ((SENSOR_RESO_HW == reso_x) && (SENSOR_RESO_VW == reso_y)) {
+        return NULL;
+    }
+    for (const ThermoResampler& resampler : resampler_list) {
+        if ((resampler.out_width() == reso_x) && (resampler.out_height() == reso_y)) {
+            return &resampler;
         }
-        else {
-            blue  = 0x00;
-            green = color;
-            red   = 0x0F;
+    }
+    MBED_ASSERT(false);
+    return NULL;
+}
+/*******************************************************************************
+ End of function find_resampler
+*******************************************************************************/
+#endif
+
+/*******************************************************************************
+* Function Name: degrade_reso
+* Description  : Go down the resolution ladder by the degrade level of the scheduler.
+*                Resolutions which are not on the ladder are left as they are.
+* Arguments    : p_reso_x  - output array x size (updated)
+*                p_reso_y  - output array y size (updated)
+*                p_tile_hw - tile width pixel size (updated)
+*                p_tile_vw - tile height pixel size (updated)
+*                level     - degrade level
+* Return Value : true if the resolution was lowered
+*******************************************************************************/
+static bool degrade_reso(int* p_reso_x, int* p_reso_y, int* p_tile_hw, int* p_tile_vw, int level)
+{
+    const int step_num = sizeof(reso_ladder) / sizeof(reso_ladder[0]);
+    int step;
+
+    if (0 == level)
+    {
+        return false;
+    }
+    for (step = 0; step < step_num; step++)
+    {
+        if ((reso_ladder[step].reso_x == *p_reso_x) && (reso_ladder[step].reso_y == *p_reso_y))
+        {
+            break;
         }
     }
+    if ((step >= step_num) || (step == (step_num - 1)))
+    {
+        return false;
+    }
 
-    return ((green << 12) | (blue << 8) | (alpha << 4) | red);
+    step += level;
+    if (step >= step_num)
+    {
+        step = step_num - 1;
+    }
+    *p_reso_x  = reso_ladder[step].reso_x;
+    *p_reso_y  = reso_ladder[step].reso_y;
+    *p_tile_hw = reso_ladder[step].tile_hw;
+    *p_tile_vw = reso_ladder[step].tile_vw;
+    return true;
 }
-
 /*******************************************************************************
- End of function conv_normalize_to_color
+ End of function degrade_reso
 *******************************************************************************/
 
 /*******************************************************************************
-* Function Name: liner_interpolation
-* Description  : Expand float data array from array[y_in_size][x_in_size] to array[y_out_size][x_out_size]
-*                Linear complementation is used for expansion algorithm.
-* Arguments    : p_in_array   - pointer of input data
-*                p_out_array  - pointer of output data
-*                x_in_size    - input array x size
-*                y_in_size    - input array y size
-*                x_out_size   - output array x size
-*                y_out_size   - output array y size
+* Function Name: set_thermograph_alpha
+* Description  : Apply the alpha of the thermograph at the display layer.
+*                Nothing is written while the alpha stays the same.
+* Arguments    : alpha - alpha pixel value of thermograph
 * Return Value : none
 *******************************************************************************/
-static void liner_interpolation(float* p_in_array, float* p_out_array, int x_in_size, int y_in_size, int x_out_size, int y_out_size)
+static void set_thermograph_alpha(uint8_t alpha)
 {
-    int   x_in;
-    int   y_in;
-    int   x_out_start;
-    int   x_out_goal;
-    float x_delta;
-    int   x_w_pos;
-    int   y_out_start;
-    int   y_out_goal;
-    float y_delta;
-    int   y_w_pos;
-    float data_start;
-    float data_goal;
-    float data_w_pos;
-
-    /* expand x direction */
-    for (y_in = 0; y_in < y_in_size; y_in++) {
-        y_out_goal = (y_out_size - 1) * y_in / (y_in_size - 1);
-        for (x_in = 1; x_in < x_in_size; x_in++) {
-            x_out_start  = (x_out_size - 1) * (x_in - 1) / (x_in_size - 1);
-            x_out_goal   = (x_out_size - 1) * (x_in    ) / (x_in_size - 1);
-            x_delta   = x_out_goal - x_out_start;
-
-            data_start = p_in_array[(x_in - 1) + (x_in_size * y_in)];
-            data_goal  = p_in_array[(x_in    ) + (x_in_size * y_in)];
-
-            for (x_w_pos = x_out_start; x_w_pos <= x_out_goal; x_w_pos++) {
-                data_w_pos = (data_start * ((x_out_goal - x_w_pos ) / x_delta))
-                           + (data_goal  * ((x_w_pos - x_out_start) / x_delta));
-                p_out_array[x_w_pos + (x_out_size * y_out_goal)] = data_w_pos;
-            }
-        }
+    uint8_t value = thermo_layer_alpha(alpha);
+
+    // the grid layer is small, it keeps the alpha in the pixels
+    if (layer_alpha && !grid_layer && (value != layer_alpha_value))
+    {
+        hal_display.set_layer_alpha(value);
+        layer_alpha_value = value;
     }
+}
+/*******************************************************************************
+ End of function set_thermograph_alpha
+*******************************************************************************/
 
-    /* expand y direction */
-    for (x_w_pos = 0; x_w_pos < x_out_size; x_w_pos++) {
-        for (y_in = 1; y_in < y_in_size; y_in++) {
-            y_out_start  = (y_out_size - 1) * (y_in - 1) / (y_in_size - 1);
-            y_out_goal   = (y_out_size - 1) * (y_in    ) / (y_in_size - 1);
-            y_delta   = y_out_goal - y_out_start;
+/*******************************************************************************
+* Function Name: grid_cached
+* Description  : Check whether the expanded grid of the renderer already holds the frame
+*                at this resolution and range, and take the frame as the new key if not.
+* Arguments    : p_frame - thermal frame
+*                reso_x  - output array x size
+*                reso_y  - output array y size
+*                min     - smallest threshold temperature value
+*                max     - highest threshold temperature value
+* Return Value : true  - the grid can be reused
+*                false - the grid has to be expanded again
+*******************************************************************************/
+static bool grid_cached(const ThermoFrame* p_frame, int reso_x, int reso_y, int min, int max)
+{
+    if (grid_key.valid && (grid_key.sensor_id == p_frame->sensor_id) && (grid_key.sequence == p_frame->sequence)
+        && (grid_key.reso_x == reso_x) && (grid_key.reso_y == reso_y) && (grid_key.min == min) && (grid_key.max == max))
+    {
+        grid_hits++;
+        return true;
+    }
+    grid_key.valid     = true;
+    grid_key.sensor_id = p_frame->sensor_id;
+    grid_key.sequence  = p_frame->sequence;
+    grid_key.reso_x    = reso_x;
+    grid_key.reso_y    = reso_y;
+    grid_key.min       = min;
+    grid_key.max       = max;
+    grid_misses++;
+    return false;
+}
+/*******************************************************************************
+ End of function grid_cached
+*******************************************************************************/
 
-            data_start = p_out_array[x_w_pos + (x_out_size * y_out_start)];
-            data_goal  = p_out_array[x_w_pos + (x_out_size * y_out_goal)];
+#if !MBED_CONF_APP_RENDER_REFERENCE
+/*******************************************************************************
+* Function Name: expand_on_drp
+* Description  : Expand the sensor grid as an 8-bit index grid on the DRP,
+*                between two camera frames.
+* Arguments    : p_raw  - pointer of temperature data array [SENSOR_RESO_VW][SENSOR_RESO_HW]
+*                reso_x - output array x size
+*                reso_y - output array y size
+*                min    - smallest threshold temperature value
+*                max    - highest threshold temperature value
+* Return Value : true  - drp_grid_dst holds the index grid [reso_y][reso_x]
+*                false - expand on the CPU
+*******************************************************************************/
+static bool expand_on_drp(const int16_t* p_raw, int reso_x, int reso_y, int min, int max)
+{
+#if MBED_CONF_APP_DRP_THERMAL
+    int i;
 
-            for (y_w_pos = y_out_start+1; y_w_pos < y_out_goal; y_w_pos++) {
-                data_w_pos = (data_start * ((y_out_goal - y_w_pos ) / y_delta))
-                           + (data_goal  * ((y_w_pos - y_out_start) / y_delta));
-                p_out_array[x_w_pos + (x_out_size * y_w_pos)] = data_w_pos;
-            }
-        }
+    // the DRP resize is bilinear
+    if ((NULL == find_resampler(reso_x, reso_y)) || !drp_scheduler.has_thermal() || (THERMO_RESAMPLE_LINEAR != UPSCALE_MODE))
+    {
+        return false;
+    }
+    for (i = 0; i < (SENSOR_RESO_HW * SENSOR_RESO_VW); i++)
+    {
+        drp_grid_src[i] = thermo_index_q15(thermo_normalize_q15(p_raw[i], min, max));
+    }
+    // the only place naming the fields of r_drp_resize_bilinear_t, the header comes with
+    // the DRP library package (not in this tree), sim/SimDrpLib.h mirrors it for the host
+    param_resize.src        = (uint32_t)drp_grid_src;
+    param_resize.dst        = (uint32_t)drp_grid_dst;
+    param_resize.src_width  = SENSOR_RESO_HW;
+    param_resize.src_height = SENSOR_RESO_VW;
+    param_resize.dst_width  = reso_x;
+    param_resize.dst_height = reso_y;
+
+    return drp_scheduler.run_thermal((void *)&param_resize, sizeof(param_resize), DRP_JOB_TIMEOUT);
+#else
+    return false;
+#endif
+}
+/*******************************************************************************
+ End of function expand_on_drp
+*******************************************************************************/
+#endif
+
+/*******************************************************************************
+* Function Name: begin_redraw
+* Description  : Find the tiles of the buffer being drawn which differ from the new frame.
+*                The buffer is compared with the frame it shows, not with the last one drawn.
+*                The tiles under the title are redrawn every frame, the title text is
+*                drawn over them.
+* Arguments    : p_tiles - surface of the tiles being drawn
+*                p_raw   - temperature data [SENSOR_RESO_VW][SENSOR_RESO_HW]
+*                reso_x  - output array x size
+*                reso_y  - output array y size
+*                tile_hw - tile width pixel size
+*                tile_vw - tile height pixel size
+*                min     - smallest threshold temperature value
+*                max     - highest threshold temperature value
+*                style   - alpha and expansion of the tiles, a change redraws every tile
+*                reach   - source samples on each side read by an output point (THERMO_REDRAW_REACH_*)
+* Return Value : none
+*******************************************************************************/
+static void begin_redraw(const ThermoBlitter* p_tiles, const int16_t* p_raw, int reso_x, int reso_y,
+                         int tile_hw, int tile_vw, int min, int max, uint32_t style, int reach)
+{
+    ThermoRedrawKey key;
+
+    key.width  = reso_x;
+    key.height = reso_y;
+    key.min    = min;
+    key.max    = max;
+    key.style  = style;
+    redraw.begin(screen, p_raw, key, reach, p_tiles->redraw_pending(reso_x, tile_hw, tile_vw));
+    if (!grid_layer)
+    {
+        redraw.add_rect(0, 0, (TITLE_AREA_HW + tile_hw - 1) / tile_hw, (TITLE_AREA_VW + tile_vw - 1) / tile_vw);
     }
 }
 /*******************************************************************************
- End of function liner_interpolation
+ End of function begin_redraw
 *******************************************************************************/
 
 /*******************************************************************************
 * Function Name: update_thermograph
 * Description  : Update display thermograph.
-* Arguments    : reso_x    - input array x size
-*                reso_y    - input array y size
+*                Draws the frame at reso_x * reso_y (lower while the frame
+*                scheduler degrades) into the back buffer and shows it.
+* Arguments    : reso_x    - output array x size
+*                reso_y    - output array y size
 *                tile_hw   - tile width pixel size
 *                tile_vw   - tile height pixel size
 *                alpha     - alpha pixel value of thermograph
-*                p_array   - pointer of thermal data array
+*                p_frame   - thermal frame of the sensor grid [SENSOR_RESO_VW][SENSOR_RESO_HW]
+*                min       - smallest threshold temperature value
+*                max       - highest threshold temperature value
 *                title_str - title string
 * Return Value : none
 *******************************************************************************/
-void update_thermograph(int reso_x, int reso_y, int tile_hw, int tile_vw, uint8_t alpha, float* p_array, const char* title_str)
+void update_thermograph(int reso_x, int reso_y, int tile_hw, int tile_vw, uint8_t alpha,
+                        const ThermoFrame* p_frame, int min, int max, const char* title_str)
 {
-    AsciiFont* p_af;
-    uint8_t*   p_fbuf;
-    int x, y;
-    uint16_t color;
+    const int16_t* p_raw = &p_frame->pixel[0];
+    AsciiFont*     p_af;
+    ThermoBlitter* p_blitter;
+    ThermoBlitter* p_tiles;
+    uint32_t       start = thermo_cycle_read();
+    char           degraded_str[TITLE_MAX_CHAR + 1];
+    bool           degraded;
+    uint8_t        pixel_alpha = (layer_alpha && !grid_layer) ? TILE_ALPHA_MAX : alpha;
+    uint32_t       style = pixel_alpha | (grid_layer ? 0x100 : 0);
+    int x0;
+    int x1;
+    int y;
 
     if (0 == screen)
     {
         p_af = p_af0;
-        p_fbuf = &fbuf_ascii0[0];
+        p_blitter = &blitter0;
     }
     else
     {
         p_af = p_af1;
-        p_fbuf = &fbuf_ascii1[0];
+        p_blitter = &blitter1;
+    }
+    p_blitter->begin_frame();
+
+    // frames which overran lower the resolution
+    degraded = degrade_reso(&reso_x, &reso_y, &tile_hw, &tile_vw, scheduler.degrade());
+
+    // the sensor grid is the lowest resolution, it is never reduced
+    if ((reso_x < SENSOR_RESO_HW) || (reso_y < SENSOR_RESO_VW))
+    {
+        reso_x  = SENSOR_RESO_HW;
+        reso_y  = SENSOR_RESO_VW;
+        tile_hw = TILE_SIZE_HW_SENSOR;
+        tile_vw = TILE_SIZE_VW_SENSOR;
+    }
+
+    // the title shows the drawn resolution
+    if (degraded && (NULL != strchr(title_str, ']')))
+    {
+        int prefix_len = (int)(strchr(title_str, ']') - title_str) + 1;
+
+        snprintf(degraded_str, sizeof(degraded_str), "%.*s %3d*%-3d", prefix_len, title_str, reso_x, reso_y);
+        title_str = degraded_str;
+    }
+
+    p_tiles = p_blitter;
+#if MBED_CONF_APP_GRID_LAYER
+    if (grid_layer)
+    {
+        p_tiles = (0 == screen) ? &grid_blitter0 : &grid_blitter1;
+        p_tiles->begin_frame();
+        tile_hw = 1;
+        tile_vw = 1;
+    }
+#endif
+
+#if MBED_CONF_APP_RENDER_REFERENCE
+    bool   expand = ((SENSOR_RESO_HW != reso_x) || (SENSOR_RESO_VW != reso_y));
+    float* p_array = expand ? &array_expand[0][0] : &array_sensor[0][0];
+    int    x;
+
+    if (!grid_cached(p_frame, reso_x, reso_y, min, max))
+    {
+        for (y = 0; y < SENSOR_RESO_VW; y++)
+        {
+            for (x = 0; x < SENSOR_RESO_HW; x++)
+            {
+                array_sensor[y][x] = normalize0to1(p_raw[x + (SENSOR_RESO_HW*y)], min, max);
+            }
+        }
+        if (expand)
+        {
+            liner_interpolation(&array_sensor[0][0], &array_expand[0][0], SENSOR_RESO_HW, SENSOR_RESO_VW, reso_x, reso_y);
+        }
     }
+    begin_redraw(p_tiles, p_raw, reso_x, reso_y, tile_hw, tile_vw, min, max, style,
+                 expand ? THERMO_REDRAW_REACH_LINEAR : THERMO_REDRAW_REACH_NONE);
 
     for (y = 0; y < reso_y; y++)
     {
-        for (x = 0; x < reso_x; x++)
+        if (!redraw.row_span(y, &x0, &x1))
         {
-            color = conv_normalize_to_color(alpha, p_array[(y * reso_x)  + x]);
-            p_af->Erase(color, (tile_hw * x), (tile_vw * y), tile_hw, tile_vw);
+            continue;
         }
+        for (x = x0; x < x1; x++)
+        {
+            color_row[x] = conv_normalize_to_color(pixel_alpha, p_array[(y * reso_x)  + x]);
+        }
+        p_tiles->draw_tile_span(y, &color_row[0], reso_x, tile_hw, tile_vw, x0, x1);
     }
-    p_af->Erase(ASCII_COLOR_WHITE, 0, 0, 30, 20);
-    p_af->DrawStr(title_str, 0, 0, ASCII_COLOR_BLACK, ASCII_FONT_SIZE, 18);
+#else
+    // the kernel keeps the rows expanded in x, the palette applies the alpha per row
+    bool expanded = !grid_cached(p_frame, reso_x, reso_y, min, max);
 
-    dcache_clean(p_fbuf, sizeof(fbuf_ascii0));
-    Display.Graphics_Read_Change(DisplayBase::GRAPHICS_LAYER_3, (void *)p_fbuf);
+    palette.set_alpha(pixel_alpha);
+    if (expanded)
+    {
+        grid_on_drp = expand_on_drp(p_raw, reso_x, reso_y, min, max);
+        if (!grid_on_drp)
+        {
+            kernel.begin(p_raw, SENSOR_RESO_HW, SENSOR_RESO_VW, min, max, find_resampler(reso_x, reso_y), UPSCALE_MODE);
+        }
+    }
 
-    if (0 == screen)
+    // the DRP resize samples at the pixel centers, the cubic reach covers its footprint
     {
-        screen = 1;
+        int reach = THERMO_REDRAW_REACH_LINEAR;
+
+        if (NULL == find_resampler(reso_x, reso_y))
+        {
+            reach = THERMO_REDRAW_REACH_NONE;
+        }
+        else if (grid_on_drp || (THERMO_RESAMPLE_CUBIC == UPSCALE_MODE))
+        {
+            reach = THERMO_REDRAW_REACH_CUBIC;
+        }
+        begin_redraw(p_tiles, p_raw, reso_x, reso_y, tile_hw, tile_vw, min, max, style | (grid_on_drp ? 0x200 : 0), reach);
     }
-    else
+
+    for (y = 0; y < reso_y; y++)
     {
-        screen = 0;
+        if (!redraw.row_span(y, &x0, &x1))
+        {
+            continue;
+        }
+#if MBED_CONF_APP_DRP_THERMAL
+        if (grid_on_drp)
+        {
+            const uint8_t* p_index = &drp_grid_dst[reso_x * y];
+            int            x;
+
+            for (x = x0; x < x1; x++)
+            {
+                color_row[x] = palette.color_index(p_index[x]);
+            }
+        }
+        else
+#endif
+        {
+            kernel.color_span(y, x0, x1, &color_row[0]);
+        }
+        p_tiles->draw_tile_span(y, &color_row[0], reso_x, tile_hw, tile_vw, x0, x1);
+    }
+    if (expanded && (NULL != find_resampler(reso_x, reso_y)))
+    {
+        drp_scheduler.record_frame(thermo_cycle_read() - start, grid_on_drp);
     }
+#endif
+    redraw.end();
+    profiler.record(PROFILE_RENDER, thermo_cycle_read() - start);
+#if MBED_CONF_APP_GRID_LAYER
+    if (grid_layer)
+    {
+        {
+            ThermoScopedTimer timer(profiler, PROFILE_CLEAN);
+            p_tiles->clean_dirty(hal_cache);
+        }
+        hal_grid_display.swap_scaled(p_tiles->buffer(), reso_x, reso_y, p_tiles->stride());
+    }
+#endif
+    show_thermograph(p_af, p_blitter, title_str, TITLE_MAX_CHAR);
+    set_thermograph_alpha(alpha);
 
     return;
 }
@@ -340,56 +878,337 @@ void update_thermograph(int reso_x, int reso_y, int tile_hw, int tile_vw, uint8_
 *******************************************************************************/
 void clear_thermograph(const char* title_str)
 {
-    AsciiFont* p_af;
-    uint8_t*   p_fbuf;
+    AsciiFont*     p_af;
+    ThermoBlitter* p_blitter;
 
     if (0 == screen)
     {
         p_af = p_af0;
-        p_fbuf = &fbuf_ascii0[0];
+        p_blitter = &blitter0;
     }
     else
     {
         p_af = p_af1;
-        p_fbuf = &fbuf_ascii1[0];
+        p_blitter = &blitter1;
     }
+    p_blitter->begin_frame();
 
-    p_af->Erase(0x0000);
-    p_af->Erase(ASCII_COLOR_WHITE, 0, 0, 30, 20);
-    p_af->DrawStr(title_str, 0, 0, ASCII_COLOR_BLACK, ASCII_FONT_SIZE, 10);
-    dcache_clean(p_fbuf, sizeof(fbuf_ascii0));
-    Display.Graphics_Read_Change(DisplayBase::GRAPHICS_LAYER_3, (void *)p_fbuf);
+    p_blitter->fill(0x0000);
+#if MBED_CONF_APP_GRID_LAYER
+    if (grid_layer)
+    {
+        ThermoBlitter* p_tiles = (0 == screen) ? &grid_blitter0 : &grid_blitter1;
 
-    if (0 == screen)
+        p_tiles->begin_frame();
+        p_tiles->fill(0x0000);
+        p_tiles->clean_dirty(hal_cache);
+        hal_grid_display.swap_scaled(p_tiles->buffer(), TILE_RESO_8, TILE_RESO_8, p_tiles->stride());
+    }
+#endif
+    show_thermograph(p_af, p_blitter, title_str, 10);
+
+    return;
+}
+/*******************************************************************************
+ End of function clear_thermograph
+*******************************************************************************/
+
+/*******************************************************************************
+* Function Name: render_mode
+* Description  : Display a frame in one mode of mode_table.
+* Arguments    : p_mode  - display mode
+*                p_frame - thermal frame
+*                min     - smallest threshold temperature value
+*                max     - highest threshold temperature value
+* Return Value : none
+*******************************************************************************/
+static void render_mode(const display_mode_t* p_mode, const ThermoFrame* p_frame, int min, int max)
+{
+    char str[32];
+
+    if (0 == p_mode->reso_x)
     {
-        screen = 1;
+        clear_thermograph("off");
+        return;
     }
-    else
+    snprintf(str, sizeof(str), "PTAT[%2.1f] %3d*%-3d", p_frame->ptat/10.0, p_mode->reso_x, p_mode->reso_y);
+    update_thermograph(p_mode->reso_x, p_mode->reso_y, p_mode->tile_hw, p_mode->tile_vw, p_mode->alpha,
+                       p_frame, min, max, str);
+}
+/*******************************************************************************
+ End of function render_mode
+*******************************************************************************/
+
+/*******************************************************************************
+* Function Name: console_text
+* Description  : Print text on the console, unless it carries the binary
+*                telemetry stream ("telemetry" 1 or 2): text between the
+*                packets would corrupt it.
+* Arguments    : p_format - printf format
+*                ...      - printf arguments
+* Return Value : none
+*******************************************************************************/
+static void console_text(const char* p_format, ...)
+{
+#if MBED_CONF_APP_TELEMETRY
+    (void)p_format;
+#else
+    va_list args;
+
+    va_start(args, p_format);
+    vprintf(p_format, args);
+    va_end(args);
+#endif
+}
+/*******************************************************************************
+ End of function console_text
+*******************************************************************************/
+
+#if !MBED_CONF_APP_TELEMETRY
+/*******************************************************************************
+* Function Name: base64_put
+* Description  : Add one group of 1-3 bytes to the console line as base64.
+* Arguments    : p_writer - base64 writer
+*                p_data   - bytes of the group
+*                len      - number of bytes (1-3)
+* Return Value : none
+*******************************************************************************/
+static void base64_put(base64_writer_t* p_writer, const uint8_t* p_data, int len)
+{
+    static const char code[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    uint32_t group = ((uint32_t)p_data[0] << 16)
+                   | ((len > 1) ? ((uint32_t)p_data[1] << 8) : 0)
+                   | ((len > 2) ? (uint32_t)p_data[2] : 0);
+    char*    p_out = &p_writer->line[p_writer->line_len];
+
+    p_out[0] = code[(group >> 18) & 0x3F];
+    p_out[1] = code[(group >> 12) & 0x3F];
+    p_out[2] = (len > 1) ? code[(group >> 6) & 0x3F] : '=';
+    p_out[3] = (len > 2) ? code[group & 0x3F] : '=';
+    p_writer->line_len += 4;
+    if (p_writer->line_len >= FUSED_LINE_CHAR)
     {
-        screen = 0;
+        p_writer->line[p_writer->line_len] = '\0';
+        printf("%s\r\n", p_writer->line);
+        p_writer->line_len = 0;
+    }
+}
+/*******************************************************************************
+ End of function base64_put
+*******************************************************************************/
+
+/*******************************************************************************
+* Function Name: base64_write
+* Description  : ThermoWriteFunc of the fused export, prints the data as base64
+*                lines on the console.
+* Arguments    : p_context - base64 writer
+*                p_data    - data
+*                size      - number of bytes
+* Return Value : true
+*******************************************************************************/
+static bool base64_write(void* p_context, const void* p_data, uint32_t size)
+{
+    base64_writer_t* p_writer = (base64_writer_t*)p_context;
+    const uint8_t*   p_byte   = (const uint8_t*)p_data;
+
+    while (size > 0)
+    {
+        p_writer->carry[p_writer->carry_len++] = *p_byte++;
+        size--;
+        if (3 == p_writer->carry_len)
+        {
+            base64_put(p_writer, p_writer->carry, 3);
+            p_writer->carry_len = 0;
+        }
     }
+    return true;
+}
+/*******************************************************************************
+ End of function base64_write
+*******************************************************************************/
 
-    return;
+/*******************************************************************************
+* Function Name: export_fused
+* Description  : Start the export of the thermograph over the camera image.
+*                Fills the color grid of the registration map and asks the
+*                DRP task for a copy of the next camera image, the export
+*                task prints it. The registration map is built once.
+* Arguments    : p_frame - thermal frame
+*                min     - smallest threshold temperature value
+*                max     - highest threshold temperature value
+* Return Value : none
+*******************************************************************************/
+static void export_fused(const ThermoFrame* p_frame, int min, int max)
+{
+    int             y;
+
+    registration.build(TILE_RESO_160, TILE_RESO_120);
+
+    // color grid of the registration map, the grid cache of the display is replaced
+    grid_key.valid = false;
+#if MBED_CONF_APP_RENDER_REFERENCE
+    for (y = 0; y < SENSOR_RESO_VW; y++)
+    {
+        for (int x = 0; x < SENSOR_RESO_HW; x++)
+        {
+            array_sensor[y][x] = normalize0to1(p_frame->pixel[x + (SENSOR_RESO_HW * y)], min, max);
+        }
+    }
+    liner_interpolation(&array_sensor[0][0], &array_expand[0][0], SENSOR_RESO_HW, SENSOR_RESO_VW, TILE_RESO_160, TILE_RESO_120);
+    for (y = 0; y < TILE_RESO_120; y++)
+    {
+        for (int x = 0; x < TILE_RESO_160; x++)
+        {
+            fused_colors[(TILE_RESO_160 * y) + x] = conv_normalize_to_color(FUSED_ALPHA, array_expand[y][x]);
+        }
+    }
+#else
+    palette.set_alpha(FUSED_ALPHA);
+    kernel.begin(&p_frame->pixel[0], SENSOR_RESO_HW, SENSOR_RESO_VW, min, max, find_resampler(TILE_RESO_160, TILE_RESO_120),
+                 UPSCALE_MODE);
+    for (y = 0; y < TILE_RESO_120; y++)
+    {
+        kernel.color_row(y, &fused_colors[TILE_RESO_160 * y]);
+    }
+#endif
+
+    fused_state = FUSED_SNAPSHOT;
 }
 /*******************************************************************************
- End of function clear_thermograph
+ End of function export_fused
 *******************************************************************************/
 
-static void IntCallbackFunc_Vfield(DisplayBase::int_type_t int_type) {
-    drpTask.flags_set(DRP_FLG_CAMER_IN);
+/*******************************************************************************
+* Function Name: snapshot_fused
+* Description  : Copy the camera rows of a requested export while the ISP is
+*                idle and wake the export task. Called by the DRP task.
+* Arguments    : none
+* Return Value : none
+*******************************************************************************/
+static void snapshot_fused(void)
+{
+    int step = MBED_CONF_APP_FUSED_STEP;
+
+    if (FUSED_SNAPSHOT != fused_state)
+    {
+        return;
+    }
+
+    // the DRP writes the camera image, drop the cached lines before reading it
+    hal_cache.invalidate(fbuf_yuv, sizeof(fbuf_yuv));
+    for (int y = 0; y < (FRAME_BUFFER_HEIGHT / step); y++)
+    {
+        memcpy(&fused_yuv[FRAME_BUFFER_STRIDE_2 * y], &fbuf_yuv[FRAME_BUFFER_STRIDE_2 * (y * step)], FRAME_BUFFER_STRIDE_2);
+    }
+    fused_state = FUSED_ENCODE;
+    fusedTask.flags_set(FUSED_FLG_ENCODE);
+}
+/*******************************************************************************
+ End of function snapshot_fused
+*******************************************************************************/
+
+/*******************************************************************************
+* Function Name: fused_task
+* Description  : Print each snapshot as a base64 BMP between BEGIN/END lines
+*                on the console, below the priority of the display loop.
+* Arguments    : none
+* Return Value : none
+*******************************************************************************/
+static void fused_task(void)
+{
+    base64_writer_t writer;
+    int             step = MBED_CONF_APP_FUSED_STEP;
+
+    while (true)
+    {
+        ThisThread::flags_wait_all(FUSED_FLG_ENCODE);
+
+        // write_bmp reads row y * step at yuv_stride * y * step, the snapshot keeps only those rows
+        memset(&writer, 0, sizeof(writer));
+        printf("\x1b[2J-----BEGIN FUSED BMP %dx%d-----\r\n", fusion.out_width(step), fusion.out_height(step));
+        fusion.write_bmp(fused_yuv, FRAME_BUFFER_STRIDE_2 / step, fused_colors, step, fused_row, base64_write, &writer);
+        if (writer.carry_len > 0)
+        {
+            base64_put(&writer, writer.carry, writer.carry_len);
+        }
+        if (writer.line_len > 0)
+        {
+            writer.line[writer.line_len] = '\0';
+            printf("%s\r\n", writer.line);
+        }
+        printf("-----END FUSED BMP-----\r\n");
+        fused_state = FUSED_IDLE;
+    }
 }
+/*******************************************************************************
+ End of function fused_task
+*******************************************************************************/
+#endif
 
-static void cb_drp_finish(uint8_t id) {
-    uint32_t tile_no;
-    uint32_t set_flgs = 0;
+#if MBED_CONF_APP_TELEMETRY
+/*******************************************************************************
+* Function Name: send_telemetry
+* Description  : Queue every frame of the display sensor read since the last
+*                call as a telemetry packet, without waiting for the UART.
+*                A packet which does not fit is dropped and the next one is
+*                sent as a key frame.
+* Arguments    : none
+* Return Value : none
+*******************************************************************************/
+static void send_telemetry(void)
+{
+    ThermoFrame frame;
+    uint32_t    size;
 
-    // Change the operation state of the DRP library notified by the argument to finish
-    for (tile_no = 0; tile_no < R_DK2_TILE_NUM; tile_no++) {
-        if (drp_lib_id[tile_no] == id) {
-            set_flgs |= (1 << tile_no);
+    while (sensors.read(DISPLAY_SENSOR_ID, telemetry_cursor, frame))
+    {
+        size = telemetry_encoder.encode(frame, telemetry_packet);
+        if (!telemetry.write(telemetry_packet, size))
+        {
+            telemetry_encoder.resync();
         }
     }
-    drpTask.flags_set(set_flgs);
+}
+/*******************************************************************************
+ End of function send_telemetry
+*******************************************************************************/
+#endif
+
+#if MBED_CONF_APP_RECORD == 1
+/*******************************************************************************
+* Function Name: toggle_record
+* Description  : Start or stop recording the frames of the display sensor.
+*                Stopping writes the last chunk and closes the log, so the
+*                SD card or USB drive can be removed afterwards.
+* Arguments    : none
+* Return Value : none
+*******************************************************************************/
+static void toggle_record(void)
+{
+    if (recorder.recording())
+    {
+        recorder.stop();
+        console_text("record: %s closed\r\n", MBED_CONF_APP_RECORD_FILE);
+        return;
+    }
+    // mount the storage if it was inserted after the start
+    storage.connect();
+    if (recorder.record(MBED_CONF_APP_RECORD_FILE))
+    {
+        console_text("record: %s\r\n", MBED_CONF_APP_RECORD_FILE);
+    }
+    else
+    {
+        console_text("record: %s not opened\r\n", MBED_CONF_APP_RECORD_FILE);
+    }
+}
+/*******************************************************************************
+ End of function toggle_record
+*******************************************************************************/
+#endif
+
+static void IntCallbackFunc_Vfield(DisplayBase::int_type_t int_type) {
+    drpTask.flags_set(DRP_FLG_CAMER_IN);
 }
 
 static void Start_Video_Camera(void) {
@@ -448,6 +1267,12 @@ static void Start_Thermo_Display(void) {
         &rect
     );
     Display.Graphics_Start(DisplayBase::GRAPHICS_LAYER_3);
+#if MBED_CONF_APP_LAYER_ALPHA
+    layer_alpha = hal_display.set_layer_alpha(layer_alpha_value);
+#endif
+#if MBED_CONF_APP_GRID_LAYER
+    grid_layer = hal_grid_display.has_scaler();
+#endif
 
 }
 
@@ -462,8 +1287,6 @@ static void drp_task(void) {
 #endif
     Start_Thermo_Display();
 
-    R_DK2_Initialize();
-
     /* Load DRP Library                 */
     /*        +-----------------------+ */
     /* tile 0 |                       | */
@@ -478,10 +1301,13 @@ static void drp_task(void) {
     /*        +                       + */
     /* tile 5 |                       | */
     /*        +-----------------------+ */
-    R_DK2_Load(g_drp_lib_simple_isp_bayer2yuv_6,
-               R_DK2_TILE_0,
-               R_DK2_TILE_PATTERN_6, NULL, &cb_drp_finish, drp_lib_id);
-    R_DK2_Activate(0, 0);
+    /* A thermal job unloads it, runs    */
+    /* the resize on tile 0 and loads   */
+    /* it again before the next frame.  */
+#if MBED_CONF_APP_DRP_THERMAL
+    drp_scheduler.set_thermal(drp_resize);
+#endif
+    drp_scheduler.start();
 
     memset(&param_isp, 0, sizeof(param_isp));
     param_isp.src    = (uint32_t)fbuf_bayer;
@@ -498,28 +1324,203 @@ static void drp_task(void) {
     while (true) {
         ThisThread::flags_wait_all(DRP_FLG_CAMER_IN);
 
-        // Start DRP and wait for completion
-        R_DK2_Start(drp_lib_id[0], (void *)&param_isp, sizeof(r_drp_simple_isp_t));
-        ThisThread::flags_wait_all(DRP_FLG_TILE_ALL);
+        // Start DRP and wait for completion, then a waiting thermal job if it fits
+        ThermoScopedTimer timer(profiler, PROFILE_DRP);
+        drp_scheduler.camera_frame((void *)&param_isp, sizeof(r_drp_simple_isp_t));
+#if !MBED_CONF_APP_TELEMETRY
+        snapshot_fused();
+#endif
+    }
+}
+
+/*******************************************************************************
+* Function Name: console_command
+* Description  : Handle the console keys without waiting.
+*                's' shows/hides the stats, 'r' resets the stats,
+*                'o' shows/hides the stats overlay on the display,
+*                'f' exports the next frame over the camera image,
+*                'l' starts/stops recording the frames (mbed_app.json "record"),
+*                'a' switches the color range between fixed and auto.
+* Arguments    : none
+* Return Value : none
+*******************************************************************************/
+static void console_command(void)
+{
+    FileHandle* p_stdin = mbed_file_handle(STDIN_FILENO);
+    char c;
+
+    while ((NULL != p_stdin) && p_stdin->readable() && (1 == p_stdin->read(&c, 1)))
+    {
+        switch (c)
+        {
+            case 's':
+                stats_console = !stats_console;
+                console_text("\x1b[2J");  // Clear screen
+                break;
+            case 'r':
+                profiler.reset();
+                scheduler.reset_stats();
+                grid_hits   = 0;
+                grid_misses = 0;
+                drp_scheduler.reset_stats();
+                sensor_filter.reset_stats();
+                redraw.reset_stats();
+                auto_range.reset_stats();
+#if MBED_CONF_APP_TELEMETRY
+                telemetry.reset_stats();
+#endif
+                break;
+            case 'o':
+                stats_overlay = !stats_overlay;
+                redraw.invalidate();    // tiles under the stats are shown again
+                break;
+#if !MBED_CONF_APP_TELEMETRY
+            case 'f':   // the BMP goes to the console as text
+                fused_request = true;
+                break;
+#endif
+            case 'a':
+                range_auto = !range_auto;
+                auto_range.reset();     // starts from the next frame as it is
+                range_sequence = 0;
+                break;
+#if MBED_CONF_APP_RECORD == 1
+            case 'l':
+                toggle_record();
+                break;
+#endif
+            default:
+                break;
+        }
+    }
+}
+/*******************************************************************************
+ End of function console_command
+*******************************************************************************/
+
+/*******************************************************************************
+* Function Name: print_stats
+* Description  : Print the stage times, the sensor counters and the frame budget.
+* Arguments    : none
+* Return Value : none
+*******************************************************************************/
+static void print_stats(void)
+{
+    ThermoStageStats frame;
+    D6T_Stats d6t = d6t_sensor.stats();
+
+    profiler.print();
+    ThermoPacingStats pacing = scheduler.stats();
+
+    printf("d6t: %8lu reads, %5lu i2c errors, %5lu pec errors, %5lu retried\r\n",
+           (unsigned long)d6t.reads, (unsigned long)d6t.i2c_errors, (unsigned long)d6t.pec_errors,
+           (unsigned long)sensors.errors(DISPLAY_SENSOR_ID));
+    if (profiler.stats(PROFILE_FRAME, frame))
+    {
+        printf("budget: %7lu[us] of %5d[ms] frame period (%3lu%%)\r\n", (unsigned long)frame.recent_max_us,
+               FRAME_PERIOD, (unsigned long)(frame.recent_max_us / (FRAME_PERIOD * 10)));
+    }
+    printf("pacing: %8lu frames, %5lu overruns, %5lu skipped, jitter %3lu/%3lu[ms], degrade %d\r\n",
+           (unsigned long)pacing.frames, (unsigned long)pacing.overruns, (unsigned long)pacing.skipped,
+           (unsigned long)pacing.jitter_last_ms, (unsigned long)pacing.jitter_max_ms, pacing.degrade);
+    printf("grid: %8lu expanded, %5lu reused\r\n", (unsigned long)grid_misses, (unsigned long)grid_hits);
+    const ThermoRedrawStats& region = redraw.stats();
+
+    printf("redraw: %6lu frames, %5lu full, %3lu%% of the tiles redrawn, last %5lu/%5lu\r\n",
+           (unsigned long)region.frames, (unsigned long)region.full,
+           (unsigned long)((region.total != 0) ? ((region.points * 100) / region.total) : 0),
+           (unsigned long)region.last_points, (unsigned long)region.last_total);
+    ThermoAutoRangeStats range = auto_range.stats();
+
+    printf("range: %s, %6lu frames, %5lu changes, %5.1f - %5.1f[degC]\r\n", range_auto ? "auto " : "fixed",
+           (unsigned long)range.frames, (unsigned long)range.changes, auto_range.min() / 10.0, auto_range.max() / 10.0);
+    ThermoFilterStats filter = sensor_filter.stats();
+
+    printf("filter: %6lu frames, %3lu%% of the pixels changed, last %4lu/%4d\r\n", (unsigned long)filter.frames,
+           (unsigned long)((filter.frames != 0) ? ((filter.changed * 100ull) / ((uint64_t)filter.frames * THERMO_FRAME_PIXEL)) : 0),
+           (unsigned long)filter.last_changed, THERMO_FRAME_PIXEL);
+    if (drp_scheduler.has_thermal())
+    {
+        ThermoDrpStats drp = drp_scheduler.stats();
+
+        printf("drp: %6lu jobs, %5lu rejected, %5lu failed, isp %5lu switch %5lu job %5lu wait %5lu[us], render %5lu/%5lu saved %5lu[us]\r\n",
+               (unsigned long)drp.jobs, (unsigned long)(drp.rejected + drp.timeouts + drp.slower), (unsigned long)drp.failed,
+               (unsigned long)drp.isp_us, (unsigned long)drp.switch_us, (unsigned long)drp.job_us, (unsigned long)drp.wait_us,
+               (unsigned long)drp.cpu_us, (unsigned long)drp.drp_cpu_us, (unsigned long)drp.saved_us);
     }
+#if MBED_CONF_APP_TELEMETRY
+    ThermoTelemetryStats tm = telemetry.stats();
+
+    printf("telemetry: %6lu packets, %5lu dropped, %8lu[byte], buffer %4lu/%4d[byte]\r\n",
+           (unsigned long)tm.packets, (unsigned long)tm.dropped, (unsigned long)tm.bytes,
+           (unsigned long)tm.max_used, TELEMETRY_BUFFER_SIZE);
+#endif
+#if MBED_CONF_APP_RECORD == 1
+    ThermoRecorderStats rec = recorder.stats();
+
+    printf("record: %3s %6lu frames, %5lu lost, %6lu chunks, %5lu write errors\r\n", recorder.recording() ? "on" : "off",
+           (unsigned long)rec.frames, (unsigned long)rec.lost, (unsigned long)rec.chunks, (unsigned long)rec.errors);
+#elif MBED_CONF_APP_RECORD == 2
+    printf("replay: %s%s, %5lu bad chunks\r\n", MBED_CONF_APP_RECORD_FILE,
+           sensors.ready(DISPLAY_SENSOR_ID) ? "" : " not opened", (unsigned long)replay_log.bad_chunks());
+#endif
 }
+/*******************************************************************************
+ End of function print_stats
+*******************************************************************************/
 
 int main(void) {
-    int16_t pdta;
-    int16_t buf[16];
+    ThermoFrame frame;
+#if MBED_CONF_APP_DISPLAY_MODE < 0
     int16_t phase = 0;
     int16_t sub_phase = 0;
-    char    str[32];
+#endif
+
+    thermo_cycle_init();
+    profiler.set_stage(PROFILE_FRAME, "frame");
+    profiler.set_stage(PROFILE_RENDER, "render");
+    profiler.set_stage(PROFILE_CLEAN, "clean");
+    profiler.set_stage(PROFILE_CONSOLE, "console");
+    profiler.set_stage(PROFILE_SENSOR, "sensor");
+    profiler.set_stage(PROFILE_DRP, "drp");
 
     // Start DRP task
     drpTask.start(callback(drp_task));
+#if !MBED_CONF_APP_TELEMETRY
+    fusedTask.start(callback(fused_task));
+#endif
 
-    printf("\x1b[2J");  // Clear screen
-
-    // setup sensors
-    d6t_44l.setup();
+    console_text("\x1b[2J");  // Clear screen
 
-    ThisThread::sleep_for(150);
+    // Start sensor acquisition (the bus threads set up the sensors)
+#if MBED_CONF_APP_RECORD == 2
+    // recorded frames instead of the sensor, the log has to be there first
+    storage.wait_connect();
+    sensor_bus.add(replay_device, DISPLAY_SENSOR_ID);
+#else
+    sensor_bus.add(d6t_device, DISPLAY_SENSOR_ID);
+#endif
+    sensor_bus.set_filter(DISPLAY_SENSOR_ID, &sensor_filter);
+    sensor_bus.set_percentiles(MBED_CONF_APP_AUTO_RANGE_PERCENTILE, 100 - MBED_CONF_APP_AUTO_RANGE_PERCENTILE);
+    sensor_bus.set_profiler(&profiler, PROFILE_SENSOR);
+    sensors.add(sensor_bus);
+    sensors.start();
+#if MBED_CONF_APP_RECORD == 2
+    // the acquisition thread opens the log, and tries again every period when it fails
+    uint64_t replay_start = Kernel::get_ms_count();
+    while (!sensors.ready(DISPLAY_SENSOR_ID) && ((Kernel::get_ms_count() - replay_start) < REPLAY_OPEN_WAIT)) {
+        ThisThread::sleep_for(10);
+    }
+    if (!sensors.ready(DISPLAY_SENSOR_ID)) {
+        console_text("replay: %s not opened\r\n", MBED_CONF_APP_RECORD_FILE);
+    }
+#endif
+#if MBED_CONF_APP_TELEMETRY
+    telemetry.start();
+#endif
+#if MBED_CONF_APP_RECORD == 1
+    recorder.start();
+#endif
 
     AsciiFont ascii_font0(fbuf_ascii0, VIDEO_PIXEL_HW, VIDEO_PIXEL_VW, ASCII_BUFFER_STRIDE, ASCII_BUFFER_BYTE_PER_PIXEL);
     AsciiFont ascii_font1(fbuf_ascii1, VIDEO_PIXEL_HW, VIDEO_PIXEL_VW, ASCII_BUFFER_STRIDE, ASCII_BUFFER_BYTE_PER_PIXEL);
@@ -527,198 +1528,107 @@ int main(void) {
     p_af0 = &ascii_font0;
     p_af1 = &ascii_font1;
 
-    while (1) {
-        int x, y;
+    // tiles under the title are redrawn every frame
+    blitter0.set_overlay(0, 0, TITLE_AREA_HW, TITLE_AREA_VW);
+    blitter1.set_overlay(0, 0, TITLE_AREA_HW, TITLE_AREA_VW);
+    blitter0.set_overlay(STATS_AREA_X, STATS_AREA_Y, STATS_AREA_HW, STATS_AREA_VW, 1);
+    blitter1.set_overlay(STATS_AREA_X, STATS_AREA_Y, STATS_AREA_HW, STATS_AREA_VW, 1);
 
-        printf("\x1b[%d;%dH", 0, 0);  // Move cursor (y , x)
+#if !MBED_CONF_APP_RENDER_REFERENCE
+    palette.setup(TILE_ALPHA_MAX, TILE_TEMP_MARGIN_UNDER + TILE_TEMP_MARGIN_UPPER);
+#endif
+    registration.set_transform(registration_h);
 
-        while (d6t_44l.read(&pdta, &buf[0]) == false) {
+    scheduler.start();
+    while (1) {
+        int min, max;
+        uint32_t frame_start;
+        uint32_t console_start;
+
+        // newest frame, only waits until the first reading is done
+        while (sensors.latest(DISPLAY_SENSOR_ID, frame) == false) {
             ThisThread::sleep_for(10);
         }
-
-        printf("PTAT: %6.1f[degC]\r\n", pdta / 10.0);
-        for (int i = 0; i < 16; i++) {
-            printf("%4.1f, ", buf[i] / 10.0);
-
-            if ((i % 4) == 4 - 1) {
-                printf("\r\n");
+        frame_start = thermo_cycle_read();
+
+        console_command();
+        console_start = thermo_cycle_read();
+#if MBED_CONF_APP_TELEMETRY
+        send_telemetry();
+#else
+        // the export task has the console until the BMP is printed
+        if (FUSED_IDLE == fused_state) {
+            printf("\x1b[%d;%dH", 0, 0);  // Move cursor (y , x)
+            printf("PTAT: %6.1f[degC]  sensor %u frame %6lu %10lu[ms]\r\n", frame.ptat / 10.0,
+                   (unsigned)frame.sensor_id, (unsigned long)frame.sequence, (unsigned long)frame.timestamp_ms);
+            for (int i = 0; i < THERMO_FRAME_PIXEL; i++) {
+                printf("%4.1f, ", frame.pixel[i] / 10.0);
+
+                if ((i % SENSOR_RESO_HW) == SENSOR_RESO_HW - 1) {
+                    printf("\r\n");
+                }
+            }
+            printf("min %5.1f max %5.1f mean %5.1f hot spot %2u,%-2u  %2d-%-2d%%: %5.1f - %5.1f[degC]\r\n",
+                   frame.stats.min / 10.0, frame.stats.max / 10.0, frame.stats.mean / 10.0,
+                   (unsigned)frame.stats.hot_x, (unsigned)frame.stats.hot_y,
+                   MBED_CONF_APP_AUTO_RANGE_PERCENTILE, 100 - MBED_CONF_APP_AUTO_RANGE_PERCENTILE,
+                   frame.stats.low / 10.0, frame.stats.high / 10.0);
+            printf("tiles: %5lu drawn %5lu skipped, cache clean: %7lu[byte], redrawn %3lu%%\r\n",
+                   (unsigned long)frame_stats.tiles_drawn, (unsigned long)frame_stats.tiles_skipped,
+                   (unsigned long)frame_stats.bytes_cleaned,
+                   (unsigned long)((redraw.stats().last_total != 0) ? ((redraw.stats().last_points * 100) / redraw.stats().last_total) : 0));
+            if (stats_console) {
+                print_stats();
             }
         }
+#endif
+        profiler.record(PROFILE_CONSOLE, thermo_cycle_read() - console_start);
 
-        for (y = 0; y < TILE_RESO_4; y++)
+        if (range_auto)
         {
-            for (x = 0; x < TILE_RESO_4; x++)
+            // once per sensor frame, the display may show a frame again
+            if (frame.sequence != range_sequence)
             {
-                array4x4[y][x] = normalize0to1(buf[x + (TILE_RESO_4*y)], pdta - TILE_TEMP_MARGIN_UNDER,  pdta + TILE_TEMP_MARGIN_UPPER);
+                auto_range.update(frame.stats);
+                range_sequence = frame.sequence;
             }
+            min = auto_range.min();
+            max = auto_range.max();
         }
+        else
+        {
+            min = frame.ptat - TILE_TEMP_MARGIN_UNDER;
+            max = frame.ptat + TILE_TEMP_MARGIN_UPPER;
+        }
+#if !MBED_CONF_APP_RENDER_REFERENCE
+        palette.set_raw_range(max - min);   // only rebuilt when the span changes
+#endif
 
-        switch (phase)
+#if MBED_CONF_APP_DISPLAY_MODE >= 0
+        render_mode(&mode_table[MBED_CONF_APP_DISPLAY_MODE], &frame, min, max);
+#else
+        render_mode(&mode_table[phase], &frame, min, max);
+        sub_phase++;
+        if (sub_phase >= mode_table[phase].frames)
         {
-            case 0:
-                sprintf( str, "PTAT[%2.1f]   4*4  " , pdta/10.0 );
-                update_thermograph(TILE_RESO_4, TILE_RESO_4, TILE_SIZE_HW_4x4, TILE_SIZE_VW_4x4, TILE_ALPHA_MAX, &array4x4[0][0], str);
-                sub_phase++;
-                if (sub_phase >= SUB_PHASE_DEMO1)
-                {
-                    sub_phase = 0;
-                    phase++;
-                }
-                break;
-            case 1:
-                sprintf( str, "PTAT[%2.1f]   8*8  " , pdta/10.0 );
-                liner_interpolation(&array4x4[0][0], &array8x8[0][0], TILE_RESO_4, TILE_RESO_4, TILE_RESO_8, TILE_RESO_8);
-                update_thermograph(TILE_RESO_8, TILE_RESO_8, TILE_SIZE_HW_8x8, TILE_SIZE_VW_8x8, TILE_ALPHA_MAX, &array8x8[0][0], str);
-                sub_phase++;
-                if (sub_phase >= SUB_PHASE_MAX)
-                {
-                    sub_phase = 0;
-                    phase++;
-                }
-                break;
-            case 2:
-                sprintf( str, "PTAT[%2.1f]  16*16 " , pdta/10.0 );
-                liner_interpolation(&array4x4[0][0], &array16x16[0][0], TILE_RESO_4, TILE_RESO_4, TILE_RESO_16, TILE_RESO_16);
-                update_thermograph(TILE_RESO_16, TILE_RESO_16, TILE_SIZE_HW_16x16, TILE_SIZE_VW_16x16, TILE_ALPHA_MAX, &array16x16[0][0], str);
-                sub_phase++;
-                if (sub_phase >= SUB_PHASE_MAX)
-                {
-                    sub_phase = 0;
-                    phase++;
-                }
-                break;
-            case 3:
-                sprintf( str, "PTAT[%2.1f]  32*32 " , pdta/10.0 );
-                liner_interpolation(&array4x4[0][0], &array32x32[0][0], TILE_RESO_4, TILE_RESO_4, TILE_RESO_32, TILE_RESO_32);
-                update_thermograph(TILE_RESO_32, TILE_RESO_32, TILE_SIZE_HW_32x32, TILE_SIZE_VW_32x32, TILE_ALPHA_MAX, &array32x32[0][0], str);
-                sub_phase++;
-                if (sub_phase >= SUB_PHASE_MAX)
-                {
-                    sub_phase = 0;
-                    phase++;
-                }
-                break;
-            case 4:
-                sprintf( str, "PTAT[%2.1f]  64*60 " , pdta/10.0 );
-                liner_interpolation(&array4x4[0][0], &array64x60[0][0], TILE_RESO_4, TILE_RESO_4, TILE_RESO_64, TILE_RESO_60);
-                update_thermograph(TILE_RESO_64, TILE_RESO_60, TILE_SIZE_HW_64x60, TILE_SIZE_VW_64x60, TILE_ALPHA_MAX, &array64x60[0][0], str);
-                sub_phase++;
-                if (sub_phase >= SUB_PHASE_MAX)
-                {
-                    sub_phase = 0;
-                    phase++;
-                }
-                break;
-            case 5:
-                sprintf( str, "PTAT[%2.1f] 160*120" , pdta/10.0 );
-                liner_interpolation(&array4x4[0][0], &array160x120[0][0], TILE_RESO_4, TILE_RESO_4, TILE_RESO_160, TILE_RESO_120);
-                update_thermograph(TILE_RESO_160, TILE_RESO_120, TILE_SIZE_HW_160x120, TILE_SIZE_VW_160x120, TILE_ALPHA_MAX, &array160x120[0][0], str);
-                sub_phase++;
-                if (sub_phase >= SUB_PHASE_DEMO2)
-                {
-                    sub_phase = 0;
-                    phase++;
-                }
-                break;
-            case 6:
-                sprintf( str, "PTAT[%2.1f] 160*120" , pdta/10.0 );
-                liner_interpolation(&array4x4[0][0], &array160x120[0][0], TILE_RESO_4, TILE_RESO_4, TILE_RESO_160, TILE_RESO_120);
-                update_thermograph(TILE_RESO_160, TILE_RESO_120, TILE_SIZE_HW_160x120, TILE_SIZE_VW_160x120, TILE_ALPHA_SWITCH2, &array160x120[0][0], str);
-                sub_phase++;
-                if (sub_phase >= SUB_PHASE_MAX)
-                {
-                    sub_phase = 0;
-                    phase++;
-                }
-                break;
-            case 7:
-                sprintf( str, "PTAT[%2.1f] 160*120" , pdta/10.0 );
-                liner_interpolation(&array4x4[0][0], &array160x120[0][0], TILE_RESO_4, TILE_RESO_4, TILE_RESO_160, TILE_RESO_120);
-                update_thermograph(TILE_RESO_160, TILE_RESO_120, TILE_SIZE_HW_160x120, TILE_SIZE_VW_160x120, TILE_ALPHA_SWITCH1, &array160x120[0][0], str);
-                sub_phase++;
-                if (sub_phase >= SUB_PHASE_MAX)
-                {
-                    sub_phase = 0;
-                    phase++;
-                }
-                break;
-            case 8:
-                sprintf( str, "PTAT[%2.1f] 160*120" , pdta/10.0 );
-                liner_interpolation(&array4x4[0][0], &array160x120[0][0], TILE_RESO_4, TILE_RESO_4, TILE_RESO_160, TILE_RESO_120);
-                update_thermograph(TILE_RESO_160, TILE_RESO_120, TILE_SIZE_HW_160x120, TILE_SIZE_VW_160x120, TILE_ALPHA_DEFAULT, &array160x120[0][0], str);
-                sub_phase++;
-                if (sub_phase >= SUB_PHASE_MAX)
-                {
-                    sub_phase = 0;
-                    phase++;
-                }
-                break;
-            case 9:
-                sprintf( str, "PTAT[%2.1f]  64*60 " , pdta/10.0 );
-                liner_interpolation(&array4x4[0][0], &array64x60[0][0], TILE_RESO_4, TILE_RESO_4, TILE_RESO_64, TILE_RESO_60);
-                update_thermograph(TILE_RESO_64, TILE_RESO_60, TILE_SIZE_HW_64x60, TILE_SIZE_VW_64x60, TILE_ALPHA_DEFAULT, &array64x60[0][0], str);
-                sub_phase++;
-                if (sub_phase >= SUB_PHASE_MAX)
-                {
-                    sub_phase = 0;
-                    phase++;
-                }
-                break;
-            case 10:
-                sprintf( str, "PTAT[%2.1f]  32*32 " , pdta/10.0 );
-                liner_interpolation(&array4x4[0][0], &array32x32[0][0], TILE_RESO_4, TILE_RESO_4, TILE_RESO_32, TILE_RESO_32);
-                update_thermograph(TILE_RESO_32, TILE_RESO_32, TILE_SIZE_HW_32x32, TILE_SIZE_VW_32x32, TILE_ALPHA_DEFAULT, &array32x32[0][0], str);
-                sub_phase++;
-                if (sub_phase >= SUB_PHASE_MAX)
-                {
-                    sub_phase = 0;
-                    phase++;
-                }
-                break;
-            case 11:
-                sprintf( str, "PTAT[%2.1f]  16*16 " , pdta/10.0 );
-                liner_interpolation(&array4x4[0][0], &array16x16[0][0], TILE_RESO_4, TILE_RESO_4, TILE_RESO_16, TILE_RESO_16);
-                update_thermograph(TILE_RESO_16, TILE_RESO_16, TILE_SIZE_HW_16x16, TILE_SIZE_VW_16x16, TILE_ALPHA_DEFAULT, &array16x16[0][0], str);
-                sub_phase++;
-                if (sub_phase >= SUB_PHASE_MAX)
-                {
-                    sub_phase = 0;
-                    phase++;
-                }
-                break;
-            case 12:
-                sprintf( str, "PTAT[%2.1f]   8*8  " , pdta/10.0 );
-                liner_interpolation(&array4x4[0][0], &array8x8[0][0], TILE_RESO_4, TILE_RESO_4, TILE_RESO_8, TILE_RESO_8);
-                update_thermograph(TILE_RESO_8, TILE_RESO_8, TILE_SIZE_HW_8x8, TILE_SIZE_VW_8x8, TILE_ALPHA_DEFAULT, &array8x8[0][0], str);
-                sub_phase++;
-                if (sub_phase >= SUB_PHASE_MAX)
-                {
-                    sub_phase = 0;
-                    phase++;
-                }
-                break;
-            case 13:
-                sprintf( str, "PTAT[%2.1f]   4*4  " , pdta/10.0 );
-                update_thermograph(TILE_RESO_4, TILE_RESO_4, TILE_SIZE_HW_4x4, TILE_SIZE_VW_4x4, TILE_ALPHA_DEFAULT, &array4x4[0][0], str);
-                sub_phase++;
-                if (sub_phase >= SUB_PHASE_DEMO1)
-                {
-                    sub_phase = 0;
-                    phase++;
-                }
-                break;
-            default:
-                clear_thermograph("off");
-                sub_phase++;
-                if (sub_phase >= SUB_PHASE_MAX)
-                {
-                    sub_phase = 0;
-                    phase = 0;
-                }
-                break;
+            sub_phase = 0;
+            phase++;
+            if (phase >= DISPLAY_MODE_NUM)
+            {
+                phase = 0;
+            }
+        }
+#endif
+#if !MBED_CONF_APP_TELEMETRY
+        if (fused_request && (FUSED_IDLE == fused_state))
+        {
+            fused_request = false;
+            export_fused(&frame, min, max);
         }
+#endif
 
-        ThisThread::sleep_for(PHASE_DELAY);
+        profiler.record(PROFILE_FRAME, thermo_cycle_read() - frame_start);
+        scheduler.wait_next();
     }
 }
 
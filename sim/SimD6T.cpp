@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "D6T_Crc8.h"
+#include "SimD6T.h"
+
+static constexpr D6T_Crc8Table crc8_table{};
+
+SimD6T::SimD6T(SimScene& scene, int addr) :
+    mScene(scene), mAddr(addr), mCmd(0), mPecErrorInterval(0), mFrames(0)
+{
+}
+
+int SimD6T::write(const uint8_t* p_data, int len)
+{
+    if (len >= 1) {
+        mCmd = p_data[0];
+    }
+    return 0;
+}
+
+int SimD6T::read(uint8_t* p_data, int len)
+{
+    int16_t ptat;
+    uint8_t crc;
+    int i;
+
+    if ((mCmd != ThermoSensorModel::CMD) || (len > ThermoSensorModel::N_READ)) {
+        return -1;
+    }
+
+    mScene.next(&ptat, mPixel, ThermoSensorModel::ROWS, ThermoSensorModel::COLS);
+    mData[0] = (uint8_t)ptat;
+    mData[1] = (uint8_t)((uint16_t)ptat >> 8);
+    for (i = 0; i < ThermoSensorModel::PIXEL; i++) {
+        mData[2 + (i * 2)] = (uint8_t)mPixel[i];
+        mData[3 + (i * 2)] = (uint8_t)((uint16_t)mPixel[i] >> 8);
+    }
+
+    // PEC over the write address, command, read address and the data
+    crc = crc8_table.crc[(uint8_t)mAddr];
+    crc = crc8_table.crc[mCmd ^ crc];
+    crc = crc8_table.crc[(uint8_t)(mAddr | 1) ^ crc];
+    for (i = 0; i < (ThermoSensorModel::N_READ - 1); i++) {
+        crc = crc8_table.crc[mData[i] ^ crc];
+    }
+    mFrames++;
+    if ((mPecErrorInterval != 0) && ((mFrames % mPecErrorInterval) == 0)) {
+        crc ^= 0xFF;
+    }
+    mData[ThermoSensorModel::N_READ - 1] = crc;
+
+    memcpy(p_data, mData, len);
+    return 0;
+}
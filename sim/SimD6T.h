@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SIM_D6T_H
+#define SIM_D6T_H
+
+#include "D6T_44L_06.h"
+#include "ThermoFrame.h"
+#include "SimI2cBus.h"
+#include "SimScene.h"
+
+/** Simulated D6T sensor of the frame model (ThermoSensorModel)
+ *
+ *  Answers the read command with the next frame of a scene, little endian
+ *  with the PEC byte, as the real sensor does.
+ */
+class SimD6T : public SimI2cSlave
+{
+public:
+    /** Create a sensor
+     *
+     *  @param scene scene to read (must outlive the sensor)
+     *  @param addr  8bit I2C address
+     */
+    SimD6T(SimScene& scene, int addr = D6T_ADDR);
+
+    /** Send a wrong PEC every n-th frame (0: never) */
+    void set_pec_error_interval(uint32_t interval) { mPecErrorInterval = interval; }
+
+    /** Number of frames sent */
+    uint32_t frames(void) const { return mFrames; }
+
+    virtual int write(const uint8_t* p_data, int len);
+    virtual int read(uint8_t* p_data, int len);
+
+private:
+    SimScene& mScene;
+    int mAddr;
+    uint8_t mCmd;
+    uint32_t mPecErrorInterval;
+    uint32_t mFrames;
+    int16_t mPixel[ThermoSensorModel::PIXEL];
+    uint8_t mData[ThermoSensorModel::N_READ];
+};
+
+#endif
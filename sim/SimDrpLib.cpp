@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "SimDrpLib.h"
+
+const uint8_t sim_drp_lib_isp[1] = { 0 };
+const uint8_t sim_drp_lib_resize[1] = { 0 };
+
+/* source sample on the left and 8-bit weight of the right one */
+static void resize_tap(int pos, int in, int out, int* p_index, int* p_weight)
+{
+    int seg = 1;
+
+    *p_index = 0;
+    *p_weight = 0;
+    if ((in < 2) || (out < 2)) {
+        return;
+    }
+    while ((seg < (in - 1)) && (((out - 1) * seg / (in - 1)) < pos)) {
+        seg++;
+    }
+    int start = (out - 1) * (seg - 1) / (in - 1);
+    int goal  = (out - 1) * (seg    ) / (in - 1);
+
+    *p_index = seg - 1;
+    if (goal > start) {
+        *p_weight = ((pos - start) * 256 + ((goal - start) / 2)) / (goal - start);
+    }
+}
+
+void sim_drp_isp(void* p_param, uint32_t size)
+{
+}
+
+void sim_drp_resize(void* p_param, uint32_t size)
+{
+    const SimDrpResizeParam* p = (const SimDrpResizeParam*)p_param;
+    int x;
+    int y;
+
+    if (size != sizeof(SimDrpResizeParam)) {
+        return;
+    }
+    for (y = 0; y < p->dst_height; y++) {
+        int iy;
+        int wy;
+
+        resize_tap(y, p->src_height, p->dst_height, &iy, &wy);
+        const uint8_t* p_top    = &p->p_src[p->src_width * iy];
+        const uint8_t* p_bottom = (wy != 0) ? (p_top + p->src_width) : p_top;
+
+        for (x = 0; x < p->dst_width; x++) {
+            int ix;
+            int wx;
+
+            resize_tap(x, p->src_width, p->dst_width, &ix, &wx);
+            int ix1 = (wx != 0) ? (ix + 1) : ix;
+            int top    = (p_top[ix] * (256 - wx)) + (p_top[ix1] * wx);
+            int bottom = (p_bottom[ix] * (256 - wx)) + (p_bottom[ix1] * wx);
+
+            p->p_dst[(p->dst_width * y) + x] = (uint8_t)(((top * (256 - wy)) + (bottom * wy) + (1 << 15)) >> 16);
+        }
+    }
+}
@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SIM_DRP_LIB_H
+#define SIM_DRP_LIB_H
+
+#include <stdint.h>
+
+/* Configuration data standing for the DRP libraries (only the address is used) */
+extern const uint8_t sim_drp_lib_isp[];
+extern const uint8_t sim_drp_lib_resize[];
+
+/** Parameters of the resize library (r_drp_resize_bilinear_t with host pointers) */
+struct SimDrpResizeParam {
+    const uint8_t* p_src;
+    uint8_t* p_dst;
+    uint16_t src_width;
+    uint16_t src_height;
+    uint16_t dst_width;
+    uint16_t dst_height;
+};
+
+/** Camera ISP of the simulator (the frame is not processed) */
+void sim_drp_isp(void* p_param, uint32_t size);
+
+/** Host model of the bilinear resize of an 8-bit grid
+ *
+ *  Same knot positions as liner_interpolation(), 8-bit weights.
+ */
+void sim_drp_resize(void* p_param, uint32_t size);
+
+#endif
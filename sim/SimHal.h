@@ -0,0 +1,331 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SIM_HAL_H
+#define SIM_HAL_H
+
+#include <atomic>
+#include <chrono>
+#include "mbed.h"
+#include "ThermoHalCache.h"
+#include "ThermoHalDisplay.h"
+#include "ThermoHalDrp.h"
+#include "ThermoHalSerial.h"
+
+/** ThermoHalDisplay of the host simulator: remembers the shown buffer and the layer alpha */
+class SimDisplay : public ThermoHalDisplay
+{
+public:
+    /** Create a display
+     *
+     *  @param width  layer width [pixel]
+     *  @param height layer height [pixel]
+     *  @param scaler true: scale smaller buffers up to the layer (swap_scaled)
+     */
+    SimDisplay(int width = 640, int height = 480, bool scaler = false) :
+        mBuffer(NULL), mBufWidth(width), mBufHeight(height), mBufStride(width * 2), mWidth(width), mHeight(height),
+        mScaler(scaler), mSwaps(0), mLayerAlpha(0xFF), mAlphaWrites(0) {}
+
+    virtual void swap(const void* p_buf)
+    {
+        mBuffer = p_buf;
+        mBufWidth = mWidth;
+        mBufHeight = mHeight;
+        mBufStride = mWidth * 2;
+        mSwaps++;
+    }
+
+    virtual bool set_layer_alpha(uint8_t alpha)
+    {
+        mLayerAlpha = alpha;
+        mAlphaWrites++;
+        return true;
+    }
+
+    virtual bool has_scaler(void) const
+    {
+        return mScaler;
+    }
+
+    virtual void swap_scaled(const void* p_buf, int width, int height, int stride)
+    {
+        mBuffer = p_buf;
+        mBufWidth = width;
+        mBufHeight = height;
+        mBufStride = stride;
+        mSwaps++;
+    }
+
+    /** Shown alpha (0x00 - 0xFF) of an ARGB4444 pixel, as the VDC blends it */
+    uint8_t blend_alpha(uint16_t pixel) const
+    {
+        return (uint8_t)((thermo_layer_alpha((pixel >> 4) & 0x0F) * mLayerAlpha) / 0xFF);
+    }
+
+    /** Shown ARGB4444 pixel at a layer position (nearest buffer pixel of a scaled buffer) */
+    uint16_t pixel(int x, int y) const
+    {
+        const uint8_t* p_row = (const uint8_t*)mBuffer + (mBufStride * ((y * mBufHeight) / mHeight));
+
+        return ((const uint16_t*)p_row)[(x * mBufWidth) / mWidth];
+    }
+
+    const void* buffer(void) const { return mBuffer; }
+    int buffer_width(void) const { return mBufWidth; }
+    int buffer_height(void) const { return mBufHeight; }
+    uint32_t swaps(void) const { return mSwaps; }
+    uint8_t layer_alpha(void) const { return mLayerAlpha; }
+    uint32_t alpha_writes(void) const { return mAlphaWrites; }
+
+private:
+    const void* mBuffer;
+    int mBufWidth;
+    int mBufHeight;
+    int mBufStride;
+    int mWidth;
+    int mHeight;
+    bool mScaler;
+    uint32_t mSwaps;
+    uint8_t mLayerAlpha;
+    uint32_t mAlphaWrites;
+};
+
+/** ThermoHalCache of the host simulator: counts the cleaned bytes */
+class SimCache : public ThermoHalCache
+{
+public:
+    SimCache() : mCalls(0), mBytes(0) {}
+
+    virtual void clean(void* p_buf, uint32_t size)
+    {
+        mCalls++;
+        mBytes += size;
+    }
+
+    virtual void invalidate(void* p_buf, uint32_t size)
+    {
+        // the host has no bus masters
+    }
+
+    uint32_t calls(void) const { return mCalls; }
+    uint64_t bytes(void) const { return mBytes; }
+
+private:
+    uint32_t mCalls;
+    uint64_t mBytes;
+};
+
+/** ThermoHalSerial of the host simulator: writes to a file at the pace of a UART
+ *
+ *  A write takes at most SIM_SERIAL_CHUNK bytes (the transmit buffer of the
+ *  UART driver) and 10 bit times per byte.
+ */
+class SimSerial : public ThermoHalSerial
+{
+public:
+    /** Create a port
+     *
+     *  @param p_file output (NULL: writes fail)
+     *  @param baud   bit rate, 0 writes at once
+     */
+    SimSerial(FILE* p_file = NULL, int baud = 115200) : mFile(p_file), mBaud(baud), mBytes(0) {}
+
+    void open(FILE* p_file, int baud)
+    {
+        mFile = p_file;
+        mBaud = baud;
+    }
+
+    virtual int write(const void* p_data, uint32_t size)
+    {
+        if (mFile == NULL) {
+            return -1;
+        }
+        if (size > SIM_SERIAL_CHUNK) {
+            size = SIM_SERIAL_CHUNK;
+        }
+        if (fwrite(p_data, 1, size, mFile) != size) {
+            return -1;
+        }
+        if (mBaud > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds((size * 10 * 1000000ULL) / mBaud));
+        }
+        mBytes += size;
+        return (int)size;
+    }
+
+    uint64_t bytes(void) const { return mBytes; }
+
+private:
+    enum { SIM_SERIAL_CHUNK = 256 };
+
+    FILE* mFile;
+    int mBaud;
+    std::atomic<uint64_t> mBytes;
+};
+
+/** ThermoHalDrp of the host simulator
+ *
+ *  A library is a host function registered for its configuration data,
+ *  run() calls it after the latency of the library. The tiles are tracked
+ *  as on the DRP: a library only loads on free tiles and only runs while
+ *  it is loaded. Each bit of top_tiles places one instance.
+ */
+class SimDrp : public ThermoHalDrp
+{
+public:
+    /** Create a DRP
+     *
+     *  @param load_ms time of loading a library
+     */
+    SimDrp(uint32_t load_ms = 0) : mLoadMs(load_ms), mLibNum(0), mNextId(1), mRuns(0), mLoads(0)
+    {
+        memset(mTileLib, 0, sizeof(mTileLib));
+        memset(mTileId, 0, sizeof(mTileId));
+    }
+
+    /** Register the host function of a library
+     *
+     *  @param p_config   configuration data the library is loaded with
+     *  @param tiles      tiles of one instance
+     *  @param latency_ms run time of the library
+     *  @param func       host function, called with the parameter structure of run()
+     */
+    bool add_library(const uint8_t* p_config, int tiles, uint32_t latency_ms, Callback<void(void*, uint32_t)> func)
+    {
+        if (mLibNum >= SIM_DRP_MAX_LIB) {
+            return false;
+        }
+        mLib[mLibNum].p_config = p_config;
+        mLib[mLibNum].tiles = tiles;
+        mLib[mLibNum].latency_ms = latency_ms;
+        mLib[mLibNum].func = func;
+        mLibNum++;
+        return true;
+    }
+
+    uint32_t runs(void) const { return mRuns; }
+    uint32_t loads(void) const { return mLoads; }
+
+    void set_load_ms(uint32_t load_ms) { mLoadMs = load_ms; }
+
+    virtual bool initialize(void) { return true; }
+
+    virtual bool load(const uint8_t* p_config, uint8_t top_tiles, uint32_t pattern, uint8_t* p_id)
+    {
+        int lib;
+        int tile;
+        int i;
+
+        for (lib = 0; lib < mLibNum; lib++) {
+            if (mLib[lib].p_config == p_config) {
+                break;
+            }
+        }
+        if (lib >= mLibNum) {
+            return false;
+        }
+        for (tile = 0; tile < SIM_DRP_TILE_NUM; tile++) {
+            if ((top_tiles & (1 << tile)) == 0) {
+                continue;
+            }
+            if ((tile + mLib[lib].tiles) > SIM_DRP_TILE_NUM) {
+                return false;
+            }
+            for (i = tile; i < (tile + mLib[lib].tiles); i++) {
+                if (mTileId[i] != 0) {
+                    return false;
+                }
+            }
+        }
+        for (tile = 0; tile < SIM_DRP_TILE_NUM; tile++) {
+            if ((top_tiles & (1 << tile)) == 0) {
+                continue;
+            }
+            for (i = tile; i < (tile + mLib[lib].tiles); i++) {
+                mTileId[i] = mNextId;
+                mTileLib[i] = lib;
+            }
+            mNextId = (mNextId == 0xFF) ? 1 : (mNextId + 1);
+        }
+        if (p_id != NULL) {
+            memcpy(p_id, mTileId, sizeof(mTileId));
+        }
+        ThisThread::sleep_for(mLoadMs);
+        mLoads++;
+        return true;
+    }
+
+    virtual bool unload(uint8_t id)
+    {
+        int tile;
+
+        for (tile = 0; tile < SIM_DRP_TILE_NUM; tile++) {
+            if ((id == 0) || (mTileId[tile] == id)) {
+                mTileId[tile] = 0;
+            }
+        }
+        return true;
+    }
+
+    virtual bool run(uint8_t id, void* p_param, uint32_t size)
+    {
+        int tile;
+
+        for (tile = 0; tile < SIM_DRP_TILE_NUM; tile++) {
+            if ((id != 0) && (mTileId[tile] == id)) {
+                break;
+            }
+        }
+        if (tile >= SIM_DRP_TILE_NUM) {
+            return false;
+        }
+        ThisThread::sleep_for(mLib[mTileLib[tile]].latency_ms);
+        mLib[mTileLib[tile]].func(p_param, size);
+        mRuns++;
+        return true;
+    }
+
+private:
+    enum { SIM_DRP_MAX_LIB = 8, SIM_DRP_TILE_NUM = 6 };
+
+    struct Library {
+        const uint8_t* p_config;
+        int tiles;
+        uint32_t latency_ms;
+        Callback<void(void*, uint32_t)> func;
+    };
+
+    uint32_t mLoadMs;
+    Library mLib[SIM_DRP_MAX_LIB];
+    int mLibNum;
+    uint8_t mTileId[SIM_DRP_TILE_NUM];      // library ID loaded on each tile, 0: free
+    int mTileLib[SIM_DRP_TILE_NUM];
+    uint8_t mNextId;
+    uint32_t mRuns;
+    uint32_t mLoads;
+};
+
+#endif
@@ -0,0 +1,187 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <chrono>
+#include "SimI2cBus.h"
+
+SimI2cBus::SimI2cBus(uint32_t latency_us) :
+    mLatencyUs(latency_us), mHz(100000), mErrorInterval(0), mSlaveNum(0),
+    mPending(false), mAborted(false), mExit(false)
+{
+    memset(&mStats, 0, sizeof(mStats));
+    mWorker = std::thread(&SimI2cBus::worker, this);
+}
+
+SimI2cBus::~SimI2cBus()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mExit = true;
+    }
+    mCond.notify_all();
+    mWorker.join();
+}
+
+bool SimI2cBus::attach(int addr, SimI2cSlave& slave)
+{
+    if (mSlaveNum >= SIM_I2C_MAX_SLAVE) {
+        return false;
+    }
+    mAddr[mSlaveNum] = addr & ~1;
+    mSlave[mSlaveNum] = &slave;
+    mSlaveNum++;
+    return true;
+}
+
+SimI2cStats SimI2cBus::stats(void) const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mStats;
+}
+
+int SimI2cBus::write(int addr, const uint8_t* p_data, int len, bool repeated)
+{
+    SimI2cSlave* p_slave = find(addr);
+
+    wait_bus(len + 1);
+    if (nack(p_slave)) {
+        return -1;
+    }
+    return p_slave->write(p_data, len);
+}
+
+int SimI2cBus::read(int addr, uint8_t* p_data, int len)
+{
+    SimI2cSlave* p_slave = find(addr);
+
+    wait_bus(len + 1);
+    if (nack(p_slave)) {
+        return -1;
+    }
+    return p_slave->read(p_data, len);
+}
+
+int SimI2cBus::transfer(int addr, const uint8_t* p_tx, int tx_len, uint8_t* p_rx, int rx_len,
+                        Callback<void(int)> callback)
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        if (mPending) {
+            return -1;
+        }
+        mRequest.addr     = addr;
+        mRequest.p_tx     = p_tx;
+        mRequest.tx_len   = tx_len;
+        mRequest.p_rx     = p_rx;
+        mRequest.rx_len   = rx_len;
+        mRequest.callback = callback;
+        mPending = true;
+        mAborted = false;
+    }
+    mCond.notify_all();
+    return 0;
+}
+
+void SimI2cBus::abort_transfer(void)
+{
+    // like the interrupt of the target, no callback runs after this returns
+    std::lock_guard<std::mutex> callback_lock(mCallbackMutex);
+    std::lock_guard<std::mutex> lock(mMutex);
+    mAborted = true;
+}
+
+SimI2cSlave* SimI2cBus::find(int addr) const
+{
+    int i;
+
+    for (i = 0; i < mSlaveNum; i++) {
+        if (mAddr[i] == (addr & ~1)) {
+            return mSlave[i];
+        }
+    }
+    return NULL;
+}
+
+void SimI2cBus::wait_bus(int bytes)
+{
+    uint64_t bus_us = mLatencyUs + ((uint64_t)bytes * 9 * 1000000) / (uint64_t)mHz;
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStats.transfers++;
+        mStats.bytes += bytes;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(bus_us));
+}
+
+bool SimI2cBus::nack(const SimI2cSlave* p_slave)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    if ((p_slave == NULL) || ((mErrorInterval != 0) && ((mStats.transfers % mErrorInterval) == 0))) {
+        mStats.nacks++;
+        return true;
+    }
+    return false;
+}
+
+void SimI2cBus::worker(void)
+{
+    while (true) {
+        Request request;
+        int result;
+
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mCond.wait(lock, [this]() { return mPending || mExit; });
+            if (mExit) {
+                return;
+            }
+            request = mRequest;
+        }
+
+        // write, repeated start, read
+        lock();
+        result = write(request.addr, request.p_tx, request.tx_len, true);
+        if (result == 0) {
+            result = read(request.addr, request.p_rx, request.rx_len);
+        }
+        unlock();
+
+        Callback<void(int)> callback;
+        std::lock_guard<std::mutex> callback_lock(mCallbackMutex);
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (!mAborted) {
+                callback = request.callback;
+            }
+            mPending = false;
+        }
+        if (callback) {
+            callback((result == 0) ? THERMO_HAL_I2C_OK : THERMO_HAL_I2C_ERROR);
+        }
+    }
+}
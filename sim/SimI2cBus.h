@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SIM_I2C_BUS_H
+#define SIM_I2C_BUS_H
+
+#include "mbed.h"
+#include "ThermoHalI2c.h"
+
+/* Number of devices of one simulated bus */
+#define SIM_I2C_MAX_SLAVE   (8)
+
+/** Device on a simulated I2C bus */
+class SimI2cSlave
+{
+public:
+    virtual ~SimI2cSlave() {}
+
+    /** Bytes written by the master, @return 0 (ack) or nonzero (nack) */
+    virtual int write(const uint8_t* p_data, int len) = 0;
+
+    /** Bytes read by the master, @return 0 (ack) or nonzero (nack) */
+    virtual int read(uint8_t* p_data, int len) = 0;
+};
+
+/** Counters of a simulated bus */
+struct SimI2cStats {
+    uint32_t transfers;     // write and read phases
+    uint32_t bytes;         // bytes on the bus
+    uint32_t nacks;         // missing devices and injected errors
+};
+
+/** ThermoHalI2c of the host simulator
+ *
+ *  Every transfer takes the bus time of its bytes (9 clocks per byte at the
+ *  set frequency) plus a fixed latency. transfer() runs on a worker thread
+ *  and calls the callback from there, like the I2C interrupt on the board.
+ */
+class SimI2cBus : public ThermoHalI2c
+{
+public:
+    /** Create a bus
+     *
+     *  @param latency_us fixed time added to every transfer [us]
+     */
+    SimI2cBus(uint32_t latency_us = 0);
+    virtual ~SimI2cBus();
+
+    /** Connect a device (8bit address) */
+    bool attach(int addr, SimI2cSlave& slave);
+
+    /** Make every n-th transfer fail with a nack (0: never) */
+    void set_error_interval(uint32_t interval) { mErrorInterval = interval; }
+
+    SimI2cStats stats(void) const;
+
+    virtual void frequency(int hz) { mHz = hz; }
+    virtual int frequency(void) const { return mHz; }
+    virtual void lock(void) { mBusMutex.lock(); }
+    virtual void unlock(void) { mBusMutex.unlock(); }
+    virtual int write(int addr, const uint8_t* p_data, int len, bool repeated = false);
+    virtual int read(int addr, uint8_t* p_data, int len);
+    virtual int transfer(int addr, const uint8_t* p_tx, int tx_len, uint8_t* p_rx, int rx_len,
+                         Callback<void(int)> callback);
+    virtual void abort_transfer(void);
+
+private:
+    struct Request {
+        int addr;
+        const uint8_t* p_tx;
+        int tx_len;
+        uint8_t* p_rx;
+        int rx_len;
+        Callback<void(int)> callback;
+    };
+
+    uint32_t mLatencyUs;
+    int mHz;
+    uint32_t mErrorInterval;
+    int mAddr[SIM_I2C_MAX_SLAVE];
+    SimI2cSlave* mSlave[SIM_I2C_MAX_SLAVE];
+    int mSlaveNum;
+
+    std::recursive_mutex mBusMutex;     // lock()/unlock() of the drivers
+    mutable std::mutex mMutex;          // request and counters
+    std::mutex mCallbackMutex;          // held while the callback runs, abort_transfer waits for it
+    std::condition_variable mCond;
+    Request mRequest;
+    bool mPending;
+    bool mAborted;
+    bool mExit;
+    SimI2cStats mStats;
+    std::thread mWorker;
+
+    SimI2cSlave* find(int addr) const;
+    void wait_bus(int bytes);
+    bool nack(const SimI2cSlave* p_slave);
+    void worker(void);
+};
+
+#endif
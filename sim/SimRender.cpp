@@ -0,0 +1,326 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ThermoReference.h"
+#include "ThermoResampler.h"
+#include "ThermoCycle.h"
+#include "SimRender.h"
+
+/* index/weight tables from the sensor grid to each expansion size, as main.cpp */
+static constexpr ThermoResampleTable<SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW, 8, 8>     table8x8{};
+static constexpr ThermoResampleTable<SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW, 16, 16>   table16x16{};
+static constexpr ThermoResampleTable<SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW, 32, 32>   table32x32{};
+static constexpr ThermoResampleTable<SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW, 64, 60>   table64x60{};
+static constexpr ThermoResampleTable<SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW, 160, 120> table160x120{};
+static constexpr ThermoCubicTable<SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW, 8, 8>       cubic8x8{};
+static constexpr ThermoCubicTable<SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW, 16, 16>     cubic16x16{};
+static constexpr ThermoCubicTable<SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW, 32, 32>     cubic32x32{};
+static constexpr ThermoCubicTable<SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW, 64, 60>     cubic64x60{};
+static constexpr ThermoCubicTable<SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW, 160, 120>   cubic160x120{};
+
+static const ThermoResampler resampler_list[] = {
+    ThermoResampler(table8x8,     cubic8x8),
+    ThermoResampler(table16x16,   cubic16x16),
+    ThermoResampler(table32x32,   cubic32x32),
+    ThermoResampler(table64x60,   cubic64x60),
+    ThermoResampler(table160x120, cubic160x120),
+};
+
+SimRender::SimRender(ThermoHalCache& cache, ThermoHalDisplay& display) :
+    mCache(cache), mDisplay(display), mGridDisplay(NULL), mDrpScheduler(NULL), mMode(THERMO_RESAMPLE_LINEAR), mScreen(0), mLayerAlpha(false), mShownAlpha(0xFF),
+    mBlitter0(mSurface0, SIM_VIDEO_PIXEL_HW, SIM_VIDEO_PIXEL_VW, SIM_BUFFER_STRIDE),
+    mBlitter1(mSurface1, SIM_VIDEO_PIXEL_HW, SIM_VIDEO_PIXEL_VW, SIM_BUFFER_STRIDE),
+    mGrid0(mGridSurface0, SIM_RESO_MAX_HW, SIM_RESO_MAX_VW, SIM_GRID_STRIDE),
+    mGrid1(mGridSurface1, SIM_RESO_MAX_HW, SIM_RESO_MAX_VW, SIM_GRID_STRIDE),
+    mGridW(0), mGridH(0),
+    mKernel(mPalette),
+    mRedraw(SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW, 0)
+{
+    mBlitter0.set_overlay(0, 0, SIM_TITLE_AREA_HW, SIM_TITLE_AREA_VW);
+    mBlitter1.set_overlay(0, 0, SIM_TITLE_AREA_HW, SIM_TITLE_AREA_VW);
+    mPalette.setup(SIM_ALPHA_MAX, SIM_TEMP_MARGIN_UNDER + SIM_TEMP_MARGIN_UPPER);
+    use_layer_alpha(true);
+}
+
+bool SimRender::use_layer_alpha(bool enable)
+{
+    // the pixel alpha is shown as drawn until the next alpha change
+    mShownAlpha = 0xFF;
+    mLayerAlpha = mDisplay.set_layer_alpha(mShownAlpha) && enable;
+    return mLayerAlpha;
+}
+
+bool SimRender::use_grid_layer(ThermoHalDisplay* p_display)
+{
+    mGridDisplay = ((p_display != NULL) && p_display->has_scaler()) ? p_display : NULL;
+    if (mLayerAlpha && (mShownAlpha != 0xFF)) {
+        mDisplay.set_layer_alpha(0xFF);
+        mShownAlpha = 0xFF;
+    }
+    // the tiles move between the layers, both start empty
+    mBlitter0.fill(0x0000);
+    mBlitter1.fill(0x0000);
+    mGrid0.fill(0x0000);
+    mGrid1.fill(0x0000);
+    return (mGridDisplay != NULL);
+}
+
+ThermoBlitter& SimRender::begin_tiles(int reso_x, int reso_y, int* p_tile_hw, int* p_tile_vw)
+{
+    blitter().begin_frame();
+    if (mGridDisplay == NULL) {
+        *p_tile_hw = SIM_VIDEO_PIXEL_HW / reso_x;
+        *p_tile_vw = SIM_VIDEO_PIXEL_VW / reso_y;
+        return blitter();
+    }
+    // one pixel per grid point, the layer scales it up
+    mGridW = reso_x;
+    mGridH = reso_y;
+    *p_tile_hw = 1;
+    *p_tile_vw = 1;
+    grid_blitter().begin_frame();
+    return grid_blitter();
+}
+
+void SimRender::begin_redraw(const ThermoBlitter& tiles, const int16_t* p_raw, int reso_x, int reso_y, int tile_hw, int tile_vw,
+                             int min, int max, uint32_t style, int reach)
+{
+    ThermoRedrawKey key;
+
+    key.width  = reso_x;
+    key.height = reso_y;
+    key.min    = min;
+    key.max    = max;
+    key.style  = style | ((mGridDisplay != NULL) ? 0x100 : 0);
+    mRedraw.begin(mScreen, p_raw, key, reach, tiles.redraw_pending(reso_x, tile_hw, tile_vw));
+    // the title is drawn over the tiles every frame
+    if (mGridDisplay == NULL) {
+        mRedraw.add_rect(0, 0, (SIM_TITLE_AREA_HW + tile_hw - 1) / tile_hw, (SIM_TITLE_AREA_VW + tile_vw - 1) / tile_vw);
+    }
+}
+
+void SimRender::layer_alpha(uint8_t alpha)
+{
+    uint8_t value = thermo_layer_alpha(alpha);
+
+    if (mLayerAlpha && (mGridDisplay == NULL) && (value != mShownAlpha)) {
+        mDisplay.set_layer_alpha(value);
+        mShownAlpha = value;
+    }
+}
+
+const ThermoResampler* SimRender::find_resampler(int reso_x, int reso_y)
+{
+    if ((SIM_SENSOR_RESO_HW == reso_x) && (SIM_SENSOR_RESO_VW == reso_y)) {
+        return NULL;
+    }
+    for (const ThermoResampler& resampler : resampler_list) {
+        if ((resampler.out_width() == reso_x) && (resampler.out_height() == reso_y)) {
+            return &resampler;
+        }
+    }
+    return NULL;
+}
+
+bool SimRender::degrade_reso(int* p_reso_x, int* p_reso_y, int level)
+{
+    const int step_num = sizeof(resampler_list) / sizeof(resampler_list[0]);
+    int step;
+
+    // resampler_list goes from the lowest size up
+    for (step = 0; step < step_num; step++) {
+        if ((resampler_list[step].out_width() == *p_reso_x) && (resampler_list[step].out_height() == *p_reso_y)) {
+            break;
+        }
+    }
+    if ((level == 0) || (step == 0) || (step >= step_num)) {
+        return false;
+    }
+    step = (step > level) ? (step - level) : 0;
+    *p_reso_x = resampler_list[step].out_width();
+    *p_reso_y = resampler_list[step].out_height();
+    return true;
+}
+
+void SimRender::clamp_reso(int* p_reso_x, int* p_reso_y)
+{
+    if ((*p_reso_x < SIM_SENSOR_RESO_HW) || (*p_reso_y < SIM_SENSOR_RESO_VW)) {
+        *p_reso_x = SIM_SENSOR_RESO_HW;
+        *p_reso_y = SIM_SENSOR_RESO_VW;
+    }
+}
+
+bool SimRender::expand_on_drp(const int16_t* p_raw, int reso_x, int reso_y, int min, int max)
+{
+    SimDrpResizeParam param;
+    int i;
+
+    if ((mDrpScheduler == NULL) || (find_resampler(reso_x, reso_y) == NULL) || !mDrpScheduler->has_thermal()
+     || (mMode != THERMO_RESAMPLE_LINEAR)) {
+        return false;
+    }
+    for (i = 0; i < (SIM_SENSOR_RESO_HW * SIM_SENSOR_RESO_VW); i++) {
+        mIndexSrc[i] = thermo_index_q15(thermo_normalize_q15(p_raw[i], min, max));
+    }
+    param.p_src      = &mIndexSrc[0];
+    param.p_dst      = &mIndexDst[0];
+    param.src_width  = SIM_SENSOR_RESO_HW;
+    param.src_height = SIM_SENSOR_RESO_VW;
+    param.dst_width  = reso_x;
+    param.dst_height = reso_y;
+
+    // the next camera frame and the job, two camera periods of the simulator
+    return mDrpScheduler->run_thermal(&param, sizeof(param), 67);
+}
+
+void SimRender::update(const int16_t* p_raw, int reso_x, int reso_y, uint8_t alpha, int min, int max)
+{
+    ThermoBlitter* p_target;
+    uint32_t start = thermo_cycle_read();
+    bool on_drp;
+    int reach = THERMO_REDRAW_REACH_LINEAR;
+    int tile_hw;
+    int tile_vw;
+    int x0;
+    int x1;
+    int x;
+    int y;
+
+    clamp_reso(&reso_x, &reso_y);
+    p_target = &begin_tiles(reso_x, reso_y, &tile_hw, &tile_vw);
+    mPalette.set_alpha(pixel_alpha(alpha));
+    on_drp = expand_on_drp(p_raw, reso_x, reso_y, min, max);
+    if (!on_drp) {
+        mKernel.begin(p_raw, SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW, min, max, find_resampler(reso_x, reso_y), mMode);
+    }
+    // the DRP resize samples at the pixel centers, the cubic reach covers its footprint
+    if (find_resampler(reso_x, reso_y) == NULL) {
+        reach = THERMO_REDRAW_REACH_NONE;
+    } else if (on_drp || (mMode == THERMO_RESAMPLE_CUBIC)) {
+        reach = THERMO_REDRAW_REACH_CUBIC;
+    }
+    begin_redraw(*p_target, p_raw, reso_x, reso_y, tile_hw, tile_vw, min, max,
+                 pixel_alpha(alpha) | (on_drp ? 0x200 : 0) | ((uint32_t)mMode << 12), reach);
+    for (y = 0; y < reso_y; y++) {
+        if (!mRedraw.row_span(y, &x0, &x1)) {
+            continue;
+        }
+        if (on_drp) {
+            for (x = x0; x < x1; x++) {
+                mColorRow[x] = mPalette.color_index(mIndexDst[(reso_x * y) + x]);
+            }
+        } else {
+            mKernel.color_span(y, x0, x1, &mColorRow[0]);
+        }
+        p_target->draw_tile_span(y, &mColorRow[0], reso_x, tile_hw, tile_vw, x0, x1);
+    }
+    mRedraw.end();
+    if ((mDrpScheduler != NULL) && (find_resampler(reso_x, reso_y) != NULL)) {
+        mDrpScheduler->record_frame(thermo_cycle_read() - start, on_drp);
+    }
+    show();
+    layer_alpha(alpha);
+}
+
+void SimRender::update_reference(const int16_t* p_raw, int reso_x, int reso_y, uint8_t alpha, int min, int max)
+{
+    ThermoBlitter* p_target;
+    float* p_array = &mArraySensor[0][0];
+    int reach = THERMO_REDRAW_REACH_NONE;
+    int tile_hw;
+    int tile_vw;
+    int x0;
+    int x1;
+    int x;
+    int y;
+
+    clamp_reso(&reso_x, &reso_y);
+    for (y = 0; y < SIM_SENSOR_RESO_VW; y++) {
+        for (x = 0; x < SIM_SENSOR_RESO_HW; x++) {
+            mArraySensor[y][x] = normalize0to1(p_raw[x + (SIM_SENSOR_RESO_HW * y)], min, max);
+        }
+    }
+    // liner_interpolation needs a 2x2 sensor grid at least
+    if (has_reference_expand() && ((SIM_SENSOR_RESO_HW != reso_x) || (SIM_SENSOR_RESO_VW != reso_y))) {
+        liner_interpolation(&mArraySensor[0][0], &mArrayExpand[0][0], SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW, reso_x, reso_y);
+        p_array = &mArrayExpand[0][0];
+        reach = THERMO_REDRAW_REACH_LINEAR;
+    } else {
+        reso_x = SIM_SENSOR_RESO_HW;
+        reso_y = SIM_SENSOR_RESO_VW;
+    }
+    p_target = &begin_tiles(reso_x, reso_y, &tile_hw, &tile_vw);
+    begin_redraw(*p_target, p_raw, reso_x, reso_y, tile_hw, tile_vw, min, max, pixel_alpha(alpha) | 0x400, reach);
+    for (y = 0; y < reso_y; y++) {
+        if (!mRedraw.row_span(y, &x0, &x1)) {
+            continue;
+        }
+        for (x = x0; x < x1; x++) {
+            mColorRow[x] = conv_normalize_to_color(pixel_alpha(alpha), p_array[(y * reso_x) + x]);
+        }
+        p_target->draw_tile_span(y, &mColorRow[0], reso_x, tile_hw, tile_vw, x0, x1);
+    }
+    mRedraw.end();
+    show();
+    layer_alpha(alpha);
+}
+
+void SimRender::clear(void)
+{
+    ThermoBlitter& target = blitter();
+
+    target.begin_frame();
+    target.fill(0x0000);
+    if (mGridDisplay != NULL) {
+        grid_blitter().begin_frame();
+        grid_blitter().fill(0x0000);
+    }
+    show();
+}
+
+void SimRender::show(void)
+{
+    title();
+    blitter().clean_dirty(mCache);
+    if (mGridDisplay != NULL) {
+        grid_blitter().clean_dirty(mCache);
+        mGridDisplay->swap_scaled(grid_blitter().buffer(), mGridW, mGridH, grid_blitter().stride());
+    }
+    swap();
+}
+
+void SimRender::title(void)
+{
+    ThermoBlitter& target = blitter();
+
+    target.fill_rect(SIM_COLOR_WHITE, 0, 0, SIM_TITLE_BOX_HW, SIM_TITLE_BOX_VW);
+    target.mark_dirty(0, 0, SIM_TITLE_AREA_HW, SIM_TITLE_AREA_VW);
+}
+
+void SimRender::swap(void)
+{
+    mDisplay.swap(blitter().buffer());
+    mScreen = (mScreen == 0) ? 1 : 0;
+}
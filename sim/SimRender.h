@@ -0,0 +1,204 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SIM_RENDER_H
+#define SIM_RENDER_H
+
+#include "ThermoFrame.h"
+#include "ThermoBlitter.h"
+#include "ThermoKernel.h"
+#include "ThermoRedraw.h"
+#include "ThermoHalCache.h"
+#include "ThermoHalDisplay.h"
+#include "ThermoDrpScheduler.h"
+#include "SimDrpLib.h"
+
+/* same display layout and colors as main.cpp */
+#define SIM_VIDEO_PIXEL_HW      (640)
+#define SIM_VIDEO_PIXEL_VW      (480)
+#define SIM_BUFFER_STRIDE       (((SIM_VIDEO_PIXEL_HW * 2) + 31u) & ~31u)
+
+#define SIM_TITLE_BOX_HW        (30)
+#define SIM_TITLE_BOX_VW        (20)
+#define SIM_TITLE_AREA_HW       (6 * 3 * 18)
+#define SIM_TITLE_AREA_VW       (8 * 3)
+#define SIM_COLOR_WHITE         (0xFFFF)
+
+#define SIM_ALPHA_MAX           (0x0F)
+#define SIM_ALPHA_SWITCH2       (0x0A)
+#define SIM_ALPHA_SWITCH1       (0x06)
+#define SIM_ALPHA_DEFAULT       (0x03)
+
+#define SIM_TEMP_MARGIN_UPPER   (20)
+#define SIM_TEMP_MARGIN_UNDER   (70)
+
+#define SIM_SENSOR_RESO_HW      (THERMO_FRAME_COLS)
+#define SIM_SENSOR_RESO_VW      (THERMO_FRAME_ROWS)
+#define SIM_RESO_MAX_HW         (160)
+#define SIM_RESO_MAX_VW         (120)
+#define SIM_GRID_STRIDE         (((SIM_RESO_MAX_HW * 2) + 31u) & ~31u)
+
+/** Render path of main.cpp on the host
+ *
+ *  Holds the two display buffers, the palette, the streaming kernel and the
+ *  float buffers of the reference path. update() and update_reference() do
+ *  what update_thermograph() does on the board, without the title text
+ *  (the AsciiFont needs the board). The stages are public for the benchmark.
+ */
+class SimRender
+{
+public:
+    /** Create a renderer
+     *
+     *  @param cache   cache of the display buffers (must outlive the renderer)
+     *  @param display display of the buffers (must outlive the renderer)
+     */
+    SimRender(ThermoHalCache& cache, ThermoHalDisplay& display);
+
+    /** Expansion table of the sensor grid, NULL at the sensor grid itself */
+    static const ThermoResampler* find_resampler(int reso_x, int reso_y);
+
+    /** Go down the expansion sizes by a degrade level, as main.cpp
+     *
+     *  @return true if the resolution was lowered
+     */
+    static bool degrade_reso(int* p_reso_x, int* p_reso_y, int level);
+
+    /** Raise a resolution below the sensor grid to the sensor grid, as main.cpp */
+    static void clamp_reso(int* p_reso_x, int* p_reso_y);
+
+    /** True if the reference path can expand the sensor grid (2x2 at least) */
+    static constexpr bool has_reference_expand(void) { return (SIM_SENSOR_RESO_HW >= 2) && (SIM_SENSOR_RESO_VW >= 2); }
+
+    /** Draw the alpha as the layer alpha of the display, as main.cpp "layer-alpha"
+     *
+     *  The tiles are drawn with SIM_ALPHA_MAX then, an alpha change of the
+     *  same frame leaves the buffer as it is.
+     *
+     *  @param enable false: draw the alpha into every pixel
+     *  @return true if the display took the layer alpha
+     */
+    bool use_layer_alpha(bool enable);
+
+    /** Draw the tiles at grid size into a scaled layer, as main.cpp "grid-layer"
+     *
+     *  The title stays on the display of the constructor.
+     *
+     *  @param p_display layer with a scaler, NULL: draw the tiles at display size
+     *  @return true if the tiles go to the scaled layer
+     */
+    bool use_grid_layer(ThermoHalDisplay* p_display);
+
+    /** Expand the grid on the DRP when it has the time, as main.cpp "drp-thermal"
+     *
+     *  @param p_scheduler scheduler with the sim_drp_resize library, NULL: expand on the CPU
+     */
+    void use_drp(ThermoDrpScheduler* p_scheduler) { mDrpScheduler = p_scheduler; }
+
+    /** Interpolation of the expansion, as main.cpp "upscale-mode" (the DRP only does linear) */
+    void set_mode(ThermoResampleMode mode) { mMode = mode; }
+
+    /** Smallest pixel change whose tiles are redrawn, as main.cpp "redraw-threshold"
+     *
+     *  @param threshold 0: any change, negative: every tile of every frame
+     */
+    void set_redraw_threshold(int threshold) { mRedraw.set_threshold(threshold); }
+
+    /** Redrawn region of the buffers */
+    ThermoRedraw& redraw(void) { return mRedraw; }
+
+    /** update_thermograph() with the fixed-point kernel */
+    void update(const int16_t* p_raw, int reso_x, int reso_y, uint8_t alpha, int min, int max);
+
+    /** update_thermograph() with normalize0to1, liner_interpolation and conv_normalize_to_color */
+    void update_reference(const int16_t* p_raw, int reso_x, int reso_y, uint8_t alpha, int min, int max);
+
+    /** clear_thermograph() */
+    void clear(void);
+
+    /** Buffer being drawn */
+    ThermoBlitter& blitter(void) { return (mScreen == 0) ? mBlitter0 : mBlitter1; }
+
+    /** Grid buffer being drawn (grid layer only) */
+    ThermoBlitter& grid_blitter(void) { return (mScreen == 0) ? mGrid0 : mGrid1; }
+
+    ThermoPalette& palette(void) { return mPalette; }
+    ThermoKernel& kernel(void) { return mKernel; }
+    ThermoHalCache& cache(void) { return mCache; }
+    uint16_t* color_row(void) { return &mColorRow[0]; }
+    float* array_sensor(void) { return &mArraySensor[0][0]; }
+    float* array_expand(void) { return &mArrayExpand[0][0]; }
+
+    /** show_thermograph(): title(), cache clean of the dirty areas and swap() */
+    void show(void);
+
+    /** Alpha of the tiles, SIM_ALPHA_MAX while the display applies the alpha
+     *  (the grid layer is small, it keeps the alpha in the pixels) */
+    uint8_t pixel_alpha(uint8_t alpha) const { return (mLayerAlpha && (mGridDisplay == NULL)) ? SIM_ALPHA_MAX : alpha; }
+
+    /** Write the layer alpha of the display if it changed (layer alpha without grid layer only) */
+    void layer_alpha(uint8_t alpha);
+
+    /** Title box of show_thermograph() */
+    void title(void);
+
+    /** Show the buffer being drawn and switch the drawing buffer */
+    void swap(void);
+
+private:
+    ThermoHalCache& mCache;
+    ThermoHalDisplay& mDisplay;
+    ThermoHalDisplay* mGridDisplay;
+    ThermoDrpScheduler* mDrpScheduler;
+    ThermoResampleMode mMode;
+    int mScreen;
+    bool mLayerAlpha;
+    uint8_t mShownAlpha;
+    ThermoBlitter mBlitter0;
+    ThermoBlitter mBlitter1;
+    ThermoBlitter mGrid0;
+    ThermoBlitter mGrid1;
+    int mGridW;
+    int mGridH;
+    ThermoPalette mPalette;
+    ThermoKernel mKernel;
+    ThermoRedraw mRedraw;
+    uint16_t mColorRow[SIM_RESO_MAX_HW];
+    uint8_t mIndexSrc[SIM_SENSOR_RESO_VW * SIM_SENSOR_RESO_HW];
+    uint8_t mIndexDst[SIM_RESO_MAX_VW * SIM_RESO_MAX_HW];
+    float mArraySensor[SIM_SENSOR_RESO_VW][SIM_SENSOR_RESO_HW];
+    float mArrayExpand[SIM_RESO_MAX_VW][SIM_RESO_MAX_HW];
+    uint8_t mSurface0[SIM_BUFFER_STRIDE * SIM_VIDEO_PIXEL_VW] __attribute((aligned(32)));
+    uint8_t mSurface1[SIM_BUFFER_STRIDE * SIM_VIDEO_PIXEL_VW] __attribute((aligned(32)));
+    uint8_t mGridSurface0[SIM_GRID_STRIDE * SIM_RESO_MAX_VW] __attribute((aligned(32)));
+    uint8_t mGridSurface1[SIM_GRID_STRIDE * SIM_RESO_MAX_VW] __attribute((aligned(32)));
+
+    ThermoBlitter& begin_tiles(int reso_x, int reso_y, int* p_tile_hw, int* p_tile_vw);
+    void begin_redraw(const ThermoBlitter& tiles, const int16_t* p_raw, int reso_x, int reso_y, int tile_hw, int tile_vw,
+                      int min, int max, uint32_t style, int reach);
+    bool expand_on_drp(const int16_t* p_raw, int reso_x, int reso_y, int min, int max);
+};
+
+#endif
@@ -0,0 +1,183 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include "SimScene.h"
+#include "ThermoLog.h"
+
+#define SCENE_PTAT          (253)   // 25.3 degC
+#define SCENE_BACKGROUND    (240)
+#define SCENE_GRADIENT      (15)    // from the top row to the bottom row
+#define SCENE_SPOT          (120)   // hot spot above the background
+#define SCENE_SPOT_RADIUS   (0.35f) // of the sensor width
+#define SCENE_NOISE         (3)     // +-
+
+SimSyntheticScene::SimSyntheticScene(uint32_t seed, int period) :
+    mSeed(seed), mPeriod(period), mFrame(0)
+{
+}
+
+void SimSyntheticScene::next(int16_t* p_ptat, int16_t* p_pixel, int rows, int cols)
+{
+    float angle = (2.0f * (float)M_PI * (float)(mFrame % mPeriod)) / (float)mPeriod;
+    float spot_x = 0.5f + (0.3f * cosf(angle));
+    float spot_y = 0.5f + (0.3f * sinf(angle));
+    int x;
+    int y;
+
+    for (y = 0; y < rows; y++) {
+        for (x = 0; x < cols; x++) {
+            float fx = (cols > 1) ? ((float)x / (float)(cols - 1)) : 0.5f;
+            float fy = (rows > 1) ? ((float)y / (float)(rows - 1)) : 0.5f;
+            float d2 = ((fx - spot_x) * (fx - spot_x)) + ((fy - spot_y) * (fy - spot_y));
+            float heat = 1.0f - (d2 / (SCENE_SPOT_RADIUS * SCENE_SPOT_RADIUS));
+            int value = SCENE_BACKGROUND + (int)(SCENE_GRADIENT * fy);
+
+            if (heat > 0.0f) {
+                value += (int)(SCENE_SPOT * heat);
+            }
+
+            // linear congruential generator (same numbers on every host)
+            mSeed = (mSeed * 1103515245u) + 12345u;
+            value += (int)((mSeed >> 16) % ((SCENE_NOISE * 2) + 1)) - SCENE_NOISE;
+
+            p_pixel[(y * cols) + x] = (int16_t)value;
+        }
+    }
+    *p_ptat = SCENE_PTAT;
+    mFrame++;
+}
+
+SimRecordedScene::SimRecordedScene() :
+    mPixel(0), mFrames(0), mFrame(0), mPeriodMs(0)
+{
+}
+
+int SimRecordedScene::load(const char* path, int pixel)
+{
+    FILE* fp = fopen(path, "r");
+    char line[16384];
+
+    if (ThermoLogReader::is_log(path)) {
+        return load_log(path, pixel);
+    }
+    mData.clear();
+    mPixel = pixel;
+    mFrames = 0;
+    mFrame = 0;
+    mPeriodMs = 0;
+    if (fp == NULL) {
+        return 0;
+    }
+
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        std::vector<int16_t> values;
+        char* p_pos = line;
+        char* p_end;
+
+        while (true) {
+            long value = strtol(p_pos, &p_end, 10);
+
+            if (p_end == p_pos) {
+                break;
+            }
+            values.push_back((int16_t)value);
+            p_pos = p_end;
+            while ((*p_pos == ',') || (*p_pos == ' ') || (*p_pos == '\t')) {
+                p_pos++;
+            }
+        }
+        if ((int)values.size() != (1 + pixel)) {
+            continue;   // comment, empty line or another sensor
+        }
+        mData.insert(mData.end(), values.begin(), values.end());
+        mFrames++;
+    }
+    fclose(fp);
+    return mFrames;
+}
+
+int SimRecordedScene::load_log(const char* path, int pixel)
+{
+    static uint8_t chunk[THERMO_LOG_CHUNK_SIZE];
+    ThermoLogReader log(chunk);
+    std::vector<uint32_t> interval;
+    const uint8_t* p_record;
+    uint32_t last_ms = 0;
+    int i;
+
+    mData.clear();
+    mPixel = pixel;
+    mFrames = 0;
+    mFrame = 0;
+    mPeriodMs = 0;
+    if (!log.open(path)) {
+        return 0;
+    }
+    while ((p_record = log.next_record()) != NULL) {
+        uint32_t timestamp_ms = p_record[0] | (p_record[1] << 8) | (p_record[2] << 16) | ((uint32_t)p_record[3] << 24);
+
+        if ((log.cols() * log.rows()) != pixel) {
+            continue;   // another sensor
+        }
+        // ptat and pixels are int16 little endian from offset 10
+        for (i = 0; i < (1 + pixel); i++) {
+            mData.push_back((int16_t)(p_record[10 + (i * 2)] | (p_record[11 + (i * 2)] << 8)));
+        }
+        if ((mFrames > 0) && (timestamp_ms > last_ms)) {
+            interval.push_back(timestamp_ms - last_ms);
+        }
+        last_ms = timestamp_ms;
+        mFrames++;
+    }
+    if (!interval.empty()) {
+        std::nth_element(interval.begin(), interval.begin() + (interval.size() / 2), interval.end());
+        mPeriodMs = (int)interval[interval.size() / 2];
+    }
+    return mFrames;
+}
+
+void SimRecordedScene::next(int16_t* p_ptat, int16_t* p_pixel, int rows, int cols)
+{
+    const int16_t* p_src;
+    int i;
+
+    if ((mFrames == 0) || ((rows * cols) != mPixel)) {
+        *p_ptat = 0;
+        memset(p_pixel, 0, sizeof(int16_t) * rows * cols);
+        return;
+    }
+
+    p_src = &mData[(size_t)mFrame * (1 + mPixel)];
+    *p_ptat = p_src[0];
+    for (i = 0; i < mPixel; i++) {
+        p_pixel[i] = p_src[1 + i];
+    }
+    mFrame = (mFrame + 1) % mFrames;
+}
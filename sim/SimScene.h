@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SIM_SCENE_H
+#define SIM_SCENE_H
+
+#include <stdint.h>
+#include <vector>
+
+/** Heat scene seen by a simulated sensor
+ *
+ *  Temperatures are the integers which set a centigrade to 10 times.
+ */
+class SimScene
+{
+public:
+    virtual ~SimScene() {}
+
+    /** Produce the next frame
+     *
+     *  @param p_ptat  sensor temperature (output)
+     *  @param p_pixel pixels [rows][cols] (output)
+     */
+    virtual void next(int16_t* p_ptat, int16_t* p_pixel, int rows, int cols) = 0;
+};
+
+/** Synthetic scene: a warm background with a hot spot moving on a circle
+ *
+ *  The noise comes from a fixed-seed generator, so every run is the same.
+ */
+class SimSyntheticScene : public SimScene
+{
+public:
+    /** Create a scene
+     *
+     *  @param seed   noise seed
+     *  @param period frames of one turn of the hot spot
+     */
+    SimSyntheticScene(uint32_t seed = 1, int period = 100);
+
+    virtual void next(int16_t* p_ptat, int16_t* p_pixel, int rows, int cols);
+
+private:
+    uint32_t mSeed;
+    int mPeriod;
+    int mFrame;
+};
+
+/** Recorded scene replayed in a loop
+ *
+ *  One frame per line: "ptat,pixel0,pixel1,...", lines with another number
+ *  of pixels than the sensor are rejected.
+ */
+class SimRecordedScene : public SimScene
+{
+public:
+    SimRecordedScene();
+
+    /** Load a recording
+     *
+     *  @param path  text file or frame log (ThermoLogWriter)
+     *  @param pixel number of pixels of a frame
+     *  @return number of frames loaded
+     */
+    int load(const char* path, int pixel);
+
+    /** Median frame interval of a log [ms], 0 if unknown (text file) */
+    int period_ms(void) const { return mPeriodMs; }
+
+    virtual void next(int16_t* p_ptat, int16_t* p_pixel, int rows, int cols);
+
+private:
+    std::vector<int16_t> mData;     // [frames][1 + pixel]
+    int mPixel;
+    int mFrames;
+    int mFrame;
+    int mPeriodMs;
+
+    int load_log(const char* path, int pixel);
+};
+
+#endif
@@ -0,0 +1,219 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SIM_MBED_H
+#define SIM_MBED_H
+
+/* Host (Linux) replacement of the mbed-os API used by the portable sources:
+ * Callback, Thread, EventFlags, ThisThread and Kernel on top of the C++ standard library.
+ * DEVICE_I2C is not defined, so the drivers only offer their ThermoHalI2c constructors.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#define MBED_ASSERT(expr)   assert(expr)
+
+#define osWaitForever       (0xFFFFFFFFU)
+#define osFlagsError        (0x80000000U)
+#define osFlagsErrorTimeout (0xFFFFFFFEU)
+
+typedef enum {
+    osPriorityLow         = 8,
+    osPriorityBelowNormal = 16,
+    osPriorityNormal      = 24,
+    osPriorityAboveNormal = 32,
+    osPriorityHigh        = 40,
+    osPriorityRealtime    = 48,
+} osPriority;
+
+typedef int32_t osStatus;
+#define osOK                (0)
+
+/* mbed_critical.h atomics (sequentially consistent) */
+inline bool core_util_atomic_cas_u8(volatile uint8_t* ptr, uint8_t* expectedCurrentValue, uint8_t desiredValue)
+{
+    return __atomic_compare_exchange_n(ptr, expectedCurrentValue, desiredValue, false, __ATOMIC_SEQ_CST,
+                                       __ATOMIC_SEQ_CST);
+}
+
+inline uint8_t core_util_atomic_load_u8(const volatile uint8_t* valuePtr)
+{
+    return __atomic_load_n(valuePtr, __ATOMIC_SEQ_CST);
+}
+
+inline void core_util_atomic_store_u8(volatile uint8_t* valuePtr, uint8_t desiredValue)
+{
+    __atomic_store_n(valuePtr, desiredValue, __ATOMIC_SEQ_CST);
+}
+
+namespace mbed {
+
+template <typename F>
+class Callback;
+
+/** Callable of a function or an object method
+ *
+ *  Like mbed::Callback the target is held inline, so copies never use the heap.
+ */
+template <typename R, typename... A>
+class Callback<R(A...)>
+{
+public:
+    Callback() : mThunk(NULL) {}
+
+    Callback(R (*func)(A...)) : mThunk(NULL)
+    {
+        if (func != NULL) {
+            mFunc = func;
+            mThunk = &Callback::call_func;
+        }
+    }
+
+    template <typename T, typename U>
+    Callback(U* obj, R (T::*method)(A...))
+    {
+        bind(static_cast<T*>(obj), method);
+    }
+
+    template <typename T, typename U>
+    Callback(const U* obj, R (T::*method)(A...) const)
+    {
+        bind(static_cast<const T*>(obj), method);
+    }
+
+    R call(A... args) const { return mThunk(this, args...); }
+    R operator()(A... args) const { return mThunk(this, args...); }
+    explicit operator bool() const { return mThunk != NULL; }
+
+private:
+    class Undefined;
+    typedef R (Undefined::*Method)(A...);
+
+    R (*mThunk)(const Callback*, A...);
+    R (*mFunc)(A...);
+    const void* mObj;
+    alignas(Method) unsigned char mMethod[sizeof(Method)];
+
+    template <typename O, typename M>
+    void bind(O* obj, M method)
+    {
+        static_assert(sizeof(M) <= sizeof(Method), "method pointer too large");
+        mObj = obj;
+        memcpy(mMethod, &method, sizeof(M));
+        mThunk = &Callback::call_method<O, M>;
+    }
+
+    static R call_func(const Callback* p_cb, A... args)
+    {
+        return p_cb->mFunc(args...);
+    }
+
+    template <typename O, typename M>
+    static R call_method(const Callback* p_cb, A... args)
+    {
+        M method;
+
+        memcpy(&method, p_cb->mMethod, sizeof(M));
+        return (((O*)p_cb->mObj)->*method)(args...);
+    }
+};
+
+template <typename R, typename... A>
+Callback<R(A...)> callback(R (*func)(A...))
+{
+    return Callback<R(A...)>(func);
+}
+
+template <typename T, typename U, typename R, typename... A>
+Callback<R(A...)> callback(U* obj, R (T::*method)(A...))
+{
+    return Callback<R(A...)>(obj, method);
+}
+
+template <typename T, typename U, typename R, typename... A>
+Callback<R(A...)> callback(const U* obj, R (T::*method)(A...) const)
+{
+    return Callback<R(A...)>(obj, method);
+}
+
+/** Event flags of rtos::EventFlags (flags are cleared when waited) */
+class EventFlags
+{
+public:
+    EventFlags() : mFlags(0) {}
+
+    uint32_t set(uint32_t flags);
+    uint32_t clear(uint32_t flags = 0x7FFFFFFF);
+    uint32_t get(void) const;
+    uint32_t wait_any(uint32_t flags, uint32_t millisec = osWaitForever, bool clear = true);
+    uint32_t wait_all(uint32_t flags, uint32_t millisec = osWaitForever, bool clear = true);
+
+private:
+    mutable std::mutex mMutex;
+    std::condition_variable mCond;
+    uint32_t mFlags;
+
+    uint32_t wait(uint32_t flags, uint32_t millisec, bool clear, bool all);
+};
+
+/** rtos::Thread on std::thread (priority and stack size are ignored) */
+class Thread
+{
+public:
+    Thread(osPriority priority = osPriorityNormal, uint32_t stack_size = 4096,
+           unsigned char* stack_mem = NULL, const char* name = NULL) {}
+
+    /** Start the thread, it runs until the process exits */
+    osStatus start(Callback<void()> task);
+
+    uint32_t flags_set(uint32_t flags) { return mFlags.set(flags); }
+
+private:
+    EventFlags mFlags;
+};
+
+namespace ThisThread {
+void sleep_for(uint32_t millisec);
+void sleep_until(uint64_t millisec);
+void yield(void);
+}
+
+namespace Kernel {
+/** Milliseconds since the process started */
+uint64_t get_ms_count(void);
+}
+
+} // namespace mbed
+
+using namespace mbed;
+
+#endif
@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <chrono>
+#include "mbed.h"
+
+namespace mbed {
+
+uint32_t EventFlags::set(uint32_t flags)
+{
+    uint32_t result;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mFlags |= flags;
+        result = mFlags;
+    }
+    mCond.notify_all();
+    return result;
+}
+
+uint32_t EventFlags::clear(uint32_t flags)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    uint32_t result = mFlags;
+
+    mFlags &= ~flags;
+    return result;
+}
+
+uint32_t EventFlags::get(void) const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mFlags;
+}
+
+uint32_t EventFlags::wait_any(uint32_t flags, uint32_t millisec, bool clear)
+{
+    return wait(flags, millisec, clear, false);
+}
+
+uint32_t EventFlags::wait_all(uint32_t flags, uint32_t millisec, bool clear)
+{
+    return wait(flags, millisec, clear, true);
+}
+
+uint32_t EventFlags::wait(uint32_t flags, uint32_t millisec, bool clear, bool all)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    auto ready = [this, flags, all]() {
+        return all ? ((mFlags & flags) == flags) : ((mFlags & flags) != 0);
+    };
+    uint32_t result;
+
+    if (millisec == osWaitForever) {
+        mCond.wait(lock, ready);
+    } else if (!mCond.wait_for(lock, std::chrono::milliseconds(millisec), ready)) {
+        return osFlagsErrorTimeout;
+    }
+    result = mFlags;
+    if (clear) {
+        mFlags &= ~flags;
+    }
+    return result;
+}
+
+osStatus Thread::start(Callback<void()> task)
+{
+    std::thread(task).detach();
+    return osOK;
+}
+
+namespace ThisThread {
+
+void sleep_for(uint32_t millisec)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(millisec));
+}
+
+void sleep_until(uint64_t millisec)
+{
+    uint64_t now = Kernel::get_ms_count();
+
+    if (millisec > now) {
+        sleep_for((uint32_t)(millisec - now));
+    }
+}
+
+void yield(void)
+{
+    std::this_thread::yield();
+}
+
+} // namespace ThisThread
+
+namespace Kernel {
+
+uint64_t get_ms_count(void)
+{
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    return (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace Kernel
+
+} // namespace mbed
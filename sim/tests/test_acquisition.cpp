@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/* ThermoAcquisition on a slow simulated bus
+ *
+ * Every I2C transfer takes more than 30ms (SimI2cBus latency), the
+ * acquisition thread reads back to back, so the bus is busy nearly all the
+ * time. latest(), read() and read_raw() of the render loop and the recorder
+ * must still return at once. read() must hand over every frame in order,
+ * filtered as by a filter of its own, and read_raw() the same frames with
+ * the pixels the simulated sensor sent.
+ */
+
+#include <unistd.h>
+#include <chrono>
+#include "mbed.h"
+#include "D6T_44L_06.h"
+#include "ThermoAcquisition.h"
+#include "ThermoD6TDevice.h"
+#include "ThermoFrameFilter.h"
+#include "SimD6T.h"
+#include "SimI2cBus.h"
+#include "SimScene.h"
+#include "thermo_test.h"
+
+#define LATENCY_US      (15000)     // per phase: write and read take 30ms plus the bus time
+#define RUN_MS          (1000)
+#define CALL_LIMIT_US   (5000)      // far below one transfer
+#define SENSOR_ID       (3)
+
+static SimSyntheticScene scene(5, 50);
+static SimSyntheticScene expected_scene(5, 50);
+static SimD6T sim_d6t(scene);
+static SimI2cBus bus(LATENCY_US);
+static D6T<ThermoSensorModel> d6t(bus);
+static ThermoD6TDevice device(d6t);
+static ThermoAcquisition acquisition(1, osPriorityNormal);
+static ThermoFrameFilter filter(THERMO_FILTER_EMA, 2, 3);
+static ThermoFrameFilter expected_filter(THERMO_FILTER_EMA, 2, 3);
+
+int main(void)
+{
+    ThermoFrame frame;
+    ThermoFrame raw;
+    ThermoFrame expected;
+    uint32_t cursor = 0;
+    uint32_t raw_cursor = 0;
+    uint32_t frames = 0;
+    uint32_t calls = 0;
+    double slowest_us = 0;
+    uint64_t start;
+    int result;
+
+    bus.frequency(400000);
+    bus.attach(D6T_ADDR, sim_d6t);
+    TEST_CHECK(acquisition.add(device, SENSOR_ID));
+    TEST_CHECK(acquisition.set_filter(SENSOR_ID, &filter));
+    TEST_CHECK(!acquisition.latest(SENSOR_ID, frame));
+    acquisition.start();
+
+    start = Kernel::get_ms_count();
+    while ((Kernel::get_ms_count() - start) < RUN_MS) {
+        auto t0 = std::chrono::steady_clock::now();
+        bool latest = acquisition.latest(SENSOR_ID, frame);
+        bool next = acquisition.read(SENSOR_ID, cursor, frame);
+        bool next_raw = acquisition.read_raw(SENSOR_ID, raw_cursor, raw);
+        auto t1 = std::chrono::steady_clock::now();
+        double us = std::chrono::duration<double, std::micro>(t1 - t0).count();
+
+        slowest_us = (us > slowest_us) ? us : slowest_us;
+        calls++;
+        if (next) {
+            TEST_CHECK(latest);
+            frames++;
+            // frames in order, each one the next of the scene
+            expected_scene.next(&expected.ptat, expected.pixel, THERMO_FRAME_ROWS, THERMO_FRAME_COLS);
+            TEST_CHECK(next_raw);
+            TEST_CHECK_EQ(raw.sequence, frames);
+            TEST_CHECK_EQ(raw.ptat, expected.ptat);
+            TEST_CHECK(memcmp(raw.pixel, expected.pixel, sizeof(expected.pixel)) == 0);
+
+            expected_filter.apply(expected);
+            TEST_CHECK_EQ(frame.sequence, frames);
+            TEST_CHECK_EQ(frame.sensor_id, SENSOR_ID);
+            TEST_CHECK_EQ(frame.timestamp_ms, raw.timestamp_ms);
+            TEST_CHECK_EQ(frame.ptat, expected.ptat);
+            TEST_CHECK(memcmp(frame.pixel, expected.pixel, sizeof(expected.pixel)) == 0);
+            TEST_CHECK(memcmp(frame.changed, expected.changed, sizeof(expected.changed)) == 0);
+        }
+        ThisThread::sleep_for(1);
+    }
+
+    printf("%lu calls, slowest %.0f us, %lu frames of >= %d ms transfers\n", (unsigned long)calls, slowest_us,
+           (unsigned long)frames, (2 * LATENCY_US) / 1000);
+    TEST_CHECK(slowest_us < CALL_LIMIT_US);
+    // the bus was busy: frames came at the transfer rate, the render loop ran much faster
+    TEST_CHECK(frames >= 10);
+    TEST_CHECK(frames <= (RUN_MS / ((2 * LATENCY_US) / 1000)));
+    TEST_CHECK(calls > (frames * 10));
+    TEST_CHECK_EQ(acquisition.errors(SENSOR_ID), 0);
+
+    result = thermo_test_result("test_acquisition");
+
+    // the acquisition thread never ends, leave without running the destructors
+    fflush(stdout);
+    _exit(result);
+}
@@ -0,0 +1,194 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/* ThermoFrameFilter
+ *
+ * EMA: a step follows the float EMA of the same weight within one unit
+ * and settles on the new value exactly, upwards and downwards.
+ * Median: single spikes (window 3) and double spikes (window 5) are
+ * removed, a step is followed after half the window.
+ * Deadband: a value is latched until it moves more than the deadband, and
+ * the change mask marks exactly the pixels passed on; the first frame and
+ * the first frame after reset() mark every pixel.
+ */
+
+#include <string.h>
+#include "ThermoFrameFilter.h"
+#include "thermo_test.h"
+
+#define LAST_PIXEL  (THERMO_FRAME_PIXEL - 1)
+
+static ThermoFrame frame;
+
+static void fill(int16_t value)
+{
+    int i;
+
+    frame.ptat = value;
+    for (i = 0; i < THERMO_FRAME_PIXEL; i++) {
+        frame.pixel[i] = value;
+    }
+}
+
+static int changed_count(void)
+{
+    int count = 0;
+    int i;
+
+    for (i = 0; i < THERMO_FRAME_PIXEL; i++) {
+        count += thermo_frame_changed(frame, i) ? 1 : 0;
+    }
+    return count;
+}
+
+static void check_ema_step(int16_t from, int16_t to)
+{
+    ThermoFrameFilter filter(THERMO_FILTER_EMA, 2, 0);
+    double expected = from;
+    int16_t last = from;
+    int k;
+
+    fill(from);
+    filter.apply(frame);
+    for (k = 1; k <= 40; k++) {
+        fill(to);
+        filter.apply(frame);
+        expected += (to - expected) / 4.0;
+        TEST_CHECK_NEAR(frame.pixel[0], expected, 1.0);
+        TEST_CHECK_EQ(frame.pixel[LAST_PIXEL], frame.pixel[0]);
+        TEST_CHECK_EQ(frame.ptat, frame.pixel[0]);
+        // monotonic towards the new value
+        TEST_CHECK((to > from) ? (frame.pixel[0] >= last) : (frame.pixel[0] <= last));
+        last = frame.pixel[0];
+    }
+    // settled exactly, not one unit off by the rounding
+    TEST_CHECK_EQ(frame.pixel[0], to);
+}
+
+static void check_median(int window)
+{
+    ThermoFrameFilter filter(THERMO_FILTER_MEDIAN, window, 0);
+    int spike;
+    int k;
+
+    fill(200);
+    filter.apply(frame);
+    for (k = 0; k < window; k++) {
+        fill(200);
+        filter.apply(frame);
+    }
+
+    // spikes shorter than half the window never show
+    for (spike = 1; spike <= (window / 2); spike++) {
+        for (k = 0; k < (spike + window); k++) {
+            fill((k < spike) ? 900 : 200);
+            frame.pixel[1] = (k < spike) ? -300 : 200;
+            filter.apply(frame);
+            TEST_CHECK_EQ(frame.pixel[0], 200);
+            TEST_CHECK_EQ(frame.pixel[1], 200);
+            TEST_CHECK_EQ(frame.ptat, 200);
+        }
+    }
+
+    // a step is followed after half the window
+    for (k = 1; k <= window; k++) {
+        fill(250);
+        filter.apply(frame);
+        TEST_CHECK_EQ(frame.pixel[0], (k > (window / 2)) ? 250 : 200);
+    }
+}
+
+static void check_deadband(void)
+{
+    ThermoFrameFilter filter(THERMO_FILTER_OFF, 0, 5);
+
+    // the first frame is passed on completely
+    fill(200);
+    filter.apply(frame);
+    TEST_CHECK_EQ(changed_count(), THERMO_FRAME_PIXEL);
+    TEST_CHECK_EQ(filter.stats().last_changed, THERMO_FRAME_PIXEL);
+
+    // moves within the deadband are held at the latched value
+    fill(200);
+    frame.pixel[1] = 203;
+    frame.pixel[LAST_PIXEL] = 195;
+    filter.apply(frame);
+    TEST_CHECK_EQ(frame.pixel[1], 200);
+    TEST_CHECK_EQ(frame.pixel[LAST_PIXEL], 200);
+    TEST_CHECK_EQ(changed_count(), 0);
+    TEST_CHECK_EQ(filter.stats().last_changed, 0);
+
+    // the drift is measured from the latched value, not from the last reading
+    fill(200);
+    frame.pixel[1] = 206;
+    frame.pixel[LAST_PIXEL] = 205;
+    filter.apply(frame);
+    TEST_CHECK_EQ(frame.pixel[1], 206);
+    TEST_CHECK_EQ(frame.pixel[LAST_PIXEL], 200);
+    TEST_CHECK(thermo_frame_changed(frame, 1));
+    TEST_CHECK(!thermo_frame_changed(frame, LAST_PIXEL));
+    TEST_CHECK_EQ(changed_count(), 1);
+
+    // latched at 206 now: 201 is held, 200 passes
+    fill(200);
+    frame.pixel[1] = 201;
+    frame.pixel[LAST_PIXEL] = 194;
+    filter.apply(frame);
+    TEST_CHECK_EQ(frame.pixel[1], 206);
+    TEST_CHECK_EQ(frame.pixel[LAST_PIXEL], 194);
+    TEST_CHECK(!thermo_frame_changed(frame, 1));
+    TEST_CHECK(thermo_frame_changed(frame, LAST_PIXEL));
+    TEST_CHECK_EQ(changed_count(), 1);
+
+    // the PTAT has the deadband too but no mask bit
+    fill(200);
+    frame.ptat = 220;
+    frame.pixel[1] = 206;
+    frame.pixel[LAST_PIXEL] = 194;
+    filter.apply(frame);
+    TEST_CHECK_EQ(frame.ptat, 220);
+    TEST_CHECK_EQ(changed_count(), 0);
+
+    // after reset() the next frame is passed on as it is, every pixel marked
+    filter.reset();
+    fill(201);
+    filter.apply(frame);
+    TEST_CHECK_EQ(frame.pixel[0], 201);
+    TEST_CHECK_EQ(frame.pixel[1], 201);
+    TEST_CHECK_EQ(changed_count(), THERMO_FRAME_PIXEL);
+    TEST_CHECK_EQ(filter.stats().frames, 6);
+    TEST_CHECK_EQ(filter.stats().changed, THERMO_FRAME_PIXEL * 2 + 2);
+}
+
+int main(void)
+{
+    check_ema_step(200, 300);
+    check_ema_step(300, 200);
+    check_ema_step(-100, 37);
+    check_median(3);
+    check_median(5);
+    check_deadband();
+    return thermo_test_result("test_frame_filter");
+}
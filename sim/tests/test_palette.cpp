@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/* ThermoPalette against conv_normalize_to_color()
+ *
+ * Every table point of the normalized and of the raw table has to give the
+ * color of the float path exactly, for every alpha and after the alpha or
+ * the raw range changed. Values between two points take the nearer one.
+ */
+
+#include "ThermoPalette.h"
+#include "ThermoReference.h"
+#include "thermo_test.h"
+
+static ThermoPalette palette;
+
+static void check_table(uint8_t alpha)
+{
+    int entry = 1 << THERMO_PALETTE_SHIFT;
+    int mismatch = 0;
+    int data;
+    int i;
+
+    // sweep of 0.0 - 1.0 over the table points
+    for (i = 0; i < THERMO_PALETTE_SIZE; i++) {
+        float point = (float)i / (float)(THERMO_PALETTE_SIZE - 1);
+        uint16_t expected = conv_normalize_to_color(alpha, point);
+
+        data = (i * THERMO_Q15_ONE) / (THERMO_PALETTE_SIZE - 1);
+        mismatch += (palette.color((uint16_t)data) != expected) ? 1 : 0;
+    }
+    TEST_CHECK_EQ(mismatch, 0);
+
+    // every Q15 value: the color of the nearest table point
+    mismatch = 0;
+    for (data = 0; data <= THERMO_Q15_ONE; data++) {
+        int nearest = (data + (entry / 2)) / entry;
+        float point = (float)nearest / (float)(THERMO_PALETTE_SIZE - 1);
+
+        mismatch += (palette.color((uint16_t)data) != conv_normalize_to_color(alpha, point)) ? 1 : 0;
+    }
+    TEST_CHECK_EQ(mismatch, 0);
+}
+
+static void check_raw(uint8_t alpha, int raw_range)
+{
+    int mismatch = 0;
+    int offset;
+
+    // below and above the range saturate like normalize0to1()
+    for (offset = -20; offset <= (raw_range + 20); offset++) {
+        uint16_t expected = conv_normalize_to_color(alpha, normalize0to1((int16_t)offset, 0, raw_range));
+
+        mismatch += (palette.color_raw(offset) != expected) ? 1 : 0;
+    }
+    TEST_CHECK_EQ(mismatch, 0);
+}
+
+int main(void)
+{
+    static const uint8_t alpha_list[] = { 0x0F, 0x0A, 0x06, 0x03, 0x00 };
+    static const int range_list[] = { 1, 90, 20, 357, THERMO_PALETTE_RAW_MAX };
+
+    TEST_CHECK(!palette.setup(0x0F, 0));
+    TEST_CHECK(!palette.setup(0x0F, THERMO_PALETTE_RAW_MAX + 1));
+    for (uint8_t alpha : alpha_list) {
+        TEST_CHECK(palette.setup(alpha, 90));
+        check_table(alpha);
+        check_raw(alpha, 90);
+    }
+
+    // the alpha of every entry is replaced, the colors stay
+    TEST_CHECK(palette.setup(0x0F, 90));
+    for (uint8_t alpha : alpha_list) {
+        palette.set_alpha(alpha);
+        TEST_CHECK_EQ(palette.alpha(), alpha);
+        check_table(alpha);
+        check_raw(alpha, 90);
+    }
+
+    // a new raw range at the current alpha
+    palette.set_alpha(0x06);
+    for (int range : range_list) {
+        TEST_CHECK(palette.set_raw_range(range));
+        TEST_CHECK_EQ(palette.raw_range(), range);
+        check_raw(0x06, range);
+    }
+    TEST_CHECK(!palette.set_raw_range(0));
+    check_table(0x06);
+    return thermo_test_result("test_palette");
+}
@@ -0,0 +1,237 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/* PEC of the D6T sensors: D6T_Crc8Table against the bit loop
+ *
+ * The table has to give the bit loop's CRC for all 256 bytes and the
+ * SMBus check value. Whole answers of every model, with the PEC computed
+ * by the bit loop, have to pass D6T::read(), and a single flipped bit or a
+ * wrong PEC byte has to be rejected, at the default and another address.
+ * setup() has to write the init sequence of the model, each write with a
+ * PEC the bit loop accepts, and fail when the sensor does not answer.
+ */
+
+#include "mbed.h"
+#include "D6T_44L_06.h"
+#include "D6T_Crc8.h"
+#include "SimI2cBus.h"
+#include "thermo_test.h"
+
+#define OTHER_ADDR      (0x0B << 1)
+
+static constexpr D6T_Crc8Table crc8_table{};
+
+/* Sensor answering with a fixed frame, PEC by the bit loop */
+template <typename Traits>
+class PecSlave : public SimI2cSlave
+{
+public:
+    PecSlave(int addr) : mAddr(addr), mCmd(0), mFlip(-1), mNack(false), mWrites(0), mBadPec(0)
+    {
+        int i;
+
+        for (i = 0; i < (Traits::N_READ - 1); i++) {
+            mData[i] = (uint8_t)((i * 37) + 11);
+        }
+        mData[Traits::N_READ - 1] = pec(mData, Traits::N_READ - 1);
+    }
+
+    /** Flip one bit of the answer (bit number over the whole frame, -1: none) */
+    void flip(int bit) { mFlip = bit; }
+
+    /** Refuse the register writes of setup */
+    void nack(bool on) { mNack = on; }
+
+    /** Register writes (longer than a command) and those with a wrong PEC */
+    int writes(void) const { return mWrites; }
+    int bad_pec(void) const { return mBadPec; }
+
+    /** Bytes of the first register write */
+    const uint8_t* first_write(void) const { return mFirst; }
+
+    uint8_t pec(const uint8_t* p_data, int len) const
+    {
+        uint8_t crc;
+        int i;
+
+        crc = D6T_crc8_bitwise((uint8_t)mAddr);
+        crc = D6T_crc8_bitwise(Traits::CMD ^ crc);
+        crc = D6T_crc8_bitwise((uint8_t)(mAddr | 1) ^ crc);
+        for (i = 0; i < len; i++) {
+            crc = D6T_crc8_bitwise(p_data[i] ^ crc);
+        }
+        return crc;
+    }
+
+    int16_t value(int n) const { return (int16_t)(mData[n * 2] | (mData[(n * 2) + 1] << 8)); }
+
+    virtual int write(const uint8_t* p_data, int len)
+    {
+        uint8_t crc;
+        int i;
+
+        if (len == 1) {
+            mCmd = p_data[0];
+            return 0;
+        }
+        if (mNack) {
+            return -1;
+        }
+        crc = D6T_crc8_bitwise((uint8_t)mAddr);
+        for (i = 0; i < (len - 1); i++) {
+            crc = D6T_crc8_bitwise(p_data[i] ^ crc);
+        }
+        if (mWrites == 0) {
+            memcpy(mFirst, p_data, (len < (int)sizeof(mFirst)) ? len : (int)sizeof(mFirst));
+        }
+        mWrites++;
+        mBadPec += (crc != p_data[len - 1]) ? 1 : 0;
+        return 0;
+    }
+
+    virtual int read(uint8_t* p_data, int len)
+    {
+        if ((mCmd != Traits::CMD) || (len != Traits::N_READ)) {
+            return -1;
+        }
+        memcpy(p_data, mData, len);
+        if (mFlip >= 0) {
+            p_data[mFlip / 8] ^= (uint8_t)(1 << (mFlip % 8));
+        }
+        return 0;
+    }
+
+private:
+    int mAddr;
+    uint8_t mCmd;
+    int mFlip;
+    bool mNack;
+    int mWrites;
+    int mBadPec;
+    uint8_t mFirst[D6T_INIT_WRITE_MAX + 1];
+    uint8_t mData[Traits::N_READ];
+};
+
+/* Number of register writes of an init sequence */
+static int init_writes(const uint8_t* p_init)
+{
+    int n = 0;
+
+    while ((p_init != NULL) && (p_init[0] != 0)) {
+        p_init += p_init[0] + 1;
+        n++;
+    }
+    return n;
+}
+
+template <typename Traits>
+static void check_model(int addr)
+{
+    SimI2cBus bus;
+    PecSlave<Traits> slave(addr);
+    D6T<Traits> d6t(bus, addr);
+    int16_t ptat = 0;
+    int16_t pixel[Traits::PIXEL];
+    int bits = Traits::N_READ * 8;
+    int rejected = 0;
+    int bit;
+    int i;
+
+    bus.frequency(0x7FFFFFFF);
+    bus.attach(addr, slave);
+
+    // the init sequence of the model, a refused write fails the setup
+    slave.nack(true);
+    TEST_CHECK_EQ(d6t.setup(), init_writes(Traits::init()) == 0);
+    slave.nack(false);
+    TEST_CHECK(d6t.setup());
+    TEST_CHECK_EQ(slave.writes(), init_writes(Traits::init()));
+    TEST_CHECK_EQ(slave.bad_pec(), 0);
+    TEST_CHECK_EQ(d6t.stats().i2c_errors, (init_writes(Traits::init()) == 0) ? 0 : 1);
+
+    // the answer as sent passes and is decoded
+    TEST_CHECK(d6t.read(&ptat, pixel));
+    TEST_CHECK_EQ(ptat, slave.value(0));
+    for (i = 0; i < Traits::PIXEL; i++) {
+        TEST_CHECK_EQ(pixel[i], slave.value(i + 1));
+    }
+
+    // any single flipped bit, of the data or of the PEC byte, is caught
+    for (bit = 0; bit < bits; bit++) {
+        slave.flip(bit);
+        rejected += d6t.read(&ptat, pixel) ? 0 : 1;
+    }
+    slave.flip(-1);
+    TEST_CHECK_EQ(rejected, bits);
+    TEST_CHECK_EQ(d6t.stats().reads, 1);
+    TEST_CHECK_EQ(d6t.stats().pec_errors, bits);
+    TEST_CHECK(d6t.read(&ptat, pixel));
+}
+
+int main(void)
+{
+    static const uint8_t check_data[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    uint8_t table_crc = 0;
+    uint8_t bitwise_crc = 0;
+    int mismatch = 0;
+    int n;
+
+    // every byte
+    for (n = 0; n < 256; n++) {
+        mismatch += (crc8_table.crc[n] != D6T_crc8_bitwise((uint8_t)n)) ? 1 : 0;
+    }
+    TEST_CHECK_EQ(mismatch, 0);
+
+    // CRC-8/SMBUS check value
+    for (n = 0; n < (int)sizeof(check_data); n++) {
+        table_crc = crc8_table.crc[check_data[n] ^ table_crc];
+        bitwise_crc = D6T_crc8_bitwise(check_data[n] ^ bitwise_crc);
+    }
+    TEST_CHECK_EQ(table_crc, 0xF4);
+    TEST_CHECK_EQ(bitwise_crc, 0xF4);
+
+    // whole answers of every model
+    check_model<D6T_1A_01_Traits>(D6T_ADDR);
+    check_model<D6T_8L_09_Traits>(D6T_ADDR);
+    check_model<D6T_44L_06_Traits>(D6T_ADDR);
+    check_model<D6T_32L_01A_Traits>(D6T_ADDR);
+    check_model<D6T_44L_06_Traits>(OTHER_ADDR);
+    check_model<D6T_8L_09_Traits>(OTHER_ADDR);
+
+    // the first write of the D6T-8L-09 sequence as OMRON's sample sends it, PEC included
+    {
+        SimI2cBus bus;
+        PecSlave<D6T_8L_09_Traits> slave(D6T_ADDR);
+        D6T_8L_09 d6t(bus);
+        static const uint8_t first[] = {0x02, 0x00, 0x01, 0xEE};
+
+        bus.frequency(0x7FFFFFFF);
+        bus.attach(D6T_ADDR, slave);
+        TEST_CHECK(d6t.setup());
+        TEST_CHECK(memcmp(slave.first_write(), first, sizeof(first)) == 0);
+    }
+
+    return thermo_test_result("test_pec");
+}
@@ -0,0 +1,175 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/* ThermoReplayDevice on ThermoAcquisition
+ *
+ * Paced, the frames of a log come at their recorded intervals, a pause
+ * longer than THERMO_REPLAY_MAX_GAP_MS restarts the clock; unpaced, they
+ * come at the acquisition period. A log which is not there fails the setup,
+ * the sensor is not ready and counts errors until the log appears.
+ */
+
+#include <unistd.h>
+#include "mbed.h"
+#include "ThermoAcquisition.h"
+#include "ThermoLog.h"
+#include "ThermoReplayDevice.h"
+#include "thermo_test.h"
+
+#define FRAME_NUM       (6)
+#define LATE_MS         (40)    // scheduling of the host threads, also on a loaded machine
+
+static const uint32_t recorded_ms[FRAME_NUM] = {1000, 1100, 1150, 1400, 5000, 5050};
+
+static uint8_t write_chunk[THERMO_LOG_CHUNK_SIZE];
+static uint8_t paced_chunk[THERMO_LOG_CHUNK_SIZE];
+static uint8_t fast_chunk[THERMO_LOG_CHUNK_SIZE];
+static uint8_t late_chunk[THERMO_LOG_CHUNK_SIZE];
+static char log_path[64];
+static char late_path[64];
+
+static void write_log(const char* p_path)
+{
+    ThermoLogWriter log(write_chunk);
+    ThermoFrame frame = {};
+    int i;
+
+    TEST_CHECK(log.open(p_path));
+    for (i = 0; i < FRAME_NUM; i++) {
+        frame.timestamp_ms = recorded_ms[i];
+        frame.sequence = i + 1;
+        frame.ptat = (int16_t)(250 + i);
+        frame.pixel[0] = (int16_t)(300 + i);
+        TEST_CHECK(log.append(frame));
+    }
+    log.close();
+}
+
+/* frames of one pass over the log, @return arrival times */
+static void collect(ThermoAcquisition& acquisition, uint16_t id, uint32_t* p_arrival_ms)
+{
+    ThermoFrame frame;
+    uint32_t cursor = 0;
+    uint64_t start = Kernel::get_ms_count();
+    int count = 0;
+
+    while ((count < FRAME_NUM) && ((Kernel::get_ms_count() - start) < 3000)) {
+        if (acquisition.read(id, cursor, frame)) {
+            TEST_CHECK_EQ(frame.ptat, 250 + count);
+            TEST_CHECK_EQ(frame.pixel[0], 300 + count);
+            p_arrival_ms[count] = frame.timestamp_ms;
+            count++;
+        }
+        ThisThread::sleep_for(1);
+    }
+    TEST_CHECK_EQ(count, FRAME_NUM);
+}
+
+int main(void)
+{
+    ThermoLogReader paced_log(paced_chunk);
+    ThermoLogReader fast_log(fast_chunk);
+    ThermoLogReader late_log(late_chunk);
+    ThermoReplayDevice paced(paced_log, log_path, false, true);
+    ThermoReplayDevice fast(fast_log, log_path, false, false);
+    ThermoReplayDevice late(late_log, late_path, false, true);
+    ThermoAcquisition paced_bus(1, osPriorityNormal, THERMO_REPLAY_STACK);
+    ThermoAcquisition fast_bus(20, osPriorityNormal, THERMO_REPLAY_STACK);
+    ThermoAcquisition late_bus(10, osPriorityNormal, THERMO_REPLAY_STACK);
+    uint32_t arrival_ms[FRAME_NUM];
+    uint32_t interval;
+    uint32_t expected;
+    uint32_t due;
+    int clock;
+    uint32_t errors;
+    ThermoFrame frame;
+    uint64_t start;
+    int i;
+    int result;
+
+    snprintf(log_path, sizeof(log_path), "/tmp/test_replay_%d.log", (int)getpid());
+    snprintf(late_path, sizeof(late_path), "/tmp/test_replay_late_%d.log", (int)getpid());
+    unlink(late_path);
+    write_log(log_path);
+
+    // at the recorded intervals, the pause of 3.6s is skipped; a late frame shortens the next
+    // interval, so the earliest time is checked against the clock of the replay
+    paced_bus.add(paced, 0);
+    paced_bus.start();
+    collect(paced_bus, 0, arrival_ms);
+    TEST_CHECK(paced_bus.ready(0));
+    clock = 0;
+    due = 0;
+    for (i = 1; i < FRAME_NUM; i++) {
+        interval = arrival_ms[i] - arrival_ms[i - 1];
+        expected = recorded_ms[i] - recorded_ms[i - 1];
+        expected = (expected > THERMO_REPLAY_MAX_GAP_MS) ? 0 : expected;
+        printf("paced interval %d: %lu ms, recorded %lu ms\n", i, (unsigned long)interval, (unsigned long)expected);
+        if (expected == 0) {
+            clock = i;
+            due = 0;
+        } else {
+            due += expected;
+        }
+        TEST_CHECK((arrival_ms[i] - arrival_ms[clock] + 1) >= due);
+        TEST_CHECK(interval <= (expected + LATE_MS));
+    }
+
+    // at the acquisition period, also checked from the first frame
+    fast_bus.add(fast, 0);
+    fast_bus.start();
+    collect(fast_bus, 0, arrival_ms);
+    for (i = 1; i < FRAME_NUM; i++) {
+        interval = arrival_ms[i] - arrival_ms[i - 1];
+        TEST_CHECK((arrival_ms[i] - arrival_ms[0] + 1) >= (uint32_t)(20 * i));
+        TEST_CHECK(interval <= (20 + LATE_MS));
+    }
+
+    // a missing log: not ready, errors every period, until it is written
+    late_bus.add(late, 0);
+    late_bus.start();
+    ThisThread::sleep_for(300);
+    errors = late_bus.errors(0);
+    TEST_CHECK(!late_bus.ready(0));
+    TEST_CHECK(errors >= 5);
+    TEST_CHECK(!late_bus.latest(0, frame));
+    write_log(late_path);
+    start = Kernel::get_ms_count();
+    while (!late_bus.latest(0, frame) && ((Kernel::get_ms_count() - start) < 1000)) {
+        ThisThread::sleep_for(5);
+    }
+    TEST_CHECK(late_bus.ready(0));
+    TEST_CHECK(late_bus.latest(0, frame));
+    TEST_CHECK_EQ(frame.ptat, 250);
+
+    unlink(log_path);
+    unlink(late_path);
+
+    result = thermo_test_result("test_replay");
+
+    // the acquisition threads never end, leave without running the destructors
+    fflush(stdout);
+    _exit(result);
+}
@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/* ThermoResampler against the float path of ThermoReference.cpp
+ *
+ * The linear mode has to match liner_interpolation() within the Q15
+ * rounding at every grid size of main.cpp, for the 4*4 and the 32*32
+ * sensor grid. The cubic mode has to go through the source samples.
+ */
+
+#include <math.h>
+#include <vector>
+#include "ThermoReference.h"
+#include "ThermoResampler.h"
+#include "thermo_test.h"
+
+/* largest difference of a linear output from the float path (0.0 - 1.0):
+   the rounding of the source to Q15 and of the blend */
+#define LINEAR_TOLERANCE    (2.0 / THERMO_Q15_ONE)
+
+static uint32_t seed = 1;
+
+static uint16_t random_q15(void)
+{
+    seed = (seed * 1103515245u) + 12345u;
+    return (uint16_t)((seed >> 8) % (THERMO_Q15_ONE + 1));
+}
+
+template <int IN_W, int IN_H, int OUT_W, int OUT_H>
+static void check_size(void)
+{
+    static constexpr ThermoResampleTable<IN_W, IN_H, OUT_W, OUT_H> table{};
+    static constexpr ThermoCubicTable<IN_W, IN_H, OUT_W, OUT_H> cubic{};
+    const ThermoResampler resampler(table, cubic);
+    std::vector<uint16_t> src(IN_W * IN_H);
+    std::vector<float> src_float(IN_W * IN_H);
+    std::vector<uint16_t> out(OUT_W * OUT_H);
+    std::vector<float> out_float(OUT_W * OUT_H);
+    std::vector<uint16_t> rows(IN_H * OUT_W);
+    double worst = 0;
+    int pass;
+    int x;
+    int y;
+    int i;
+
+    for (pass = 0; pass < 4; pass++) {
+        for (i = 0; i < (IN_W * IN_H); i++) {
+            // a flat, a full-scale and two random fields
+            src[i] = (pass == 0) ? (THERMO_Q15_ONE / 3) : ((pass == 1) ? (uint16_t)((i & 1) * THERMO_Q15_ONE) : random_q15());
+            src_float[i] = (float)src[i] / (float)THERMO_Q15_ONE;
+        }
+        resampler.resample(&src[0], &out[0], &rows[0], THERMO_RESAMPLE_LINEAR);
+        liner_interpolation(&src_float[0], &out_float[0], IN_W, IN_H, OUT_W, OUT_H);
+        for (i = 0; i < (OUT_W * OUT_H); i++) {
+            double error = fabs(((double)out[i] / THERMO_Q15_ONE) - (double)out_float[i]);
+
+            worst = (error > worst) ? error : worst;
+        }
+
+        // the spline goes through the samples: rows and columns of a knot are the source
+        resampler.resample(&src[0], &out[0], &rows[0], THERMO_RESAMPLE_CUBIC);
+        for (y = 0; y < IN_H; y++) {
+            for (x = 0; x < IN_W; x++) {
+                int out_x = ((OUT_W - 1) * x) / (IN_W - 1);
+                int out_y = ((OUT_H - 1) * y) / (IN_H - 1);
+
+                TEST_CHECK_EQ(out[(OUT_W * out_y) + out_x], src[(IN_W * y) + x]);
+            }
+        }
+    }
+    printf("%2dx%-2d -> %3dx%-3d: max error %.7f (tolerance %.7f)\n", IN_W, IN_H, OUT_W, OUT_H, worst, LINEAR_TOLERANCE);
+    TEST_CHECK(worst <= LINEAR_TOLERANCE);
+}
+
+int main(void)
+{
+    check_size<4, 4, 4, 4>();
+    check_size<4, 4, 8, 8>();
+    check_size<4, 4, 16, 16>();
+    check_size<4, 4, 32, 32>();
+    check_size<4, 4, 64, 60>();
+    check_size<4, 4, 160, 120>();
+    check_size<4, 4, 320, 240>();
+    check_size<32, 32, 64, 60>();
+    check_size<32, 32, 160, 120>();
+    return thermo_test_result("test_resampler");
+}
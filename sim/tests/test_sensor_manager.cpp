@@ -0,0 +1,222 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/* ThermoSensorManager with several buses and an I2C mux
+ *
+ * Bus A has two sensors of the same address behind a mux (channels 0 and
+ * 2), bus B one sensor of its own. Every sensor sees its own scene, so
+ * the pixels of a frame tell which sensor was read: each ID must only get
+ * the frames of its sensor, in order, so the mux was switched before each
+ * reading. Both buses together must read more frames than one bus can
+ * carry, so they run at the same time.
+ */
+
+#include <unistd.h>
+#include "mbed.h"
+#include "D6T_44L_06.h"
+#include "ThermoAcquisition.h"
+#include "ThermoD6TDevice.h"
+#include "ThermoI2cMux.h"
+#include "ThermoSensorManager.h"
+#include "SimD6T.h"
+#include "SimI2cBus.h"
+#include "SimScene.h"
+#include "thermo_test.h"
+
+#define LATENCY_US      (5000)      // per phase: a reading takes 10ms plus the bus time
+#define RUN_MS          (1000)
+#define SENSOR_NUM      (3)
+#define FREQUENCY       (400000)
+
+/* bus time of a reading of the frame model [ms], data included */
+#define READING_MS      (((LATENCY_US * 2) + D6T_READ_TIME_US(ThermoSensorModel::N_READ, FREQUENCY)) / 1000)
+
+/* frames every sensor gets at least: two sensors share bus A, with room for the host threads */
+#define MIN_FRAMES      (((RUN_MS / (4 * READING_MS)) < 10) ? (RUN_MS / (4 * READING_MS)) : 10)
+
+/* PCA9548A type mux: one control byte, the D6T address goes to the connected channel */
+class SimMux
+{
+public:
+    SimMux() : mControl(*this), mDevice(*this), mCtrl(0), mSwitches(0), mBadReads(0)
+    {
+        memset(mChannel, 0, sizeof(mChannel));
+    }
+
+    void connect(int channel, SimI2cSlave& slave) { mChannel[channel] = &slave; }
+    SimI2cSlave& control(void) { return mControl; }
+    SimI2cSlave& device(void) { return mDevice; }
+    uint32_t switches(void) const { return mSwitches; }
+    uint32_t bad_reads(void) const { return mBadReads; }
+
+private:
+    class Control : public SimI2cSlave
+    {
+    public:
+        Control(SimMux& mux) : mMux(mux) {}
+        virtual int write(const uint8_t* p_data, int len)
+        {
+            mMux.mCtrl = p_data[0];
+            mMux.mSwitches++;
+            return 0;
+        }
+        virtual int read(uint8_t* p_data, int len)
+        {
+            p_data[0] = mMux.mCtrl;
+            return 0;
+        }
+
+    private:
+        SimMux& mMux;
+    };
+
+    class Device : public SimI2cSlave
+    {
+    public:
+        Device(SimMux& mux) : mMux(mux) {}
+        virtual int write(const uint8_t* p_data, int len)
+        {
+            SimI2cSlave* p_slave = mMux.connected();
+            return (p_slave == NULL) ? -1 : p_slave->write(p_data, len);
+        }
+        virtual int read(uint8_t* p_data, int len)
+        {
+            SimI2cSlave* p_slave = mMux.connected();
+            return (p_slave == NULL) ? -1 : p_slave->read(p_data, len);
+        }
+
+    private:
+        SimMux& mMux;
+    };
+
+    Control mControl;
+    Device mDevice;
+    SimI2cSlave* mChannel[8];
+    volatile uint8_t mCtrl;
+    volatile uint32_t mSwitches;
+    volatile uint32_t mBadReads;
+
+    SimI2cSlave* connected(void)
+    {
+        int channel;
+
+        // exactly one channel must be connected
+        for (channel = 0; channel < 8; channel++) {
+            if (mCtrl == (1 << channel)) {
+                return mChannel[channel];
+            }
+        }
+        mBadReads++;
+        return NULL;
+    }
+};
+
+static const uint16_t sensor_id[SENSOR_NUM] = {10, 12, 20};
+
+static SimSyntheticScene scene[SENSOR_NUM] = {SimSyntheticScene(1, 40), SimSyntheticScene(2, 50), SimSyntheticScene(3, 60)};
+static SimSyntheticScene expected_scene[SENSOR_NUM] = {SimSyntheticScene(1, 40), SimSyntheticScene(2, 50), SimSyntheticScene(3, 60)};
+static SimD6T sim_d6t[SENSOR_NUM] = {SimD6T(scene[0]), SimD6T(scene[1]), SimD6T(scene[2])};
+static SimMux sim_mux;
+
+static SimI2cBus bus_a(LATENCY_US);
+static SimI2cBus bus_b(LATENCY_US);
+static ThermoI2cMux mux(bus_a);
+static D6T<ThermoSensorModel> d6t_a0(bus_a);
+static D6T<ThermoSensorModel> d6t_a2(bus_a);
+static D6T<ThermoSensorModel> d6t_b(bus_b);
+static ThermoD6TDevice device_a0(d6t_a0, &mux, 0);
+static ThermoD6TDevice device_a2(d6t_a2, &mux, 2);
+static ThermoD6TDevice device_b(d6t_b);
+static ThermoAcquisition acquisition_a(1, osPriorityNormal);
+static ThermoAcquisition acquisition_b(1, osPriorityNormal);
+static ThermoSensorManager sensors;
+
+int main(void)
+{
+    ThermoFrame frame;
+    uint32_t cursor[SENSOR_NUM] = {0, 0, 0};
+    uint32_t frames[SENSOR_NUM] = {0, 0, 0};
+    uint32_t bus_ms;
+    int16_t ptat;
+    int16_t pixel[THERMO_FRAME_PIXEL];
+    uint64_t start;
+    int i;
+    int result;
+
+    sim_mux.connect(0, sim_d6t[0]);
+    sim_mux.connect(2, sim_d6t[1]);
+    bus_a.frequency(FREQUENCY);
+    bus_b.frequency(FREQUENCY);
+    bus_a.attach(THERMO_I2C_MUX_ADDR, sim_mux.control());
+    bus_a.attach(D6T_ADDR, sim_mux.device());
+    bus_b.attach(D6T_ADDR, sim_d6t[2]);
+
+    TEST_CHECK(acquisition_a.add(device_a0, sensor_id[0]));
+    TEST_CHECK(acquisition_a.add(device_a2, sensor_id[1]));
+    TEST_CHECK(acquisition_b.add(device_b, sensor_id[2]));
+    TEST_CHECK(sensors.add(acquisition_a));
+    TEST_CHECK(sensors.add(acquisition_b));
+    sensors.start();
+
+    start = Kernel::get_ms_count();
+    while ((Kernel::get_ms_count() - start) < RUN_MS) {
+        for (i = 0; i < SENSOR_NUM; i++) {
+            while (sensors.read(sensor_id[i], cursor[i], frame)) {
+                frames[i]++;
+                TEST_CHECK_EQ(frame.sensor_id, sensor_id[i]);
+                TEST_CHECK_EQ(frame.sequence, frames[i]);
+                // the frame is the next one of this sensor's scene, not of another channel
+                expected_scene[i].next(&ptat, pixel, THERMO_FRAME_ROWS, THERMO_FRAME_COLS);
+                TEST_CHECK_EQ(frame.ptat, ptat);
+                TEST_CHECK(memcmp(frame.pixel, pixel, sizeof(pixel)) == 0);
+            }
+        }
+        ThisThread::sleep_for(2);
+    }
+
+    printf("frames %lu/%lu on bus A, %lu on bus B, %lu mux switches\n", (unsigned long)frames[0],
+           (unsigned long)frames[1], (unsigned long)frames[2], (unsigned long)sim_mux.switches());
+    for (i = 0; i < SENSOR_NUM; i++) {
+        TEST_CHECK(frames[i] >= MIN_FRAMES);
+        TEST_CHECK_EQ(sensors.errors(sensor_id[i]), 0);
+    }
+    TEST_CHECK(!sensors.latest(99, frame));
+
+    // the two sensors of bus A take turns: one mux write per reading, plus one per setup() and the reading in progress
+    TEST_CHECK_EQ(sim_mux.bad_reads(), 0);
+    TEST_CHECK(sim_mux.switches() >= (frames[0] + frames[1]));
+    TEST_CHECK(sim_mux.switches() <= (sim_d6t[0].frames() + sim_d6t[1].frames() + 3));
+
+    // the bus time of all transfers is clearly more than the run time: the buses overlapped
+    bus_ms = ((frames[0] + frames[1] + frames[2]) * READING_MS) + (sim_mux.switches() * LATENCY_US / 1000);
+    printf("%lu ms of bus time in %d ms\n", (unsigned long)bus_ms, RUN_MS);
+    TEST_CHECK(bus_ms > (RUN_MS * 5 / 4));
+
+    result = thermo_test_result("test_sensor_manager");
+
+    // the acquisition threads never end, leave without running the destructors
+    fflush(stdout);
+    _exit(result);
+}
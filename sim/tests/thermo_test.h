@@ -0,0 +1,83 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef THERMO_TEST_H
+#define THERMO_TEST_H
+
+/* Checks of the host tests (ctest in the sim build)
+ *
+ * A failed check prints its location and the values, the test goes on and
+ * thermo_test_result() returns 1 at the end.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static inline int& thermo_test_failures(void)
+{
+    static int failures = 0;
+    return failures;
+}
+
+#define TEST_CHECK(expr) \
+    do { \
+        if (!(expr)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); \
+            thermo_test_failures()++; \
+        } \
+    } while (0)
+
+#define TEST_CHECK_EQ(actual, expected) \
+    do { \
+        long long test_a = (long long)(actual); \
+        long long test_e = (long long)(expected); \
+        if (test_a != test_e) { \
+            printf("%s:%d: %s is %lld, expected %lld\n", __FILE__, __LINE__, #actual, test_a, test_e); \
+            thermo_test_failures()++; \
+        } \
+    } while (0)
+
+#define TEST_CHECK_NEAR(actual, expected, tolerance) \
+    do { \
+        double test_a = (double)(actual); \
+        double test_e = (double)(expected); \
+        if (!(((test_a - test_e) <= (tolerance)) && ((test_e - test_a) <= (tolerance)))) { \
+            printf("%s:%d: %s is %g, expected %g +- %g\n", __FILE__, __LINE__, #actual, test_a, test_e, (double)(tolerance)); \
+            thermo_test_failures()++; \
+        } \
+    } while (0)
+
+/* Summary line of a test, @return exit code */
+static inline int thermo_test_result(const char* p_name)
+{
+    if (thermo_test_failures() != 0) {
+        printf("%s: %d checks failed\n", p_name, thermo_test_failures());
+        return 1;
+    }
+    printf("%s: passed\n", p_name);
+    return 0;
+}
+
+#endif
@@ -0,0 +1,1207 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/* Frame pipeline benchmark
+ *
+ * Times every stage of a display frame (I2C read, PEC, decoding, both render
+ * paths, tile drawing, cache clean, the console dump and its telemetry
+ * packet) for each resolution
+ * and alpha of the phase sequence of main(), and writes the results as JSON:
+ * min, median and p99 time and cycles per output pixel of every stage.
+ * The registration map and the fused image of the console export of main()
+ * are timed once, at 160*120 and for the whole camera image. The upscaling
+ * modes are timed at 160*120 and 320*240 against a known temperature field,
+ * with the RMSE and the largest error of each in degree C. The temporal
+ * filters run over a noisy sequence with spikes and a step of a known scene,
+ * with their error against it and the share of pixels reported as changed.
+ * The incremental redraw runs over a scene with a moving hot spot and a
+ * little noise, with the share of the grid redrawn and the share of the
+ * display which differs from redrawing every tile. The frame statistics are
+ * checked against sorting the pixels, and the fixed and the auto color range
+ * render the scene with the share of saturated pixels and of range changes.
+ *
+ *   thermo_bench [--iterations N] [--i2c-iterations N] [--frequency HZ]
+ *                [--cpu-mhz MHZ] [--scene FILE] [--out FILE]
+ *
+ * --scene replays a recorded scene (frame log or the text format of
+ * thermo_sim) instead of the synthetic one, so the stages are timed on the
+ * data of a real sensor.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAS_TSC       (1)
+#else
+#define BENCH_HAS_TSC       (0)
+#endif
+#include "mbed.h"
+#include "D6T_44L_06.h"
+#include "D6T_Crc8.h"
+#include "ThermoAutoRange.h"
+#include "ThermoFrameHistogram.h"
+#include "ThermoReference.h"
+#include "ThermoRegistration.h"
+#include "ThermoFusion.h"
+#include "ThermoTelemetry.h"
+#include "ThermoFrameFilter.h"
+#include "SimD6T.h"
+#include "SimHal.h"
+#include "SimI2cBus.h"
+#include "SimRender.h"
+#include "SimScene.h"
+
+#define BENCH_SCENE_FRAMES  (64)    /* frames replayed in a loop, so the tiles change */
+#define BENCH_WARMUP        (8)
+#define BENCH_NO_ALPHA      (-1)
+#define BENCH_STR(x)        BENCH_STR2(x)
+#define BENCH_STR2(x)       #x
+
+/* phase sequence of main(): resolution and alpha of each phase, 0x0 is "off" */
+struct BenchCase {
+    int reso_x;
+    int reso_y;
+    int alpha;
+};
+
+static const BenchCase case_list[] = {
+    { SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW, SIM_ALPHA_MAX },
+    {   8,   8, SIM_ALPHA_MAX },
+    {  16,  16, SIM_ALPHA_MAX },
+    {  32,  32, SIM_ALPHA_MAX },
+    {  64,  60, SIM_ALPHA_MAX },
+    { 160, 120, SIM_ALPHA_MAX },
+    { 160, 120, SIM_ALPHA_SWITCH2 },
+    { 160, 120, SIM_ALPHA_SWITCH1 },
+    { 160, 120, SIM_ALPHA_DEFAULT },
+    {  64,  60, SIM_ALPHA_DEFAULT },
+    {  32,  32, SIM_ALPHA_DEFAULT },
+    {  16,  16, SIM_ALPHA_DEFAULT },
+    {   8,   8, SIM_ALPHA_DEFAULT },
+    { SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW, SIM_ALPHA_DEFAULT },
+    {   0,   0, BENCH_NO_ALPHA },
+};
+
+/** Samples of one stage */
+struct BenchSamples {
+    std::vector<uint64_t> ns;
+    std::vector<uint64_t> cycles;
+    uint64_t bytes;
+
+    void reset(int iterations)
+    {
+        ns.clear();
+        cycles.clear();
+        ns.reserve(iterations);
+        cycles.reserve(iterations);
+        bytes = 0;
+    }
+};
+
+/** Summary of one stage */
+struct BenchResult {
+    const char* stage;
+    int reso_x;
+    int reso_y;
+    int alpha;
+    uint32_t pixels;        // output pixels of the stage, the unit of cycles_per_pixel
+    int iterations;
+    double min_ns;
+    double median_ns;
+    double p99_ns;
+    double cycles_per_pixel;    // < 0: no cycle source
+    uint64_t bytes;         // mean bytes passed to the cache clean
+    double rmse;            // degree C against the true field, < 0: no quality
+    double max_error;
+    double changed;         // share of the pixels reported as changed, < 0: not a filter
+    double redrawn;         // share of the output grid redrawn, < 0: not a render stage
+    double mismatch;        // share of the display pixels unlike a full redraw, < 0: not compared
+    double saturated;       // share of the sensor pixels at or beyond the color range, < 0: no range
+    double range_changes;   // share of the frames which moved the color range
+};
+
+/** Wall time and cycle counter of one stage run */
+class BenchTimer
+{
+public:
+    void start(void)
+    {
+        mCycles = read_cycles();
+        mStart = std::chrono::steady_clock::now();
+    }
+
+    void stop(BenchSamples& samples)
+    {
+        auto end = std::chrono::steady_clock::now();
+        uint64_t cycles = read_cycles();
+
+        samples.ns.push_back((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(end - mStart).count());
+        samples.cycles.push_back(cycles - mCycles);
+    }
+
+private:
+    std::chrono::steady_clock::time_point mStart;
+    uint64_t mCycles;
+
+    static uint64_t read_cycles(void)
+    {
+#if BENCH_HAS_TSC
+        return __rdtsc();
+#else
+        return 0;
+#endif
+    }
+};
+
+/** Replays prepared sensor answers on a bus, so the driver runs without the scene */
+class BenchReplaySlave : public SimI2cSlave
+{
+public:
+    BenchReplaySlave() : mNext(0) {}
+
+    virtual int write(const uint8_t* p_data, int len) { return 0; }
+
+    virtual int read(uint8_t* p_data, int len)
+    {
+        memcpy(p_data, &raw_frame[mNext][0], len);
+        mNext = (mNext + 1) % BENCH_SCENE_FRAMES;
+        return 0;
+    }
+
+    static uint8_t raw_frame[BENCH_SCENE_FRAMES][ThermoSensorModel::N_READ];
+
+private:
+    int mNext;
+};
+
+uint8_t BenchReplaySlave::raw_frame[BENCH_SCENE_FRAMES][ThermoSensorModel::N_READ];
+
+struct Options {
+    int iterations;
+    int i2c_iterations;
+    int frequency;
+    double cpu_mhz;
+    const char* p_scene;
+    const char* p_out;
+};
+
+static Options opt;
+static std::vector<BenchResult> results;
+
+/* the display buffers are too large for the stack */
+static SimCache cache;
+static SimDisplay display;
+static SimDisplay grid_display(SIM_VIDEO_PIXEL_HW, SIM_VIDEO_PIXEL_VW, true);
+static SimRender renderer(cache, display);
+
+/* every tile of every frame, the reference of the incremental redraw */
+static SimCache full_cache;
+static SimDisplay full_display;
+static SimRender full_renderer(full_cache, full_display);
+
+static int16_t  scene_ptat[BENCH_SCENE_FRAMES];
+static int16_t  scene_pixel[BENCH_SCENE_FRAMES][THERMO_FRAME_PIXEL];
+static uint16_t color_grid[SIM_RESO_MAX_VW][SIM_RESO_MAX_HW];
+static constexpr D6T_Crc8Table crc8_table{};
+static uint8_t  camera_yuv[SIM_VIDEO_PIXEL_VW][SIM_VIDEO_PIXEL_HW * 2];
+static uint16_t registration_map[THERMO_REG_MAP_SIZE(SIM_VIDEO_PIXEL_HW, SIM_VIDEO_PIXEL_VW)];
+static uint8_t  fused_row[THERMO_BMP_ROW_SIZE(SIM_VIDEO_PIXEL_HW)];
+static uint8_t  telemetry_packet[THERMO_TELEMETRY_MAX_PACKET];
+static uint16_t upscale_src[SIM_SENSOR_RESO_VW][SIM_SENSOR_RESO_HW];
+static uint16_t upscale_rows[SIM_SENSOR_RESO_VW * 320];
+static uint16_t upscale_out[240 * 320];
+
+static constexpr ThermoResampleTable<SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW, 160, 120> upscale_table160x120{};
+static constexpr ThermoResampleTable<SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW, 320, 240> upscale_table320x240{};
+static constexpr ThermoCubicTable<SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW, 160, 120>    upscale_cubic160x120{};
+static constexpr ThermoCubicTable<SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW, 320, 240>    upscale_cubic320x240{};
+
+static double percentile(const std::vector<uint64_t>& sorted, int permille)
+{
+    size_t index = (sorted.size() * permille) / 1000;
+
+    if (index >= sorted.size()) {
+        index = sorted.size() - 1;
+    }
+    return (double)sorted[index];
+}
+
+static void add_result(const char* stage, int reso_x, int reso_y, int alpha, uint32_t pixels, BenchSamples& samples)
+{
+    BenchResult result;
+    std::vector<uint64_t> ns(samples.ns);
+    std::vector<uint64_t> cycles(samples.cycles);
+
+    if (ns.empty()) {
+        return;
+    }
+    std::sort(ns.begin(), ns.end());
+    std::sort(cycles.begin(), cycles.end());
+
+    result.stage      = stage;
+    result.reso_x     = reso_x;
+    result.reso_y     = reso_y;
+    result.alpha      = alpha;
+    result.pixels     = pixels;
+    result.iterations = (int)ns.size();
+    result.min_ns     = (double)ns[0];
+    result.median_ns  = percentile(ns, 500);
+    result.p99_ns     = percentile(ns, 990);
+    result.bytes      = samples.bytes / ns.size();
+    result.rmse       = -1;
+    result.max_error  = -1;
+    result.changed    = -1;
+    result.redrawn    = -1;
+    result.mismatch   = -1;
+    result.saturated  = -1;
+    result.range_changes = -1;
+    if (BENCH_HAS_TSC) {
+        result.cycles_per_pixel = percentile(cycles, 500) / pixels;
+    } else if (opt.cpu_mhz > 0) {
+        result.cycles_per_pixel = (result.median_ns * opt.cpu_mhz / 1000.0) / pixels;
+    } else {
+        result.cycles_per_pixel = -1;
+    }
+    results.push_back(result);
+}
+
+/* share of the output grid redrawn since the stats of the renderer were reset, into the last result */
+static void add_redrawn(void)
+{
+    const ThermoRedrawStats& region = renderer.redraw().stats();
+
+    results.back().redrawn = (region.total != 0) ? ((double)region.points / (double)region.total) : 0.0;
+}
+
+/* sensor frames of the synthetic or --scene scene, raw (with PEC) and decoded */
+static bool prepare_scene(void)
+{
+    SimSyntheticScene synthetic(1, BENCH_SCENE_FRAMES);
+    SimRecordedScene recorded;
+    const uint8_t cmd = ThermoSensorModel::CMD;
+    int i;
+    int j;
+
+    // a recording of less than BENCH_SCENE_FRAMES frames is repeated
+    if ((opt.p_scene != NULL) && (recorded.load(opt.p_scene, THERMO_FRAME_PIXEL) == 0)) {
+        fprintf(stderr, "%s: no %dx%d frame\n", opt.p_scene, SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW);
+        return false;
+    }
+    SimD6T sim_d6t((opt.p_scene != NULL) ? (SimScene&)recorded : (SimScene&)synthetic);
+
+    for (i = 0; i < BENCH_SCENE_FRAMES; i++) {
+        uint8_t* p_raw = &BenchReplaySlave::raw_frame[i][0];
+
+        sim_d6t.write(&cmd, 1);
+        sim_d6t.read(p_raw, ThermoSensorModel::N_READ);
+        scene_ptat[i] = (int16_t)(p_raw[0] | (p_raw[1] << 8));
+        for (j = 0; j < THERMO_FRAME_PIXEL; j++) {
+            scene_pixel[i][j] = (int16_t)(p_raw[2 + (j * 2)] | (p_raw[3 + (j * 2)] << 8));
+        }
+    }
+    return true;
+}
+
+/* I2C read, PEC check, decoding and the console dump: once per sensor frame */
+static void bench_sensor(void)
+{
+    BenchSamples samples;
+    BenchTimer timer;
+    int16_t ptat;
+    int16_t pixel[THERMO_FRAME_PIXEL];
+    int i;
+    int n;
+
+    // driver on a bus with the bus time of the set frequency
+    {
+        SimSyntheticScene scene;
+        SimD6T sim_d6t(scene);
+        SimI2cBus bus;
+        D6T<ThermoSensorModel> d6t(bus);
+
+        bus.frequency(opt.frequency);
+        bus.attach(D6T_ADDR, sim_d6t);
+        samples.reset(opt.i2c_iterations);
+        for (i = 0; i < opt.i2c_iterations; i++) {
+            timer.start();
+            d6t.read(&ptat, &pixel[0]);
+            timer.stop(samples);
+        }
+        add_result("i2c_read", SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW, BENCH_NO_ALPHA, THERMO_FRAME_PIXEL, samples);
+    }
+
+    // driver only: the bus takes no time and replays prepared answers
+    {
+        BenchReplaySlave slave;
+        SimI2cBus bus;
+        D6T<ThermoSensorModel> d6t(bus);
+
+        bus.frequency(0x7FFFFFFF);
+        bus.attach(D6T_ADDR, slave);
+        samples.reset(opt.iterations);
+        for (i = 0; i < (BENCH_WARMUP + opt.iterations); i++) {
+            timer.start();
+            bool ok = d6t.read(&ptat, &pixel[0]);
+            if (i >= BENCH_WARMUP) {
+                timer.stop(samples);
+            }
+            MBED_ASSERT(ok);
+            (void)ok;
+        }
+        add_result("d6t_read_decode", SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW, BENCH_NO_ALPHA, THERMO_FRAME_PIXEL, samples);
+    }
+
+    // PEC of a whole answer, the loop of D6T_checkPEC
+    samples.reset(opt.iterations);
+    for (i = 0; i < (BENCH_WARMUP + opt.iterations); i++) {
+        const uint8_t* p_raw = &BenchReplaySlave::raw_frame[i % BENCH_SCENE_FRAMES][0];
+        volatile uint8_t sink;
+        uint8_t crc = 0;
+
+        timer.start();
+        for (n = 0; n < (ThermoSensorModel::N_READ - 1); n++) {
+            crc = crc8_table.crc[p_raw[n] ^ crc];
+        }
+        sink = crc;
+        if (i >= BENCH_WARMUP) {
+            timer.stop(samples);
+        }
+        (void)sink;
+    }
+    add_result("pec", SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW, BENCH_NO_ALPHA, THERMO_FRAME_PIXEL, samples);
+
+    // the same PEC by the bit loop of the former calc_crc
+    samples.reset(opt.iterations);
+    for (i = 0; i < (BENCH_WARMUP + opt.iterations); i++) {
+        const uint8_t* p_raw = &BenchReplaySlave::raw_frame[i % BENCH_SCENE_FRAMES][0];
+        volatile uint8_t sink;
+        uint8_t crc = 0;
+
+        timer.start();
+        for (n = 0; n < (ThermoSensorModel::N_READ - 1); n++) {
+            crc = D6T_crc8_bitwise(p_raw[n] ^ crc);
+        }
+        sink = crc;
+        if (i >= BENCH_WARMUP) {
+            timer.stop(samples);
+        }
+        (void)sink;
+    }
+    add_result("pec_bitwise", SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW, BENCH_NO_ALPHA, THERMO_FRAME_PIXEL, samples);
+
+    // console dump of main(), formatted to /dev/null (the UART time is not included)
+    FILE* p_null = fopen("/dev/null", "w");
+    if (p_null != NULL) {
+        samples.reset(opt.iterations);
+        for (i = 0; i < (BENCH_WARMUP + opt.iterations); i++) {
+            int f = i % BENCH_SCENE_FRAMES;
+
+            timer.start();
+            fprintf(p_null, "\x1b[%d;%dH", 0, 0);
+            fprintf(p_null, "PTAT: %6.1f[degC]  sensor %u frame %6lu %10lu[ms]\r\n", scene_ptat[f] / 10.0,
+                    0u, (unsigned long)i, (unsigned long)(i * 100));
+            for (n = 0; n < THERMO_FRAME_PIXEL; n++) {
+                fprintf(p_null, "%4.1f, ", scene_pixel[f][n] / 10.0);
+                if ((n % SIM_SENSOR_RESO_HW) == SIM_SENSOR_RESO_HW - 1) {
+                    fprintf(p_null, "\r\n");
+                }
+            }
+            fprintf(p_null, "tiles: %5lu drawn %5lu skipped, cache clean: %7lu[byte]\r\n", 0ul, 0ul, 0ul);
+            fflush(p_null);
+            if (i >= BENCH_WARMUP) {
+                timer.stop(samples);
+            }
+        }
+        fclose(p_null);
+        add_result("console_dump", SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW, BENCH_NO_ALPHA, THERMO_FRAME_PIXEL, samples);
+    }
+
+    // telemetry packet of main() in place of the console dump, key and delta frames
+    ThermoTelemetryEncoder encoder(16, true);
+    ThermoFrame frame;
+
+    memset(&frame, 0, sizeof(frame));
+    samples.reset(opt.iterations);
+    for (i = 0; i < (BENCH_WARMUP + opt.iterations); i++) {
+        int f = i % BENCH_SCENE_FRAMES;
+
+        frame.sequence = i;
+        frame.ptat = scene_ptat[f];
+        memcpy(frame.pixel, scene_pixel[f], sizeof(frame.pixel));
+        timer.start();
+        encoder.encode(frame, telemetry_packet);
+        if (i >= BENCH_WARMUP) {
+            timer.stop(samples);
+        }
+    }
+    add_result("telemetry_encode", SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW, BENCH_NO_ALPHA, THERMO_FRAME_PIXEL, samples);
+}
+
+/* registration map of a homography and the fused image, as export_fused() of main() */
+static void bench_fusion(void)
+{
+    static const float homography[9] = { 0.9f, 0.05f, 20.0f, -0.03f, 0.95f, 15.0f, 0.00005f, 0.00002f, 1.0f };
+    ThermoRegistration registration(registration_map, SIM_VIDEO_PIXEL_HW, SIM_VIDEO_PIXEL_VW);
+    ThermoFusion fusion(registration);
+    BenchSamples samples;
+    BenchTimer timer;
+    int i;
+    int y;
+
+    memset(camera_yuv, 0x80, sizeof(camera_yuv));
+    renderer.palette().set_alpha(SIM_ALPHA_SWITCH1);
+    renderer.kernel().begin(&scene_pixel[0][0], SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW,
+                            scene_ptat[0] - SIM_TEMP_MARGIN_UNDER, scene_ptat[0] + SIM_TEMP_MARGIN_UPPER,
+                            SimRender::find_resampler(SIM_RESO_MAX_HW, SIM_RESO_MAX_VW));
+    for (y = 0; y < SIM_RESO_MAX_VW; y++) {
+        renderer.kernel().color_row(y, &color_grid[y][0]);
+    }
+
+    // once per transform or grid size
+    samples.reset(opt.iterations);
+    for (i = 0; i < (BENCH_WARMUP + opt.iterations); i++) {
+        registration.set_transform(homography);
+        timer.start();
+        registration.build(SIM_RESO_MAX_HW, SIM_RESO_MAX_VW);
+        if (i >= BENCH_WARMUP) {
+            timer.stop(samples);
+        }
+    }
+    add_result("registration_build", SIM_RESO_MAX_HW, SIM_RESO_MAX_VW, SIM_ALPHA_SWITCH1,
+               THERMO_REG_MAP_SIZE(SIM_VIDEO_PIXEL_HW, SIM_VIDEO_PIXEL_VW), samples);
+
+    // per exported frame: map lookup, YCbCr to RGB and blend of every camera pixel
+    samples.reset(opt.iterations);
+    for (i = 0; i < (BENCH_WARMUP + opt.iterations); i++) {
+        timer.start();
+        for (y = 0; y < SIM_VIDEO_PIXEL_VW; y++) {
+            fusion.fuse_row(&camera_yuv[y][0], &color_grid[0][0], y, 1, fused_row);
+        }
+        if (i >= BENCH_WARMUP) {
+            timer.stop(samples);
+        }
+    }
+    add_result("fuse_image", SIM_RESO_MAX_HW, SIM_RESO_MAX_VW, SIM_ALPHA_SWITCH1,
+               SIM_VIDEO_PIXEL_HW * SIM_VIDEO_PIXEL_VW, samples);
+}
+
+/* true field in 0.1 degree C at 0.0-1.0 of the view: a smooth hot spot and a warm area with a hard edge */
+static double upscale_truth(double fx, double fy)
+{
+    double dx = fx - 0.6;
+    double dy = fy - 0.45;
+    double temp = 250.0 + (140.0 * exp(-((dx * dx) + (dy * dy)) / 0.04));
+
+    return (fx < (1.0 / 3.0)) ? (temp + 60.0) : temp;
+}
+
+/* position of sample pos of n on the 0.0-1.0 axis, as the knots of the resampler tables */
+static double upscale_pos(int pos, int n)
+{
+    return (n > 1) ? ((double)pos / (n - 1)) : 0.5;
+}
+
+/* resample() of every mode at one output size, and its error against the true field */
+static void bench_upscale_size(const ThermoResampler& resampler)
+{
+    static const struct {
+        const char* stage;
+        ThermoResampleMode mode;
+    } mode_list[] = {
+        { "upscale_linear", THERMO_RESAMPLE_LINEAR },
+        { "upscale_cubic",  THERMO_RESAMPLE_CUBIC  },
+        { "upscale_edge",   THERMO_RESAMPLE_EDGE   },
+    };
+    const int min = 230;
+    const int max = 400;
+    int out_w = resampler.out_width();
+    int out_h = resampler.out_height();
+    BenchSamples samples;
+    BenchTimer timer;
+    int i;
+    int x;
+    int y;
+
+    for (y = 0; y < SIM_SENSOR_RESO_VW; y++) {
+        for (x = 0; x < SIM_SENSOR_RESO_HW; x++) {
+            double temp = upscale_truth(upscale_pos(x, SIM_SENSOR_RESO_HW), upscale_pos(y, SIM_SENSOR_RESO_VW));
+            upscale_src[y][x] = thermo_normalize_q15((int16_t)lround(temp), min, max);
+        }
+    }
+
+    for (const auto& entry : mode_list) {
+        double sum = 0;
+        double worst = 0;
+
+        samples.reset(opt.iterations);
+        for (i = 0; i < (BENCH_WARMUP + opt.iterations); i++) {
+            timer.start();
+            resampler.resample(&upscale_src[0][0], upscale_out, upscale_rows, entry.mode);
+            if (i >= BENCH_WARMUP) {
+                timer.stop(samples);
+            }
+        }
+        add_result(entry.stage, out_w, out_h, BENCH_NO_ALPHA, out_w * out_h, samples);
+
+        for (y = 0; y < out_h; y++) {
+            for (x = 0; x < out_w; x++) {
+                double truth = upscale_truth(upscale_pos(x, out_w), upscale_pos(y, out_h));
+                double temp = min + (((double)upscale_out[(out_w * y) + x] * (max - min)) / THERMO_Q15_ONE);
+                double error;
+
+                truth = std::min(std::max(truth, (double)min), (double)max);
+                error = fabs(temp - truth) / 10.0;
+                sum += error * error;
+                worst = std::max(worst, error);
+            }
+        }
+        results.back().rmse      = sqrt(sum / (out_w * out_h));
+        results.back().max_error = worst;
+    }
+}
+
+static void bench_upscale(void)
+{
+    bench_upscale_size(ThermoResampler(upscale_table160x120, upscale_cubic160x120));
+    bench_upscale_size(ThermoResampler(upscale_table320x240, upscale_cubic320x240));
+}
+
+/* noisy sequence of the filter stages: [frame][ptat, pixels] and the scene without noise */
+#define FILTER_FRAMES       (256)
+#define FILTER_NOISE        (6)     // +- 0.6 degC
+#define FILTER_SPIKE        (200)   // single-frame spike of one pixel every 16 frames
+#define FILTER_STEP         (30)    // step of the right half at the middle of the sequence
+#define FILTER_WARMUP       (16)    // frames before the error is counted
+static int16_t filter_noisy[FILTER_FRAMES][1 + THERMO_FRAME_PIXEL];
+static int16_t filter_truth[FILTER_FRAMES][1 + THERMO_FRAME_PIXEL];
+
+static void prepare_filter(void)
+{
+    uint32_t seed = 1;
+    int f;
+    int i;
+
+    for (f = 0; f < FILTER_FRAMES; f++) {
+        for (i = 0; i <= THERMO_FRAME_PIXEL; i++) {
+            int x = (i == 0) ? 0 : ((i - 1) % SIM_SENSOR_RESO_HW);
+            int truth = (i == 0) ? 253 : (240 + (10 * x));
+
+            if ((i > 0) && (f >= (FILTER_FRAMES / 2)) && ((x * 2) >= SIM_SENSOR_RESO_HW)) {
+                truth += FILTER_STEP;
+            }
+            seed = (seed * 1103515245u) + 12345u;
+            filter_truth[f][i] = (int16_t)truth;
+            filter_noisy[f][i] = (int16_t)(truth + (int)((seed >> 16) % ((FILTER_NOISE * 2) + 1)) - FILTER_NOISE);
+        }
+        if ((f % 16) == 15) {
+            filter_noisy[f][1 + ((f / 16) % THERMO_FRAME_PIXEL)] += FILTER_SPIKE;
+        }
+    }
+}
+
+/* ThermoFrameFilter::apply() of each mode, its error against the scene and its share of changed pixels */
+static void bench_filter(void)
+{
+    static const struct {
+        const char* stage;
+        ThermoFilterMode mode;
+        int strength;
+        int deadband;
+    } filter_list[] = {
+        { "filter_off",      THERMO_FILTER_OFF,    0, 0 },
+        { "filter_deadband", THERMO_FILTER_OFF,    0, 2 },
+        { "filter_ema",      THERMO_FILTER_EMA,    2, 2 },
+        { "filter_median",   THERMO_FILTER_MEDIAN, 5, 2 },
+    };
+    static ThermoFrame frame;
+    BenchSamples samples;
+    BenchTimer timer;
+    int f;
+    int i;
+
+    prepare_filter();
+    for (const auto& entry : filter_list) {
+        static ThermoFrameFilter filter(THERMO_FILTER_OFF, 0, 0);
+        double sum = 0;
+        double worst = 0;
+        uint64_t changed = 0;
+        int count = 0;
+
+        filter = ThermoFrameFilter(entry.mode, entry.strength, entry.deadband);
+        samples.reset(opt.iterations);
+        for (f = 0; f < (BENCH_WARMUP + opt.iterations); f++) {
+            const int16_t* p_noisy = filter_noisy[f % FILTER_FRAMES];
+
+            frame.ptat = p_noisy[0];
+            memcpy(frame.pixel, &p_noisy[1], sizeof(frame.pixel));
+            timer.start();
+            filter.apply(frame);
+            if (f >= BENCH_WARMUP) {
+                timer.stop(samples);
+            }
+        }
+        add_result(entry.stage, SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW, BENCH_NO_ALPHA, THERMO_FRAME_PIXEL, samples);
+
+        // one pass over the sequence from a fresh history
+        filter.reset();
+        filter.reset_stats();
+        for (f = 0; f < FILTER_FRAMES; f++) {
+            frame.ptat = filter_noisy[f][0];
+            memcpy(frame.pixel, &filter_noisy[f][1], sizeof(frame.pixel));
+            filter.apply(frame);
+            if (f < FILTER_WARMUP) {
+                continue;
+            }
+            for (i = 0; i < THERMO_FRAME_PIXEL; i++) {
+                double error = fabs((double)(frame.pixel[i] - filter_truth[f][1 + i])) / 10.0;
+
+                sum += error * error;
+                worst = std::max(worst, error);
+                changed += thermo_frame_changed(frame, i) ? 1 : 0;
+            }
+            count++;
+        }
+        results.back().rmse      = sqrt(sum / ((double)count * THERMO_FRAME_PIXEL));
+        results.back().max_error = worst;
+        results.back().changed   = (double)changed / ((double)count * THERMO_FRAME_PIXEL);
+    }
+}
+
+/* scene of the redraw stages: a still frame with +-0.1 degC noise and a hot spot moving one pixel per frame */
+#define REDRAW_FRAMES       (64)
+#define REDRAW_HOTSPOT      (80)    // +8 degC
+static int16_t redraw_pixel[REDRAW_FRAMES][THERMO_FRAME_PIXEL];
+
+static void prepare_redraw(void)
+{
+    uint32_t seed = 7;
+    int f;
+    int i;
+
+    for (f = 0; f < REDRAW_FRAMES; f++) {
+        for (i = 0; i < THERMO_FRAME_PIXEL; i++) {
+            seed = (seed * 1103515245u) + 12345u;
+            redraw_pixel[f][i] = (int16_t)(scene_pixel[0][i] + (int)((seed >> 16) % 3) - 1);
+        }
+        redraw_pixel[f][f % THERMO_FRAME_PIXEL] += REDRAW_HOTSPOT;
+    }
+}
+
+/* update_thermograph() with the incremental redraw of each threshold, against a full redraw */
+static void bench_redraw(void)
+{
+    static const struct {
+        const char* stage;
+        int threshold;
+    } redraw_list[] = {
+        { "redraw_off",         -1 },
+        { "redraw_any_change",   0 },
+        { "redraw_threshold_2",  2 },
+    };
+    const int min = scene_ptat[0] - SIM_TEMP_MARGIN_UNDER;
+    const int max = scene_ptat[0] + SIM_TEMP_MARGIN_UPPER;
+    const size_t size = SIM_BUFFER_STRIDE * SIM_VIDEO_PIXEL_VW;
+    BenchSamples samples;
+    BenchTimer timer;
+    int i;
+
+    prepare_redraw();
+    full_renderer.set_redraw_threshold(-1);
+    for (const auto& entry : redraw_list) {
+        uint64_t differ = 0;
+
+        renderer.set_redraw_threshold(entry.threshold);
+        samples.reset(opt.iterations);
+        for (i = 0; i < (BENCH_WARMUP + opt.iterations); i++) {
+            const int16_t* p_raw = &redraw_pixel[i % REDRAW_FRAMES][0];
+            uint64_t before = cache.bytes();
+            bool measure = (i >= BENCH_WARMUP);
+            size_t j;
+
+            if (i == BENCH_WARMUP) {
+                renderer.redraw().reset_stats();
+            }
+            timer.start();
+            renderer.update(p_raw, SIM_RESO_MAX_HW, SIM_RESO_MAX_VW, SIM_ALPHA_MAX, min, max);
+            if (!measure) {
+                full_renderer.update(p_raw, SIM_RESO_MAX_HW, SIM_RESO_MAX_VW, SIM_ALPHA_MAX, min, max);
+                continue;
+            }
+            timer.stop(samples);
+            samples.bytes += cache.bytes() - before;
+
+            full_renderer.update(p_raw, SIM_RESO_MAX_HW, SIM_RESO_MAX_VW, SIM_ALPHA_MAX, min, max);
+            const uint16_t* p_shown = (const uint16_t*)display.buffer();
+            const uint16_t* p_full  = (const uint16_t*)full_display.buffer();
+            for (j = 0; j < (size / sizeof(uint16_t)); j++) {
+                differ += (p_shown[j] != p_full[j]) ? 1 : 0;
+            }
+        }
+        add_result(entry.stage, SIM_RESO_MAX_HW, SIM_RESO_MAX_VW, SIM_ALPHA_MAX,
+                   SIM_VIDEO_PIXEL_HW * SIM_VIDEO_PIXEL_VW, samples);
+
+        add_redrawn();
+        results.back().mismatch = (double)differ / ((double)opt.iterations * (size / sizeof(uint16_t)));
+    }
+    renderer.set_redraw_threshold(0);
+}
+
+/* ThermoFrameHistogram::measure() of the scene frames, the percentiles against sorting the pixels */
+static void bench_frame_stats(void)
+{
+    static ThermoFrameHistogram histogram;
+    ThermoFrameStats stats;
+    BenchSamples samples;
+    BenchTimer timer;
+    double sum = 0;
+    double worst = 0;
+    int f;
+
+    samples.reset(opt.iterations);
+    for (f = 0; f < (BENCH_WARMUP + opt.iterations); f++) {
+        timer.start();
+        histogram.measure(&scene_pixel[f % BENCH_SCENE_FRAMES][0], SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW, &stats);
+        if (f >= BENCH_WARMUP) {
+            timer.stop(samples);
+        }
+    }
+    add_result("frame_stats", SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW, BENCH_NO_ALPHA, THERMO_FRAME_PIXEL, samples);
+
+    // nearest rank below of the sorted pixels; min, max and the hot spot have to be exact
+    for (f = 0; f < BENCH_SCENE_FRAMES; f++) {
+        const int16_t* p_pixel = &scene_pixel[f][0];
+        std::vector<int16_t> sorted(p_pixel, p_pixel + THERMO_FRAME_PIXEL);
+        int hot;
+        double error;
+
+        histogram.measure(p_pixel, SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW, &stats);
+        hot = (stats.hot_y * SIM_SENSOR_RESO_HW) + stats.hot_x;
+        std::sort(sorted.begin(), sorted.end());
+        if ((stats.min != sorted.front()) || (stats.max != sorted.back()) || (p_pixel[hot] != stats.max)) {
+            worst = 1000;
+        }
+        error = fabs((double)(stats.low - sorted[((THERMO_FRAME_PIXEL - 1) * histogram.low()) / 100])) / 10.0;
+        sum += error * error;
+        worst = std::max(worst, error);
+        error = fabs((double)(stats.high - sorted[((THERMO_FRAME_PIXEL - 1) * histogram.high()) / 100])) / 10.0;
+        sum += error * error;
+        worst = std::max(worst, error);
+    }
+    results.back().rmse      = sqrt(sum / (BENCH_SCENE_FRAMES * 2));
+    results.back().max_error = worst;
+}
+
+/* update_thermograph() at 160*120 with the fixed and the auto color range */
+static void bench_range(void)
+{
+    static const struct {
+        const char* stage;
+        bool automatic;
+    } range_list[] = {
+        { "range_fixed", false },
+        { "range_auto",  true },
+    };
+    static ThermoFrameHistogram histogram;
+    BenchSamples samples;
+    BenchTimer timer;
+    int i;
+
+    for (const auto& entry : range_list) {
+        static ThermoAutoRange auto_range(3, 20);
+        ThermoFrameStats stats;
+        uint64_t saturated = 0;
+        int min = 0;
+        int max = 0;
+
+        auto_range = ThermoAutoRange(3, 20);
+        samples.reset(opt.iterations);
+        for (i = 0; i < (BENCH_WARMUP + opt.iterations); i++) {
+            int f = i % BENCH_SCENE_FRAMES;
+            const int16_t* p_raw = &scene_pixel[f][0];
+            int j;
+
+            if (i == BENCH_WARMUP) {
+                renderer.redraw().reset_stats();
+                auto_range.reset_stats();
+            }
+            uint64_t before = cache.bytes();
+
+            timer.start();
+            histogram.measure(p_raw, SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW, &stats);
+            if (entry.automatic) {
+                auto_range.update(stats);
+                min = auto_range.min();
+                max = auto_range.max();
+            } else {
+                min = scene_ptat[f] - SIM_TEMP_MARGIN_UNDER;
+                max = scene_ptat[f] + SIM_TEMP_MARGIN_UPPER;
+            }
+            renderer.palette().set_raw_range(max - min);
+            renderer.update(p_raw, SIM_RESO_MAX_HW, SIM_RESO_MAX_VW, SIM_ALPHA_MAX, min, max);
+            if (i < BENCH_WARMUP) {
+                continue;
+            }
+            timer.stop(samples);
+            samples.bytes += cache.bytes() - before;
+            for (j = 0; j < THERMO_FRAME_PIXEL; j++) {
+                saturated += ((p_raw[j] <= min) || (p_raw[j] >= max)) ? 1 : 0;
+            }
+        }
+        add_result(entry.stage, SIM_RESO_MAX_HW, SIM_RESO_MAX_VW, SIM_ALPHA_MAX,
+                   SIM_VIDEO_PIXEL_HW * SIM_VIDEO_PIXEL_VW, samples);
+
+        add_redrawn();
+        results.back().saturated = (double)saturated / ((double)opt.iterations * THERMO_FRAME_PIXEL);
+        results.back().range_changes = entry.automatic ? ((double)auto_range.stats().changes / opt.iterations) : 0.0;
+    }
+    renderer.palette().set_raw_range(SIM_TEMP_MARGIN_UNDER + SIM_TEMP_MARGIN_UPPER);
+}
+
+/* stages of the fixed-point path, then of the reference path, then both whole paths */
+static void bench_case(const BenchCase& bench)
+{
+    BenchSamples kernel_samples;
+    BenchSamples draw_samples;
+    BenchSamples clean_samples;
+    BenchSamples normalize_samples;
+    BenchSamples interpolate_samples;
+    BenchSamples color_samples;
+    BenchSamples samples;
+    BenchTimer timer;
+    int reso_x = bench.reso_x;
+    int reso_y = bench.reso_y;
+    uint32_t display_pixels = SIM_VIDEO_PIXEL_HW * SIM_VIDEO_PIXEL_VW;
+    int i;
+    int x;
+    int y;
+
+    if (bench.alpha == BENCH_NO_ALPHA) {
+        // clear_thermograph
+        samples.reset(opt.iterations);
+        for (i = 0; i < (BENCH_WARMUP + opt.iterations); i++) {
+            uint64_t before = cache.bytes();
+
+            timer.start();
+            renderer.clear();
+            if (i >= BENCH_WARMUP) {
+                timer.stop(samples);
+                samples.bytes += cache.bytes() - before;
+            }
+        }
+        add_result("clear_thermograph", 0, 0, BENCH_NO_ALPHA, display_pixels, samples);
+        return;
+    }
+
+    SimRender::clamp_reso(&reso_x, &reso_y);
+    uint32_t grid_pixels = reso_x * reso_y;
+    int tile_hw = SIM_VIDEO_PIXEL_HW / reso_x;
+    int tile_vw = SIM_VIDEO_PIXEL_VW / reso_y;
+    const ThermoResampler* p_resampler = SimRender::find_resampler(reso_x, reso_y);
+
+    // fixed-point path stage by stage
+    kernel_samples.reset(opt.iterations);
+    draw_samples.reset(opt.iterations);
+    clean_samples.reset(opt.iterations);
+    for (i = 0; i < (BENCH_WARMUP + opt.iterations); i++) {
+        int f = i % BENCH_SCENE_FRAMES;
+        ThermoBlitter& target = renderer.blitter();
+        bool measure = (i >= BENCH_WARMUP);
+
+        target.begin_frame();
+        timer.start();
+        renderer.palette().set_alpha((uint8_t)bench.alpha);
+        renderer.kernel().begin(&scene_pixel[f][0], SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW,
+                                scene_ptat[f] - SIM_TEMP_MARGIN_UNDER, scene_ptat[f] + SIM_TEMP_MARGIN_UPPER, p_resampler);
+        for (y = 0; y < reso_y; y++) {
+            renderer.kernel().color_row(y, &color_grid[y][0]);
+        }
+        if (measure) {
+            timer.stop(kernel_samples);
+        }
+
+        timer.start();
+        for (y = 0; y < reso_y; y++) {
+            target.draw_tile_row(y, &color_grid[y][0], reso_x, tile_hw, tile_vw);
+        }
+        if (measure) {
+            timer.stop(draw_samples);
+        }
+
+        renderer.title();
+        timer.start();
+        uint32_t cleaned = target.clean_dirty(renderer.cache());
+        if (measure) {
+            timer.stop(clean_samples);
+            clean_samples.bytes += cleaned;
+        }
+        renderer.swap();
+    }
+    add_result("kernel", reso_x, reso_y, bench.alpha, grid_pixels, kernel_samples);
+    add_result("draw_tile_row", reso_x, reso_y, bench.alpha, display_pixels, draw_samples);
+    add_result("dcache_clean", reso_x, reso_y, bench.alpha, display_pixels, clean_samples);
+
+    // reference path stage by stage
+    normalize_samples.reset(opt.iterations);
+    interpolate_samples.reset(opt.iterations);
+    color_samples.reset(opt.iterations);
+    bool expand = SimRender::has_reference_expand()
+               && ((reso_x != SIM_SENSOR_RESO_HW) || (reso_y != SIM_SENSOR_RESO_VW));
+    int ref_x = expand ? reso_x : SIM_SENSOR_RESO_HW;   // the reference path stays on a 1-row grid
+    int ref_y = expand ? reso_y : SIM_SENSOR_RESO_VW;
+    for (i = 0; i < (BENCH_WARMUP + opt.iterations); i++) {
+        int f = i % BENCH_SCENE_FRAMES;
+        int min = scene_ptat[f] - SIM_TEMP_MARGIN_UNDER;
+        int max = scene_ptat[f] + SIM_TEMP_MARGIN_UPPER;
+        float* p_sensor = renderer.array_sensor();
+        float* p_array = p_sensor;
+        bool measure = (i >= BENCH_WARMUP);
+
+        timer.start();
+        for (x = 0; x < THERMO_FRAME_PIXEL; x++) {
+            p_sensor[x] = normalize0to1(scene_pixel[f][x], min, max);
+        }
+        if (measure) {
+            timer.stop(normalize_samples);
+        }
+
+        if (expand) {
+            timer.start();
+            liner_interpolation(p_sensor, renderer.array_expand(), SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW, reso_x, reso_y);
+            if (measure) {
+                timer.stop(interpolate_samples);
+            }
+            p_array = renderer.array_expand();
+        }
+
+        timer.start();
+        for (y = 0; y < ref_y; y++) {
+            for (x = 0; x < ref_x; x++) {
+                color_grid[y][x] = conv_normalize_to_color((uint8_t)bench.alpha, p_array[(y * ref_x) + x]);
+            }
+        }
+        if (measure) {
+            timer.stop(color_samples);
+        }
+    }
+    add_result("normalize0to1", SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW, bench.alpha, THERMO_FRAME_PIXEL, normalize_samples);
+    if (expand) {
+        add_result("liner_interpolation", reso_x, reso_y, bench.alpha, grid_pixels, interpolate_samples);
+    }
+    add_result("conv_normalize_to_color", ref_x, ref_y, bench.alpha, ref_x * ref_y, color_samples);
+
+    // whole update_thermograph of both paths
+    samples.reset(opt.iterations);
+    for (i = 0; i < (BENCH_WARMUP + opt.iterations); i++) {
+        int f = i % BENCH_SCENE_FRAMES;
+        uint64_t before = cache.bytes();
+
+        if (i == BENCH_WARMUP) {
+            renderer.redraw().reset_stats();
+        }
+        timer.start();
+        renderer.update(&scene_pixel[f][0], reso_x, reso_y, (uint8_t)bench.alpha,
+                        scene_ptat[f] - SIM_TEMP_MARGIN_UNDER, scene_ptat[f] + SIM_TEMP_MARGIN_UPPER);
+        if (i >= BENCH_WARMUP) {
+            timer.stop(samples);
+            samples.bytes += cache.bytes() - before;
+        }
+    }
+    add_result("update_thermograph", reso_x, reso_y, bench.alpha, display_pixels, samples);
+    add_redrawn();
+
+    // tiles at grid size on a scaling layer
+    renderer.use_grid_layer(&grid_display);
+    samples.reset(opt.iterations);
+    for (i = 0; i < (BENCH_WARMUP + opt.iterations); i++) {
+        int f = i % BENCH_SCENE_FRAMES;
+        uint64_t before = cache.bytes();
+
+        if (i == BENCH_WARMUP) {
+            renderer.redraw().reset_stats();
+        }
+        timer.start();
+        renderer.update(&scene_pixel[f][0], reso_x, reso_y, (uint8_t)bench.alpha,
+                        scene_ptat[f] - SIM_TEMP_MARGIN_UNDER, scene_ptat[f] + SIM_TEMP_MARGIN_UPPER);
+        if (i >= BENCH_WARMUP) {
+            timer.stop(samples);
+            samples.bytes += cache.bytes() - before;
+        }
+    }
+    renderer.use_grid_layer(NULL);
+    add_result("update_thermograph_grid", reso_x, reso_y, bench.alpha, display_pixels, samples);
+    add_redrawn();
+
+    samples.reset(opt.iterations);
+    for (i = 0; i < (BENCH_WARMUP + opt.iterations); i++) {
+        int f = i % BENCH_SCENE_FRAMES;
+        uint64_t before = cache.bytes();
+
+        if (i == BENCH_WARMUP) {
+            renderer.redraw().reset_stats();
+        }
+        timer.start();
+        renderer.update_reference(&scene_pixel[f][0], reso_x, reso_y, (uint8_t)bench.alpha,
+                                  scene_ptat[f] - SIM_TEMP_MARGIN_UNDER, scene_ptat[f] + SIM_TEMP_MARGIN_UPPER);
+        if (i >= BENCH_WARMUP) {
+            timer.stop(samples);
+            samples.bytes += cache.bytes() - before;
+        }
+    }
+    add_result("update_thermograph_reference", ref_x, ref_y, bench.alpha, display_pixels, samples);
+    add_redrawn();
+}
+
+static void write_json(FILE* p_file)
+{
+    size_t i;
+
+    fprintf(p_file, "{\n");
+    fprintf(p_file, "  \"benchmark\": \"thermo_bench\",\n");
+    fprintf(p_file, "  \"sensor\": { \"model\": \"%s\", \"cols\": %d, \"rows\": %d },\n",
+            BENCH_STR(MBED_CONF_APP_D6T_MODEL), SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW);
+    fprintf(p_file, "  \"display\": { \"width\": %d, \"height\": %d },\n", SIM_VIDEO_PIXEL_HW, SIM_VIDEO_PIXEL_VW);
+    fprintf(p_file, "  \"i2c_frequency\": %d,\n", opt.frequency);
+    fprintf(p_file, "  \"scene\": \"%s\",\n", (opt.p_scene != NULL) ? opt.p_scene : "synthetic");
+    fprintf(p_file, "  \"cycle_source\": \"%s\",\n",
+            BENCH_HAS_TSC ? "tsc" : ((opt.cpu_mhz > 0) ? "time" : "none"));
+    fprintf(p_file, "  \"compiler\": \"%s\",\n", __VERSION__);
+    fprintf(p_file, "  \"results\": [\n");
+    for (i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+
+        fprintf(p_file, "    { \"stage\": \"%s\", \"reso\": \"%dx%d\", ", r.stage, r.reso_x, r.reso_y);
+        if (r.alpha == BENCH_NO_ALPHA) {
+            fprintf(p_file, "\"alpha\": null, ");
+        } else {
+            fprintf(p_file, "\"alpha\": %d, ", r.alpha);
+        }
+        fprintf(p_file, "\"pixels\": %lu, \"iterations\": %d, \"min_ns\": %.0f, \"median_ns\": %.0f, \"p99_ns\": %.0f, ",
+                (unsigned long)r.pixels, r.iterations, r.min_ns, r.median_ns, r.p99_ns);
+        if (r.cycles_per_pixel < 0) {
+            fprintf(p_file, "\"cycles_per_pixel\": null, ");
+        } else {
+            fprintf(p_file, "\"cycles_per_pixel\": %.3f, ", r.cycles_per_pixel);
+        }
+        fprintf(p_file, "\"cache_clean_bytes\": %llu", (unsigned long long)r.bytes);
+        if (r.rmse >= 0) {
+            fprintf(p_file, ", \"rmse_degc\": %.3f, \"max_error_degc\": %.3f", r.rmse, r.max_error);
+        }
+        if (r.changed >= 0) {
+            fprintf(p_file, ", \"changed_ratio\": %.3f", r.changed);
+        }
+        if (r.redrawn >= 0) {
+            fprintf(p_file, ", \"redrawn_ratio\": %.3f", r.redrawn);
+        }
+        if (r.mismatch >= 0) {
+            fprintf(p_file, ", \"mismatch_ratio\": %.5f", r.mismatch);
+        }
+        if (r.saturated >= 0) {
+            fprintf(p_file, ", \"saturated_ratio\": %.3f, \"range_change_ratio\": %.3f", r.saturated, r.range_changes);
+        }
+        fprintf(p_file, " }%s\n", (i + 1 < results.size()) ? "," : "");
+    }
+    fprintf(p_file, "  ]\n");
+    fprintf(p_file, "}\n");
+}
+
+static bool parse(int argc, char** argv)
+{
+    int i;
+
+    opt.iterations     = 200;
+    opt.i2c_iterations = 20;
+    opt.frequency      = D6T_I2C_FREQUENCY_MAX;
+    opt.cpu_mhz        = 0;
+    opt.p_scene        = NULL;
+    opt.p_out          = NULL;
+
+    for (i = 1; i < argc; i++) {
+        const char* p_arg = argv[i];
+        const char* p_val = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (p_val == NULL) {
+            return false;
+        }
+        if (strcmp(p_arg, "--iterations") == 0) {
+            opt.iterations = atoi(p_val);
+        } else if (strcmp(p_arg, "--i2c-iterations") == 0) {
+            opt.i2c_iterations = atoi(p_val);
+        } else if (strcmp(p_arg, "--frequency") == 0) {
+            opt.frequency = atoi(p_val);
+        } else if (strcmp(p_arg, "--cpu-mhz") == 0) {
+            opt.cpu_mhz = atof(p_val);
+        } else if (strcmp(p_arg, "--scene") == 0) {
+            opt.p_scene = p_val;
+        } else if (strcmp(p_arg, "--out") == 0) {
+            opt.p_out = p_val;
+        } else {
+            return false;
+        }
+        i++;
+    }
+    return (opt.iterations > 0) && (opt.i2c_iterations > 0) && (opt.frequency > 0);
+}
+
+int main(int argc, char** argv)
+{
+    FILE* p_file = stdout;
+
+    if (!parse(argc, argv)) {
+        fprintf(stderr, "usage: %s [--iterations N] [--i2c-iterations N] [--frequency HZ]"
+                        " [--cpu-mhz MHZ] [--scene FILE] [--out FILE]\n", argv[0]);
+        return 2;
+    }
+    if (!prepare_scene()) {
+        return 1;
+    }
+    if (opt.p_out != NULL) {
+        p_file = fopen(opt.p_out, "w");
+        if (p_file == NULL) {
+            perror(opt.p_out);
+            return 1;
+        }
+    }
+
+    bench_sensor();
+    bench_fusion();
+    bench_upscale();
+    bench_filter();
+    bench_redraw();
+    bench_frame_stats();
+    bench_range();
+    for (const BenchCase& bench : case_list) {
+        bench_case(bench);
+    }
+
+    write_json(p_file);
+    if (p_file != stdout) {
+        fclose(p_file);
+    }
+    return 0;
+}
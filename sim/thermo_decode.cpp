@@ -0,0 +1,394 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/* Decoder of the telemetry stream (mbed_app.json "telemetry") and of the
+ * frame log (mbed_app.json "record")
+ *
+ * Reads the bytes captured from the console UART, finds the packets by their
+ * sync bytes and CRC (console text between them is skipped), undoes the
+ * delta encoding and writes one line or row per frame:
+ *
+ *   csv   sequence,timestamp_ms,sensor,ptat,p0,...  with a header line,
+ *         e.g. numpy.loadtxt(FILE, delimiter=",", skiprows=1)
+ *   scene ptat,p0,...  the --scene format of thermo_sim
+ *   npy   int32 array [frames][4 + pixels] of the csv columns, numpy.load(FILE)
+ *
+ * Temperatures stay integers of 0.1 degree C. Delta frames after a lost
+ * packet are skipped until the next key frame. A frame log is recognized by
+ * its magic; chunks with a wrong CRC are skipped, as are records of another
+ * sensor size than the first one.
+ *
+ *   thermo_decode [--format csv|scene|npy] [--out FILE] STREAM|LOG
+ *
+ * e.g. capture with "stty -F /dev/ttyACM0 115200 raw && cat /dev/ttyACM0 > stream.bin"
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "ThermoTelemetry.h"
+#include "ThermoLog.h"
+
+struct Options {
+    const char* p_format;
+    const char* p_out;
+    const char* p_in;
+};
+
+/** Counters of a decoded stream */
+struct DecodeStats {
+    uint32_t keys;
+    uint32_t deltas;
+    uint32_t crc_errors;
+    uint32_t lost;          // packets missing by the packet counter
+    uint32_t no_base;       // delta frames without their previous frame
+    uint64_t skipped;       // bytes outside of packets
+    uint32_t bad_chunks;    // log chunks with a wrong CRC
+};
+
+/** Stream state and decoded frames */
+class TelemetryDecoder
+{
+public:
+    TelemetryDecoder() : mCols(0), mRows(0), mHasBase(false), mHasCounter(false), mCounter(0)
+    {
+        memset(&mStats, 0, sizeof(mStats));
+    }
+
+    /** Decode a whole capture */
+    void decode(const std::vector<uint8_t>& data)
+    {
+        size_t pos = 0;
+
+        while ((pos + THERMO_TELEMETRY_HEADER + THERMO_TELEMETRY_CRC) <= data.size()) {
+            size_t size = packet(&data[pos], data.size() - pos);
+
+            if (size == 0) {
+                mStats.skipped++;
+                pos++;
+            } else {
+                pos += size;
+            }
+        }
+        mStats.skipped += data.size() - pos;
+    }
+
+    /** Read a whole frame log, every record counts as a key frame */
+    bool decode_log(const char* path)
+    {
+        static uint8_t chunk[THERMO_LOG_CHUNK_SIZE];
+        ThermoLogReader log(chunk);
+        const uint8_t* p_record;
+
+        if (!log.open(path)) {
+            return false;
+        }
+        while ((p_record = log.next_record()) != NULL) {
+            int n;
+
+            if (mFrames.empty()) {
+                mCols = log.cols();
+                mRows = log.rows();
+            } else if ((log.cols() != mCols) || (log.rows() != mRows)) {
+                continue;
+            }
+            std::vector<int32_t> frame;
+            frame.push_back((int32_t)get_u32(&p_record[4]));
+            frame.push_back((int32_t)get_u32(&p_record[0]));
+            frame.push_back((int32_t)get_u16(&p_record[8]));
+            for (n = 0; n < (1 + (mCols * mRows)); n++) {
+                frame.push_back((int16_t)get_u16(&p_record[10 + (n * 2)]));
+            }
+            mFrames.push_back(frame);
+            mStats.keys++;
+        }
+        mStats.bad_chunks = log.bad_chunks();
+        return true;
+    }
+
+    int cols(void) const { return mCols; }
+    int rows(void) const { return mRows; }
+    const DecodeStats& stats(void) const { return mStats; }
+
+    /** Frames: sequence, timestamp_ms, sensor, ptat, pixels */
+    const std::vector<std::vector<int32_t> >& frames(void) const { return mFrames; }
+
+private:
+    int mCols;
+    int mRows;
+    bool mHasBase;
+    bool mHasCounter;
+    uint8_t mCounter;
+    std::vector<int32_t> mBase;     // ptat and pixels of the previous packet
+    std::vector<std::vector<int32_t> > mFrames;
+    DecodeStats mStats;
+
+    static uint32_t get_u16(const uint8_t* p_data) { return p_data[0] | (p_data[1] << 8); }
+    static uint32_t get_u32(const uint8_t* p_data) { return get_u16(p_data) | (get_u16(&p_data[2]) << 16); }
+
+    /* packet at p_data, 0 if there is none */
+    size_t packet(const uint8_t* p_data, size_t avail)
+    {
+        uint32_t values;
+        uint32_t length;
+        size_t size;
+        uint8_t type;
+
+        if ((p_data[0] != THERMO_TELEMETRY_SYNC0) || (p_data[1] != THERMO_TELEMETRY_SYNC1)
+         || (p_data[2] != THERMO_TELEMETRY_VERSION)) {
+            return 0;
+        }
+        type = p_data[3];
+        values = THERMO_TELEMETRY_VALUES(p_data[6] * p_data[7]);
+        length = get_u16(&p_data[16]);
+        if (((type != THERMO_TELEMETRY_KEY) && (type != THERMO_TELEMETRY_DELTA)) || (length > (values * 2))) {
+            return 0;
+        }
+        size = THERMO_TELEMETRY_HEADER + length + THERMO_TELEMETRY_CRC;
+        if (size > avail) {
+            return 0;
+        }
+        if (ThermoTelemetryEncoder::crc(&p_data[2], (THERMO_TELEMETRY_HEADER - 2) + length)
+            != get_u16(&p_data[THERMO_TELEMETRY_HEADER + length])) {
+            mStats.crc_errors++;
+            return 0;
+        }
+
+        if (mHasCounter && (p_data[4] != (uint8_t)(mCounter + 1))) {
+            mStats.lost += (uint8_t)(p_data[4] - mCounter - 1);
+            mHasBase = false;
+        }
+        mHasCounter = true;
+        mCounter = p_data[4];
+        if ((p_data[6] != mCols) || (p_data[7] != mRows)) {
+            mCols = p_data[6];
+            mRows = p_data[7];
+            mHasBase = false;
+        }
+
+        if (type == THERMO_TELEMETRY_KEY) {
+            if (!key(&p_data[THERMO_TELEMETRY_HEADER], length, values)) {
+                mHasBase = false;
+                return size;
+            }
+            mStats.keys++;
+        } else {
+            if (!mHasBase) {
+                mStats.no_base++;
+                return size;
+            }
+            if (!delta(&p_data[THERMO_TELEMETRY_HEADER], length, values)) {
+                mHasBase = false;
+                return size;
+            }
+            mStats.deltas++;
+        }
+        mHasBase = true;
+
+        std::vector<int32_t> frame;
+        frame.push_back((int32_t)get_u32(&p_data[8]));
+        frame.push_back((int32_t)get_u32(&p_data[12]));
+        frame.push_back(p_data[5]);
+        frame.insert(frame.end(), mBase.begin(), mBase.end());
+        mFrames.push_back(frame);
+        return size;
+    }
+
+    bool key(const uint8_t* p_payload, uint32_t length, uint32_t values)
+    {
+        uint32_t i;
+
+        if (length != (values * 2)) {
+            return false;
+        }
+        mBase.resize(values);
+        for (i = 0; i < values; i++) {
+            mBase[i] = (int16_t)get_u16(&p_payload[i * 2]);
+        }
+        return true;
+    }
+
+    bool delta(const uint8_t* p_payload, uint32_t length, uint32_t values)
+    {
+        uint32_t pos = 0;
+        uint32_t i;
+
+        if (mBase.size() != values) {
+            return false;
+        }
+        for (i = 0; i < values; i++) {
+            uint32_t value = 0;
+            int shift = 0;
+
+            do {
+                if ((pos >= length) || (shift > 14)) {
+                    return false;
+                }
+                value |= (uint32_t)(p_payload[pos] & 0x7F) << shift;
+                shift += 7;
+            } while (p_payload[pos++] & 0x80);
+            mBase[i] = (int16_t)(mBase[i] + (int32_t)((value >> 1) ^ (0 - (value & 1))));
+        }
+        return pos == length;
+    }
+};
+
+static void write_text(FILE* p_file, const TelemetryDecoder& decoder, bool scene)
+{
+    size_t i;
+    int n;
+
+    if (!scene) {
+        fprintf(p_file, "sequence,timestamp_ms,sensor,ptat");
+        for (n = 0; n < (decoder.cols() * decoder.rows()); n++) {
+            fprintf(p_file, ",p%d", n);
+        }
+        fprintf(p_file, "\n");
+    }
+    for (const std::vector<int32_t>& frame : decoder.frames()) {
+        for (i = (scene ? 3 : 0); i < frame.size(); i++) {
+            fprintf(p_file, "%ld%s", (long)frame[i], ((i + 1) < frame.size()) ? "," : "\n");
+        }
+    }
+}
+
+/* NPY format 1.0: magic, header length, a Python dict padded to 64 bytes, the data */
+static void write_npy(FILE* p_file, const TelemetryDecoder& decoder)
+{
+    const std::vector<std::vector<int32_t> >& frames = decoder.frames();
+    size_t columns = frames.empty() ? 4 : frames[0].size();
+    char header[128];
+    int length;
+    int padded;
+
+    length = snprintf(header, sizeof(header), "{'descr': '<i4', 'fortran_order': False, 'shape': (%lu, %lu), }",
+                      (unsigned long)frames.size(), (unsigned long)columns);
+    padded = ((10 + length + 1 + 63) / 64) * 64 - 10;
+    memset(&header[length], ' ', padded - length - 1);
+    header[padded - 1] = '\n';
+
+    fwrite("\x93NUMPY\x01\x00", 1, 8, p_file);
+    fputc(padded & 0xFF, p_file);
+    fputc(padded >> 8, p_file);
+    fwrite(header, 1, padded, p_file);
+    for (const std::vector<int32_t>& frame : frames) {
+        for (int32_t value : frame) {
+            uint8_t le[4] = { (uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24) };
+            fwrite(le, 1, sizeof(le), p_file);
+        }
+    }
+}
+
+static bool parse(int argc, char** argv, Options& opt)
+{
+    int i;
+
+    opt.p_format = "csv";
+    opt.p_out    = NULL;
+    opt.p_in     = NULL;
+
+    for (i = 1; i < argc; i++) {
+        const char* p_arg = argv[i];
+        const char* p_val = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (p_arg[0] != '-') {
+            opt.p_in = p_arg;
+            continue;
+        }
+        if (p_val == NULL) {
+            return false;
+        }
+        if (strcmp(p_arg, "--format") == 0) {
+            opt.p_format = p_val;
+        } else if (strcmp(p_arg, "--out") == 0) {
+            opt.p_out = p_val;
+        } else {
+            return false;
+        }
+        i++;
+    }
+    return (opt.p_in != NULL)
+        && ((strcmp(opt.p_format, "csv") == 0) || (strcmp(opt.p_format, "scene") == 0) || (strcmp(opt.p_format, "npy") == 0));
+}
+
+int main(int argc, char** argv)
+{
+    TelemetryDecoder decoder;
+    std::vector<uint8_t> data;
+    Options opt;
+    FILE* p_file;
+    uint8_t buf[4096];
+    size_t size;
+
+    if (!parse(argc, argv, opt)) {
+        fprintf(stderr, "usage: %s [--format csv|scene|npy] [--out FILE] STREAM|LOG\n", argv[0]);
+        return 2;
+    }
+    if ((strcmp(opt.p_in, "-") != 0) && ThermoLogReader::is_log(opt.p_in)) {
+        if (!decoder.decode_log(opt.p_in)) {
+            perror(opt.p_in);
+            return 1;
+        }
+    } else {
+        p_file = (strcmp(opt.p_in, "-") == 0) ? stdin : fopen(opt.p_in, "rb");
+        if (p_file == NULL) {
+            perror(opt.p_in);
+            return 1;
+        }
+        while ((size = fread(buf, 1, sizeof(buf), p_file)) > 0) {
+            data.insert(data.end(), buf, buf + size);
+        }
+        if (p_file != stdin) {
+            fclose(p_file);
+        }
+        decoder.decode(data);
+    }
+
+    p_file = stdout;
+    if (opt.p_out != NULL) {
+        p_file = fopen(opt.p_out, "wb");
+        if (p_file == NULL) {
+            perror(opt.p_out);
+            return 1;
+        }
+    }
+    if (strcmp(opt.p_format, "npy") == 0) {
+        write_npy(p_file, decoder);
+    } else {
+        write_text(p_file, decoder, strcmp(opt.p_format, "scene") == 0);
+    }
+    if (p_file != stdout) {
+        fclose(p_file);
+    }
+
+    const DecodeStats& stats = decoder.stats();
+    fprintf(stderr, "%lu frames of %dx%d: %lu key, %lu delta, %lu crc errors, %lu lost, %lu without base,"
+                    " %llu bytes skipped, %lu bad log chunks\n",
+            (unsigned long)decoder.frames().size(), decoder.cols(), decoder.rows(), (unsigned long)stats.keys,
+            (unsigned long)stats.deltas, (unsigned long)stats.crc_errors, (unsigned long)stats.lost,
+            (unsigned long)stats.no_base, (unsigned long long)stats.skipped, (unsigned long)stats.bad_chunks);
+    return 0;
+}
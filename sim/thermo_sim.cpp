@@ -0,0 +1,795 @@
+// SPDX-License-Identifier: MIT
+/*
+ * MIT License
+ * Copyright (c) 2019 Renesas Electronics Corporation
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/* Host simulator of the thermograph pipeline
+ *
+ * Runs the sensor driver, the acquisition thread and the fixed-point render
+ * path of main.cpp against a simulated D6T on a simulated I2C bus, then
+ * prints the frame time, the heap allocations and the memory use.
+ *
+ *   thermo_sim [--frames N] [--period MS] [--latency-us US] [--frequency HZ]
+ *              [--reso WxH] [--scene FILE] [--fps N] [--load-ms MS]
+ *              [--fade N] [--pixel-alpha 0|1] [--grid-layer 0|1]
+ *              [--drp 0|1] [--isp-ms MS] [--drp-load-ms MS]
+ *              [--fused FILE] [--fused-step N] [--registration H] [--points P]
+ *              [--upscale linear|cubic|edge]
+ *              [--telemetry FILE] [--telemetry-mode 1|2] [--baud BAUD]
+ *              [--record FILE] [--filter off|ema|median] [--filter-strength N]
+ *              [--deadband D] [--redraw-threshold T]
+ *              [--range fixed|auto] [--range-percentile P]
+ *
+ * --fade N steps the alpha of the demo cycle (MAX, SWITCH2, SWITCH1, DEFAULT)
+ * every N frames, --pixel-alpha 1 draws it into the pixels instead of the
+ * layer alpha of the display. --grid-layer 1 draws the tiles at grid size
+ * into a second layer which scales them up. --drp 1 runs a camera thread at
+ * 30 fps whose ISP takes MS on the simulated DRP, the grid is expanded on
+ * the DRP between two camera frames when the library switch fits.
+ *
+ * --fused writes the last frame over a test camera image as a BMP, through
+ * the registration map of --registration (9 or 6 comma separated values,
+ * camera pixel to thermograph) or --points (3 or 4 "x,y,u,v" point pairs
+ * separated by ';', an affine transform or a homography is solved).
+ *
+ * --telemetry writes every sensor frame as telemetry packets of main.cpp
+ * (mode 1 key frames only, 2 with delta frames) through the buffered writer
+ * to a file at the pace of a UART of BAUD, for thermo_decode.
+ *
+ * --record appends every sensor frame to a frame log through the recorder
+ * thread of main.cpp "record". --scene takes such a log as well as a text
+ * file; a log is replayed at its recorded frame interval unless --period
+ * is given (--period 0 runs as fast as the bus allows).
+ *
+ * --filter runs the temporal filter of main.cpp "filter" in the acquisition
+ * thread; the share of changed pixels and the mean change of a pixel from
+ * one frame to the next (the flicker) are printed.
+ *
+ * --range auto follows the percentiles P and 100 - P of each frame (the
+ * frame statistics of the acquisition thread) as main.cpp "color-range" 1;
+ * the range changes and the share of saturated pixels are printed.
+ */
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <vector>
+#include "mbed.h"
+#include "D6T_44L_06.h"
+#include "ThermoD6TDevice.h"
+#include "ThermoSensorManager.h"
+#include "ThermoProfiler.h"
+#include "ThermoAutoRange.h"
+#include "ThermoFrameScheduler.h"
+#include "ThermoDrpScheduler.h"
+#include "ThermoRegistration.h"
+#include "ThermoFusion.h"
+#include "ThermoTelemetry.h"
+#include "ThermoTelemetryWriter.h"
+#include "ThermoRecorder.h"
+#include "SimD6T.h"
+#include "SimDrpLib.h"
+#include "SimHal.h"
+#include "SimI2cBus.h"
+#include "SimRender.h"
+#include "SimScene.h"
+
+#define SENSOR_ID           (0)
+#define WARMUP_FRAMES       (10)
+#define CAMERA_PERIOD_MS    (33)
+#define TELEMETRY_KEYFRAME  (16)    /* mbed_app.json "telemetry-keyframe" */
+#define DRAIN_TIMEOUT_MS    (10000)
+
+#define PROFILE_RENDER      (0)
+#define PROFILE_SENSOR      (1)
+#define PROFILE_TELEMETRY   (2)
+
+/* heap use of the whole process */
+static std::atomic<uint64_t> alloc_count(0);
+static std::atomic<uint64_t> alloc_bytes(0);
+
+void* operator new(size_t size)
+{
+    void* p = malloc((size == 0) ? 1 : size);
+
+    if (p == NULL) {
+        throw std::bad_alloc();
+    }
+    alloc_count++;
+    alloc_bytes += size;
+    return p;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+    free(p);
+}
+
+/* the display buffers are too large for the stack */
+static SimCache cache;
+static SimDisplay display;
+static SimDisplay grid_display(SIM_VIDEO_PIXEL_HW, SIM_VIDEO_PIXEL_VW, true);
+static SimRender renderer(cache, display);
+static ThermoProfiler profiler;
+
+/* DRP shared by the camera ISP (all tiles) and the resize of the grid (one tile) */
+static const ThermoDrpLibrary drp_isp = { sim_drp_lib_isp, 0x01, 0 };
+static const ThermoDrpLibrary drp_resize = { sim_drp_lib_resize, 0x01, 0 };
+static SimDrp drp;
+static ThermoDrpScheduler drp_scheduler(drp, drp_isp, CAMERA_PERIOD_MS * 1000);
+
+/* telemetry stream of main.cpp "telemetry" on a simulated UART */
+static SimSerial serial;
+static uint8_t telemetry_buffer[4096];
+static ThermoTelemetryWriter telemetry(serial, telemetry_buffer, sizeof(telemetry_buffer));
+static uint8_t telemetry_packet[THERMO_TELEMETRY_MAX_PACKET];
+
+/* frame log of main.cpp "record" */
+static uint8_t record_chunk[THERMO_LOG_CHUNK_SIZE];
+static ThermoLogWriter record_log(record_chunk);
+
+/* camera image and registration of --fused, as main.cpp */
+static uint8_t camera_yuv[SIM_VIDEO_PIXEL_HW * 2 * SIM_VIDEO_PIXEL_VW];
+static uint16_t registration_map[THERMO_REG_MAP_SIZE(SIM_VIDEO_PIXEL_HW, SIM_VIDEO_PIXEL_VW)];
+static ThermoRegistration registration(registration_map, SIM_VIDEO_PIXEL_HW, SIM_VIDEO_PIXEL_VW);
+static ThermoFusion fusion(registration);
+static uint16_t fused_colors[SIM_RESO_MAX_VW * SIM_RESO_MAX_HW];
+static uint8_t fused_row[THERMO_BMP_ROW_SIZE(SIM_VIDEO_PIXEL_HW)];
+
+struct Options {
+    int frames;
+    uint32_t period_ms;
+    bool period_set;
+    uint32_t latency_us;
+    int frequency;
+    int reso_x;
+    int reso_y;
+    const char* p_scene;
+    int fps;
+    uint32_t load_ms;
+    int fade;
+    int pixel_alpha;
+    int grid_layer;
+    int drp;
+    uint32_t isp_ms;
+    uint32_t drp_load_ms;
+    const char* p_fused;
+    int fused_step;
+    float h[9];
+    ThermoResampleMode mode;
+    const char* p_telemetry;
+    int telemetry_mode;
+    int baud;
+    const char* p_record;
+    ThermoFilterMode filter;
+    int filter_strength;
+    int deadband;
+    int redraw_threshold;
+    bool range_auto;
+    int range_percentile;
+};
+
+/* alpha steps of --fade, as the 160*120 modes of main.cpp */
+static const uint8_t fade_list[] = { SIM_ALPHA_MAX, SIM_ALPHA_SWITCH2, SIM_ALPHA_SWITCH1, SIM_ALPHA_DEFAULT };
+
+/* --registration: 9 values of a homography or 6 of an affine transform */
+static bool parse_transform(const char* p_val, float* p_h)
+{
+    float v[9];
+    int n = sscanf(p_val, "%f,%f,%f,%f,%f,%f,%f,%f,%f", &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6], &v[7], &v[8]);
+
+    if (n == 6) {
+        v[6] = 0.0f;
+        v[7] = 0.0f;
+        v[8] = 1.0f;
+    } else if (n != 9) {
+        return false;
+    }
+    memcpy(p_h, v, sizeof(v));
+    return true;
+}
+
+/* --points: 3 or 4 point pairs "x,y,u,v;..." */
+static bool parse_points(const char* p_val, float* p_h)
+{
+    ThermoRegPoint points[4];
+    int n = 0;
+
+    while ((n < 4) && (p_val != NULL)) {
+        ThermoRegPoint& p = points[n];
+
+        if (sscanf(p_val, "%f,%f,%f,%f", &p.x, &p.y, &p.u, &p.v) != 4) {
+            return false;
+        }
+        n++;
+        p_val = strchr(p_val, ';');
+        p_val = (p_val != NULL) ? (p_val + 1) : NULL;
+    }
+    if (n == 4) {
+        return ThermoRegistration::solve_homography(points, p_h);
+    }
+    return (n == 3) && ThermoRegistration::solve_affine(points, p_h);
+}
+
+/* test image of the camera: gray ramp with a color grid every 80 pixels (Y0 Cb Y1 Cr) */
+static void camera_image(uint8_t* p_yuv)
+{
+    int x;
+    int y;
+
+    for (y = 0; y < SIM_VIDEO_PIXEL_VW; y++) {
+        for (x = 0; x < SIM_VIDEO_PIXEL_HW; x += 2) {
+            uint8_t* p_pair = &p_yuv[(((SIM_VIDEO_PIXEL_HW * y) + x) * 2)];
+            bool line = ((x % 80) == 0) || ((y % 80) == 0);
+
+            p_pair[0] = (uint8_t)(16 + ((x * 219) / SIM_VIDEO_PIXEL_HW));
+            p_pair[1] = line ? 240 : 128;
+            p_pair[2] = p_pair[0];
+            p_pair[3] = line ? 16 : 128;
+        }
+    }
+}
+
+static bool write_file(void* p_context, const void* p_data, uint32_t size)
+{
+    return fwrite(p_data, 1, size, (FILE*)p_context) == size;
+}
+
+/* export_fused() of main.cpp: the frame over the camera image as a BMP */
+static bool write_fused(const Options& opt, const ThermoFrame& frame, int min, int max)
+{
+    FILE* p_file;
+    bool ok;
+    int y;
+
+    camera_image(camera_yuv);
+    registration.set_transform(opt.h);
+    registration.build(SIM_RESO_MAX_HW, SIM_RESO_MAX_VW);
+    renderer.palette().set_alpha(SIM_ALPHA_SWITCH1);
+    renderer.kernel().begin(&frame.pixel[0], SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW, min, max,
+                            SimRender::find_resampler(SIM_RESO_MAX_HW, SIM_RESO_MAX_VW), opt.mode);
+    for (y = 0; y < SIM_RESO_MAX_VW; y++) {
+        renderer.kernel().color_row(y, &fused_colors[SIM_RESO_MAX_HW * y]);
+    }
+
+    p_file = fopen(opt.p_fused, "wb");
+    if (p_file == NULL) {
+        return false;
+    }
+    ok = fusion.write_bmp(camera_yuv, SIM_VIDEO_PIXEL_HW * 2, fused_colors, opt.fused_step, fused_row, write_file, p_file);
+    return (fclose(p_file) == 0) && ok;
+}
+
+static bool parse(int argc, char** argv, Options& opt)
+{
+    int i;
+
+    opt.frames     = 300;
+    opt.period_ms  = 20;
+    opt.period_set = false;     // 20 or the interval of a --scene log
+    opt.latency_us = 0;
+    opt.frequency  = D6T_I2C_FREQUENCY_MAX;
+    opt.reso_x     = 160;
+    opt.reso_y     = 120;
+    opt.p_scene    = NULL;
+    opt.fps        = 0;
+    opt.load_ms    = 0;
+    opt.fade       = 0;
+    opt.pixel_alpha = 0;
+    opt.grid_layer = 0;
+    opt.drp        = 0;
+    opt.isp_ms     = 10;
+    opt.drp_load_ms = 2;
+    opt.p_fused    = NULL;
+    opt.fused_step = 1;
+    memset(opt.h, 0, sizeof(opt.h));
+    opt.h[0] = opt.h[4] = opt.h[8] = 1.0f;
+    opt.mode       = THERMO_RESAMPLE_LINEAR;
+    opt.p_telemetry = NULL;
+    opt.telemetry_mode = 2;
+    opt.baud       = 115200;
+    opt.p_record   = NULL;
+    opt.filter     = THERMO_FILTER_OFF;
+    opt.filter_strength = 0;    // 0: 2 for ema, 3 for median
+    opt.deadband   = 0;
+    opt.redraw_threshold = 0;
+    opt.range_auto = false;
+    opt.range_percentile = 2;
+
+    for (i = 1; i < argc; i++) {
+        const char* p_arg = argv[i];
+        const char* p_val = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (p_val == NULL) {
+            return false;
+        }
+        if (strcmp(p_arg, "--frames") == 0) {
+            opt.frames = atoi(p_val);
+        } else if (strcmp(p_arg, "--period") == 0) {
+            opt.period_ms = (uint32_t)atoi(p_val);
+            opt.period_set = true;
+        } else if (strcmp(p_arg, "--latency-us") == 0) {
+            opt.latency_us = (uint32_t)atoi(p_val);
+        } else if (strcmp(p_arg, "--frequency") == 0) {
+            opt.frequency = atoi(p_val);
+        } else if (strcmp(p_arg, "--reso") == 0) {
+            if (sscanf(p_val, "%dx%d", &opt.reso_x, &opt.reso_y) != 2) {
+                return false;
+            }
+        } else if (strcmp(p_arg, "--scene") == 0) {
+            opt.p_scene = p_val;
+        } else if (strcmp(p_arg, "--fps") == 0) {
+            opt.fps = atoi(p_val);
+        } else if (strcmp(p_arg, "--load-ms") == 0) {
+            opt.load_ms = (uint32_t)atoi(p_val);
+        } else if (strcmp(p_arg, "--fade") == 0) {
+            opt.fade = atoi(p_val);
+        } else if (strcmp(p_arg, "--pixel-alpha") == 0) {
+            opt.pixel_alpha = atoi(p_val);
+        } else if (strcmp(p_arg, "--grid-layer") == 0) {
+            opt.grid_layer = atoi(p_val);
+        } else if (strcmp(p_arg, "--drp") == 0) {
+            opt.drp = atoi(p_val);
+        } else if (strcmp(p_arg, "--isp-ms") == 0) {
+            opt.isp_ms = (uint32_t)atoi(p_val);
+        } else if (strcmp(p_arg, "--drp-load-ms") == 0) {
+            opt.drp_load_ms = (uint32_t)atoi(p_val);
+        } else if (strcmp(p_arg, "--fused") == 0) {
+            opt.p_fused = p_val;
+        } else if (strcmp(p_arg, "--fused-step") == 0) {
+            opt.fused_step = atoi(p_val);
+        } else if (strcmp(p_arg, "--registration") == 0) {
+            if (!parse_transform(p_val, opt.h)) {
+                return false;
+            }
+        } else if (strcmp(p_arg, "--upscale") == 0) {
+            if (strcmp(p_val, "linear") == 0) {
+                opt.mode = THERMO_RESAMPLE_LINEAR;
+            } else if (strcmp(p_val, "cubic") == 0) {
+                opt.mode = THERMO_RESAMPLE_CUBIC;
+            } else if (strcmp(p_val, "edge") == 0) {
+                opt.mode = THERMO_RESAMPLE_EDGE;
+            } else {
+                return false;
+            }
+        } else if (strcmp(p_arg, "--filter") == 0) {
+            if (strcmp(p_val, "off") == 0) {
+                opt.filter = THERMO_FILTER_OFF;
+            } else if (strcmp(p_val, "ema") == 0) {
+                opt.filter = THERMO_FILTER_EMA;
+            } else if (strcmp(p_val, "median") == 0) {
+                opt.filter = THERMO_FILTER_MEDIAN;
+            } else {
+                return false;
+            }
+        } else if (strcmp(p_arg, "--filter-strength") == 0) {
+            opt.filter_strength = atoi(p_val);
+        } else if (strcmp(p_arg, "--deadband") == 0) {
+            opt.deadband = atoi(p_val);
+        } else if (strcmp(p_arg, "--redraw-threshold") == 0) {
+            opt.redraw_threshold = atoi(p_val);
+        } else if (strcmp(p_arg, "--range") == 0) {
+            if (strcmp(p_val, "fixed") == 0) {
+                opt.range_auto = false;
+            } else if (strcmp(p_val, "auto") == 0) {
+                opt.range_auto = true;
+            } else {
+                return false;
+            }
+        } else if (strcmp(p_arg, "--range-percentile") == 0) {
+            opt.range_percentile = atoi(p_val);
+        } else if (strcmp(p_arg, "--record") == 0) {
+            opt.p_record = p_val;
+        } else if (strcmp(p_arg, "--telemetry") == 0) {
+            opt.p_telemetry = p_val;
+        } else if (strcmp(p_arg, "--telemetry-mode") == 0) {
+            opt.telemetry_mode = atoi(p_val);
+        } else if (strcmp(p_arg, "--baud") == 0) {
+            opt.baud = atoi(p_val);
+        } else if (strcmp(p_arg, "--points") == 0) {
+            if (!parse_points(p_val, opt.h)) {
+                return false;
+            }
+        } else {
+            return false;
+        }
+        i++;
+    }
+    if ((opt.frames <= WARMUP_FRAMES) || (opt.fps < 0) || (opt.fps > 1000) || (opt.fade < 0)
+     || (opt.fused_step < 1) || (opt.fused_step > SIM_VIDEO_PIXEL_VW)
+     || (opt.telemetry_mode < 1) || (opt.telemetry_mode > 2) || (opt.baud < 0)
+     || (opt.range_percentile < 0) || (opt.range_percentile > 49)
+     || (((opt.reso_x != SIM_SENSOR_RESO_HW) || (opt.reso_y != SIM_SENSOR_RESO_VW)) && (SimRender::find_resampler(opt.reso_x, opt.reso_y) == NULL))) {
+        return false;
+    }
+    return true;
+}
+
+/* bytes of the console text of a frame in main.cpp without "telemetry" */
+static uint32_t text_dump_size(const ThermoFrame& frame)
+{
+    char line[80];
+    uint32_t size;
+    int i;
+
+    size  = snprintf(line, sizeof(line), "\x1b[%d;%dH", 0, 0);
+    size += snprintf(line, sizeof(line), "PTAT: %6.1f[degC]  sensor %u frame %6lu %10lu[ms]\r\n", frame.ptat / 10.0,
+                     (unsigned)frame.sensor_id, (unsigned long)frame.sequence, (unsigned long)frame.timestamp_ms);
+    for (i = 0; i < THERMO_FRAME_PIXEL; i++) {
+        size += snprintf(line, sizeof(line), "%4.1f, ", frame.pixel[i] / 10.0);
+        if ((i % SIM_SENSOR_RESO_HW) == (SIM_SENSOR_RESO_HW - 1)) {
+            size += 2;
+        }
+    }
+    size += snprintf(line, sizeof(line), "min %5.1f max %5.1f mean %5.1f hot spot %2u,%-2u  %2d-%-2d%%: %5.1f - %5.1f[degC]\r\n",
+                     frame.stats.min / 10.0, frame.stats.max / 10.0, frame.stats.mean / 10.0,
+                     (unsigned)frame.stats.hot_x, (unsigned)frame.stats.hot_y, 2, 98,
+                     frame.stats.low / 10.0, frame.stats.high / 10.0);
+    size += snprintf(line, sizeof(line), "tiles: %5lu drawn %5lu skipped, cache clean: %7lu[byte], redrawn %3lu%%\r\n",
+                     0UL, 0UL, 0UL, 0UL);
+    return size;
+}
+
+/* drp_task() of main.cpp: an ISP run per camera frame */
+static void camera_task(void)
+{
+    uint64_t deadline = Kernel::get_ms_count();
+    uint8_t isp_param = 0;
+
+    drp_scheduler.start();
+    while (1) {
+        deadline += CAMERA_PERIOD_MS;
+        ThisThread::sleep_until(deadline);
+        drp_scheduler.camera_frame(&isp_param, sizeof(isp_param));
+    }
+}
+
+/* the fixed-point path of update_thermograph() in main.cpp, without the title */
+int main(int argc, char** argv)
+{
+    Options opt;
+    SimSyntheticScene synthetic;
+    SimRecordedScene recorded;
+    SimScene* p_scene = &synthetic;
+
+    if (!parse(argc, argv, opt)) {
+        fprintf(stderr, "usage: %s [--frames N] [--period MS] [--latency-us US] [--frequency HZ]"
+                        " [--reso WxH] [--scene FILE] [--fps N] [--load-ms MS]"
+                        " [--fade N] [--pixel-alpha 0|1] [--grid-layer 0|1]"
+                        " [--drp 0|1] [--isp-ms MS] [--drp-load-ms MS]"
+                        " [--fused FILE] [--fused-step N] [--registration H] [--points P]"
+                        " [--upscale linear|cubic|edge]"
+                        " [--telemetry FILE] [--telemetry-mode 1|2] [--baud BAUD]"
+                        " [--record FILE] [--filter off|ema|median] [--filter-strength N]"
+                        " [--deadband D] [--redraw-threshold T]"
+                        " [--range fixed|auto] [--range-percentile P]\n", argv[0]);
+        return 2;
+    }
+    if (opt.p_scene != NULL) {
+        if (recorded.load(opt.p_scene, THERMO_FRAME_PIXEL) == 0) {
+            fprintf(stderr, "%s: no %dx%d frame\n", opt.p_scene, SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW);
+            return 1;
+        }
+        p_scene = &recorded;
+    }
+    if (!opt.period_set) {
+        opt.period_ms = (recorded.period_ms() != 0) ? recorded.period_ms() : 20;
+    }
+
+    SimI2cBus bus(opt.latency_us);
+    SimD6T sim_d6t(*p_scene);
+    D6T<ThermoSensorModel> d6t(bus);
+    ThermoD6TDevice device(d6t);
+    ThermoAcquisition acquisition(opt.period_ms);
+    ThermoFrameScheduler scheduler((opt.fps != 0) ? (1000 / opt.fps) : 1);
+    ThermoSensorManager sensors;
+    Thread camera_thread;
+    std::vector<double> frame_us;
+    ThermoFrame frame;
+    uint32_t cursor = 0;
+    uint64_t warm_count = 0;
+    uint64_t warm_bytes = 0;
+    uint64_t first_ms = 0;
+    uint64_t last_ms = 0;
+    int done = 0;
+    ThermoTelemetryEncoder telemetry_encoder(TELEMETRY_KEYFRAME, (opt.telemetry_mode == 2));
+    FILE* p_telemetry = NULL;
+    uint32_t telemetry_cursor = 0;
+    ThermoFrameFilter filter(opt.filter, (opt.filter_strength != 0) ? opt.filter_strength
+                                         : ((opt.filter == THERMO_FILTER_MEDIAN) ? 3 : 2), opt.deadband);
+    ThermoFrame previous = {};
+    ThermoAutoRange auto_range(3, 20);
+    uint32_t range_sequence = 0;
+    int min = 0;
+    int max = 0;
+    uint64_t saturated = 0;
+    uint64_t flicker = 0;
+    uint32_t flicker_frames = 0;
+    ThermoRecorder recorder(sensors, SENSOR_ID, record_log, (opt.period_ms != 0) ? opt.period_ms : 1);
+
+    if (opt.p_telemetry != NULL) {
+        p_telemetry = fopen(opt.p_telemetry, "wb");
+        if (p_telemetry == NULL) {
+            perror(opt.p_telemetry);
+            return 1;
+        }
+        serial.open(p_telemetry, opt.baud);
+        profiler.set_stage(PROFILE_TELEMETRY, "telemetry");
+        telemetry.start();
+    }
+
+    bus.frequency(opt.frequency);
+    bus.attach(D6T_ADDR, sim_d6t);
+    acquisition.add(device, SENSOR_ID);
+    acquisition.set_filter(SENSOR_ID, &filter);
+    acquisition.set_percentiles(opt.range_percentile, 100 - opt.range_percentile);
+    acquisition.set_profiler(&profiler, PROFILE_SENSOR);
+    profiler.set_stage(PROFILE_RENDER, "render");
+    profiler.set_stage(PROFILE_SENSOR, "sensor");
+    sensors.add(acquisition);
+    frame_us.reserve(opt.frames);
+    renderer.use_layer_alpha(opt.pixel_alpha == 0);
+    renderer.use_grid_layer((opt.grid_layer != 0) ? &grid_display : NULL);
+    renderer.set_mode(opt.mode);
+    renderer.set_redraw_threshold(opt.redraw_threshold);
+    if (opt.drp != 0) {
+        drp.set_load_ms(opt.drp_load_ms);
+        drp.add_library(sim_drp_lib_isp, 6, opt.isp_ms, sim_drp_isp);
+        drp.add_library(sim_drp_lib_resize, 1, 1, sim_drp_resize);
+        drp_scheduler.set_thermal(drp_resize);
+        renderer.use_drp(&drp_scheduler);
+        camera_thread.start(camera_task);
+    }
+    sensors.start();
+    if (acquisition.period_ms() != opt.period_ms) {
+        printf("period          : %lu ms, stretched to one reading at %d Hz\n",
+               (unsigned long)acquisition.period_ms(), opt.frequency);
+    }
+    if (opt.p_record != NULL) {
+        recorder.start();
+        if (!recorder.record(opt.p_record)) {
+            perror(opt.p_record);
+            return 1;
+        }
+    }
+
+    while (done < opt.frames) {
+        int reso_x = opt.reso_x;
+        int reso_y = opt.reso_y;
+        uint8_t alpha = (opt.fade != 0) ? fade_list[(done / opt.fade) % sizeof(fade_list)] : SIM_ALPHA_MAX;
+
+        // --fps: newest frame on the display deadlines, otherwise every sensor frame
+        if (((opt.fps == 0) && (sensors.read(SENSOR_ID, cursor, frame) == false))
+         || ((opt.fps != 0) && (sensors.latest(SENSOR_ID, frame) == false))) {
+            ThisThread::sleep_for(1);
+            continue;
+        }
+        if ((opt.fps != 0) && (done == 0)) {
+            scheduler.start();
+        }
+        if (done == WARMUP_FRAMES) {
+            warm_count = alloc_count;
+            warm_bytes = alloc_bytes;
+            first_ms = frame.timestamp_ms;
+            profiler.reset();
+            drp_scheduler.reset_stats();
+            renderer.redraw().reset_stats();
+            auto_range.reset_stats();
+        }
+
+        auto t0 = std::chrono::steady_clock::now();
+        {
+            ThermoScopedTimer timer(profiler, PROFILE_RENDER);
+            SimRender::degrade_reso(&reso_x, &reso_y, scheduler.degrade());
+            if (opt.range_auto) {
+                // once per sensor frame, --fps may draw a frame again
+                if (frame.sequence != range_sequence) {
+                    auto_range.update(frame.stats);
+                    range_sequence = frame.sequence;
+                }
+                min = auto_range.min();
+                max = auto_range.max();
+            } else {
+                min = frame.ptat - SIM_TEMP_MARGIN_UNDER;
+                max = frame.ptat + SIM_TEMP_MARGIN_UPPER;
+            }
+            renderer.palette().set_raw_range(max - min);
+            renderer.update(&frame.pixel[0], reso_x, reso_y, alpha, min, max);
+            if (opt.load_ms != 0) {
+                // time of a slower target, in proportion to the output pixels
+                ThisThread::sleep_for((opt.load_ms * reso_x * reso_y) / (opt.reso_x * opt.reso_y));
+            }
+        }
+        auto t1 = std::chrono::steady_clock::now();
+
+        if (p_telemetry != NULL) {
+            // send_telemetry() of main.cpp: every sensor frame, never waits for the UART
+            ThermoScopedTimer timer(profiler, PROFILE_TELEMETRY);
+            ThermoFrame sent;
+
+            while (sensors.read(SENSOR_ID, telemetry_cursor, sent)) {
+                uint32_t size = telemetry_encoder.encode(sent, telemetry_packet);
+                if (!telemetry.write(telemetry_packet, size)) {
+                    telemetry_encoder.resync();
+                }
+            }
+        }
+
+        if ((done > WARMUP_FRAMES) && (frame.sequence == (previous.sequence + 1))) {
+            int i;
+
+            for (i = 0; i < THERMO_FRAME_PIXEL; i++) {
+                flicker += abs(frame.pixel[i] - previous.pixel[i]);
+                saturated += ((frame.pixel[i] <= min) || (frame.pixel[i] >= max)) ? 1 : 0;
+            }
+            flicker_frames++;
+        }
+        previous = frame;
+
+        if (done >= WARMUP_FRAMES) {
+            frame_us.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+            last_ms = frame.timestamp_ms;
+        }
+        done++;
+        if (opt.fps != 0) {
+            scheduler.wait_next();
+        }
+    }
+
+    uint64_t heap_count = alloc_count - warm_count;
+    uint64_t heap_bytes = alloc_bytes - warm_bytes;
+    std::vector<double> sorted(frame_us);
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0;
+    for (double us : sorted) {
+        sum += us;
+    }
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    SimI2cStats bus_stats = bus.stats();
+    int n = (int)sorted.size();
+
+    printf("sensor          : %dx%d, output %dx%d\n", SIM_SENSOR_RESO_HW, SIM_SENSOR_RESO_VW, opt.reso_x, opt.reso_y);
+    printf("frames          : %d measured (%d warm-up), sequence %lu\n", n, WARMUP_FRAMES, (unsigned long)frame.sequence);
+    printf("frame time [us] : mean %.1f  p50 %.1f  p99 %.1f  max %.1f\n",
+           sum / n, sorted[n / 2], sorted[(n * 99) / 100], sorted[n - 1]);
+    printf("frame rate      : %.1f fps (sensor)\n", (last_ms > first_ms) ? ((n - 1) * 1000.0 / (double)(last_ms - first_ms)) : 0.0);
+    printf("cache clean     : %llu bytes in %lu calls\n", (unsigned long long)cache.bytes(), (unsigned long)cache.calls());
+    const SimDisplay& tiles = (opt.grid_layer != 0) ? grid_display : display;
+    uint16_t center = tiles.pixel(SIM_VIDEO_PIXEL_HW / 2, SIM_VIDEO_PIXEL_VW / 2);
+    printf("alpha           : %s, %lu layer alpha writes, center pixel shown at %u/255\n",
+           ((opt.pixel_alpha != 0) || (opt.grid_layer != 0)) ? "pixel" : "layer", (unsigned long)display.alpha_writes(),
+           tiles.blend_alpha(center));
+    printf("tile layer      : %dx%d buffer%s\n", tiles.buffer_width(), tiles.buffer_height(),
+           (opt.grid_layer != 0) ? " scaled to the display" : "");
+    printf("i2c             : %lu transfers, %lu bytes, %lu nacks, %lu read errors\n",
+           (unsigned long)bus_stats.transfers, (unsigned long)bus_stats.bytes, (unsigned long)bus_stats.nacks,
+           (unsigned long)sensors.errors(SENSOR_ID));
+    D6T_Stats d6t_stats = d6t.stats();
+    printf("d6t             : %lu reads, %lu i2c errors, %lu pec errors\n", (unsigned long)d6t_stats.reads,
+           (unsigned long)d6t_stats.i2c_errors, (unsigned long)d6t_stats.pec_errors);
+    printf("heap            : %llu allocations (%llu bytes) while measuring\n",
+           (unsigned long long)heap_count, (unsigned long long)heap_bytes);
+    printf("memory          : %ld KB peak RSS\n", usage.ru_maxrss);
+    if (opt.fps != 0) {
+        ThermoPacingStats pacing = scheduler.stats();
+        printf("pacing          : %lu frames at %d fps, %lu overruns, %lu skipped, jitter max %lu ms, degrade %d\n",
+               (unsigned long)pacing.frames, opt.fps, (unsigned long)pacing.overruns, (unsigned long)pacing.skipped,
+               (unsigned long)pacing.jitter_max_ms, pacing.degrade);
+    }
+    if (opt.drp != 0) {
+        ThermoDrpStats drp_stats = drp_scheduler.stats();
+        printf("drp             : %lu camera frames (isp %lu us), %lu jobs, %lu on the cpu, %lu failed,"
+               " switch %lu us, job %lu us\n",
+               (unsigned long)drp_stats.camera_frames, (unsigned long)drp_stats.isp_us, (unsigned long)drp_stats.jobs,
+               (unsigned long)(drp_stats.rejected + drp_stats.timeouts + drp_stats.slower), (unsigned long)drp_stats.failed,
+               (unsigned long)drp_stats.switch_us, (unsigned long)drp_stats.job_us);
+        printf("drp render time : %lu us per frame on the cpu, %lu us on the drp (%lu us waited), %lu us saved\n",
+               (unsigned long)drp_stats.cpu_us, (unsigned long)drp_stats.drp_cpu_us, (unsigned long)drp_stats.wait_us,
+               (unsigned long)drp_stats.saved_us);
+    }
+    if (opt.p_fused != NULL) {
+        uint32_t inside = 0;
+        int i;
+
+        if (!write_fused(opt, frame, min, max)) {
+            fprintf(stderr, "%s: not written\n", opt.p_fused);
+        }
+        for (i = 0; i < THERMO_REG_MAP_SIZE(SIM_VIDEO_PIXEL_HW, SIM_VIDEO_PIXEL_VW); i++) {
+            inside += (registration_map[i] != THERMO_REG_OUTSIDE) ? 1 : 0;
+        }
+        printf("fused           : %s %dx%d, %lu%% of the camera image in the sensor field of view\n", opt.p_fused,
+               fusion.out_width(opt.fused_step), fusion.out_height(opt.fused_step),
+               (unsigned long)((inside * 100) / THERMO_REG_MAP_SIZE(SIM_VIDEO_PIXEL_HW, SIM_VIDEO_PIXEL_VW)));
+    }
+    if (p_telemetry != NULL) {
+        uint64_t start = Kernel::get_ms_count();
+        ThermoTelemetryStats tm = telemetry.stats();
+
+        while ((telemetry.pending() != 0) && ((Kernel::get_ms_count() - start) < DRAIN_TIMEOUT_MS)) {
+            ThisThread::sleep_for(10);
+        }
+        fflush(p_telemetry);
+        printf("telemetry       : %s, %lu packets, %lu dropped, %.1f bytes per frame (text dump %lu),"
+               " buffer max %lu bytes at %d baud\n", opt.p_telemetry, (unsigned long)tm.packets,
+               (unsigned long)tm.dropped, (tm.packets != 0) ? ((double)tm.bytes / tm.packets) : 0.0,
+               (unsigned long)text_dump_size(frame), (unsigned long)tm.max_used, opt.baud);
+    }
+    ThermoFilterStats filter_stats = filter.stats();
+    static const char* const filter_name[] = { "off", "ema", "median" };
+    printf("filter          : %s, deadband %d, %.1f%% of the pixels changed, flicker %.3f degC per pixel and frame\n",
+           filter_name[opt.filter], opt.deadband,
+           (filter_stats.frames != 0) ? ((filter_stats.changed * 100.0) / ((double)filter_stats.frames * THERMO_FRAME_PIXEL)) : 0.0,
+           (flicker_frames != 0) ? (flicker / (10.0 * flicker_frames * THERMO_FRAME_PIXEL)) : 0.0);
+    const ThermoRedrawStats& region = renderer.redraw().stats();
+    printf("redraw          : threshold %d, %.1f%% of the tiles redrawn, %lu of %lu frames in full\n",
+           opt.redraw_threshold, (region.total != 0) ? ((region.points * 100.0) / (double)region.total) : 0.0,
+           (unsigned long)region.full, (unsigned long)region.frames);
+    printf("range           : %s, %lu changes in %lu frames, %.1f%% of the pixels saturated, last %.1f - %.1f degC\n",
+           opt.range_auto ? "auto" : "fixed", (unsigned long)auto_range.stats().changes,
+           (unsigned long)auto_range.stats().frames,
+           (flicker_frames != 0) ? ((saturated * 100.0) / ((double)flicker_frames * THERMO_FRAME_PIXEL)) : 0.0,
+           min / 10.0, max / 10.0);
+    printf("frame stats     : min %.1f max %.1f mean %.1f degC, %d-%d%% %.1f - %.1f degC, hot spot %u,%u\n",
+           frame.stats.min / 10.0, frame.stats.max / 10.0, frame.stats.mean / 10.0,
+           opt.range_percentile, 100 - opt.range_percentile, frame.stats.low / 10.0, frame.stats.high / 10.0,
+           (unsigned)frame.stats.hot_x, (unsigned)frame.stats.hot_y);
+    if (opt.p_record != NULL) {
+        ThermoRecorderStats rec;
+
+        recorder.stop();
+        rec = recorder.stats();
+        printf("record          : %s, %lu frames, %lu lost, %lu chunks (%lu bytes), %lu write errors\n", opt.p_record,
+               (unsigned long)rec.frames, (unsigned long)rec.lost, (unsigned long)rec.chunks,
+               (unsigned long)rec.chunks * THERMO_LOG_CHUNK_SIZE, (unsigned long)rec.errors);
+    }
+    profiler.print();
+
+    // the acquisition thread never ends, leave without running the destructors
+    fflush(stdout);
+    _exit(0);
+}